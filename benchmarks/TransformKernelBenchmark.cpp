@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "src/Events/EventQueue.hpp"
+#include "src/Objects/Prop.hpp"
+#include "src/Objects/Components/PositionComponent.hpp"
+#include "src/Scene/Scene.hpp"
+#include "src/Scene/SceneManager.hpp"
+#include "src/Scene/SceneNode.hpp"
+#include "src/Scene/TransformKernel.hpp"
+#include "src/Scene/TransformSystem.hpp"
+
+// Compares world transform update of TransformSystem against per-component glm math, and raw batch kernels of every
+// instruction set. Scene is a set of parents with children, so both compose and parent multiply are exercised. Every
+// case is repeated and the fastest run is reported, checksums keep compiler from dropping results.
+
+static constexpr const size_t TRANSFORM_COUNT = 16384;
+static constexpr const size_t PARENT_COUNT = 128;
+static constexpr const int REPETITIONS = 50;
+
+template<typename Fn>
+static double measure(Fn &&fn) {
+    auto best = std::chrono::steady_clock::duration::max();
+
+    for (int repetition = 0; repetition < REPETITIONS; repetition++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::steady_clock::now() - start);
+    }
+
+    return std::chrono::duration<double, std::micro>(best).count();
+}
+
+static float checksum(const std::vector<glm::mat4> &matrices) {
+    float sum = 0;
+
+    for (const auto &matrix: matrices) {
+        sum += matrix[0][0] + matrix[1][1] + matrix[2][2] + matrix[3][0];
+    }
+
+    return sum;
+}
+
+static float checksum(const std::vector<std::shared_ptr<Prop>> &props) {
+    float sum = 0;
+
+    for (const auto &prop: props) {
+        const auto &matrix = prop->position()->model();
+        sum += matrix[0][0] + matrix[1][1] + matrix[2][2] + matrix[3][0];
+    }
+
+    return sum;
+}
+
+static void report(std::string_view name, double time, float sum) {
+    std::cout << fmt::format("{0:<32}{1:>10.1f} us{2:>10.2f} ns/transform  (checksum {3})",
+                             name, time, time * 1000 / TRANSFORM_COUNT, sum) << std::endl;
+}
+
+int main() {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> distribution(-10, 10);
+
+    auto sceneManager = std::make_shared<SceneManager>(std::make_shared<EventQueue>());
+    auto scene = Scene::empty();
+    sceneManager->setScene(scene);
+
+    TransformSystem transformSystem(sceneManager);
+
+    // parents precede their children, so baseline computes world transforms in a single pass
+    std::vector<std::shared_ptr<Prop>> props;
+    std::vector<int64_t> parentIndices;
+    std::shared_ptr<SceneNode> parentNode;
+    int64_t parentIdx = -1;
+
+    props.reserve(TRANSFORM_COUNT);
+    parentIndices.reserve(TRANSFORM_COUNT);
+
+    for (size_t idx = 0; idx < TRANSFORM_COUNT; idx++) {
+        auto prop = std::make_shared<Prop>();
+        auto position = prop->position();
+        position->position() = glm::vec3(distribution(random), distribution(random), distribution(random));
+        position->setEulerAngles(glm::vec3(distribution(random), distribution(random), distribution(random)));
+        position->scale() = glm::vec3(std::abs(distribution(random)) + 0.1f);
+
+        if (idx % (TRANSFORM_COUNT / PARENT_COUNT) == 0) {
+            parentNode = sceneManager->addObject(prop);
+            parentIdx = static_cast<int64_t>(idx);
+            parentIndices.push_back(-1);
+        } else {
+            auto node = SceneNode::empty();
+            node->object() = prop;
+            parentNode->insert(node);
+            parentIndices.push_back(parentIdx);
+        }
+
+        props.push_back(prop);
+    }
+
+    std::vector<glm::mat4> models(TRANSFORM_COUNT);
+
+    std::cout << fmt::format("{0} transforms under {1} parents, detected instruction set: {2}",
+                             TRANSFORM_COUNT, PARENT_COUNT, toString(TransformKernel::detectIsa())) << std::endl;
+
+    // baseline is glm matrix math of every component, as done before transforms were cached
+    auto baselineTime = measure([&]() {
+        for (size_t idx = 0; idx < TRANSFORM_COUNT; idx++) {
+            auto localModel = props[idx]->position()->localModel();
+
+            models[idx] = parentIndices[idx] < 0
+                          ? localModel
+                          : models[parentIndices[idx]] * localModel;
+        }
+    });
+    report("glm per component", baselineTime, checksum(models));
+
+    // hierarchy change flattens scene tree again and recomputes every transform
+    auto rebuildTime = measure([&]() {
+        sceneManager->setScene(scene);
+        transformSystem.update();
+    });
+    report("TransformSystem rebuild", rebuildTime, checksum(props));
+
+    auto allDirtyTime = measure([&]() {
+        for (size_t idx = 0; idx < TRANSFORM_COUNT; idx++) {
+            if (parentIndices[idx] < 0) {
+                props[idx]->position()->markDirty();
+            }
+        }
+
+        transformSystem.update();
+    });
+    report("TransformSystem all dirty", allDirtyTime, checksum(props));
+
+    auto oneDirtyTime = measure([&]() {
+        props[0]->position()->markDirty();
+        transformSystem.update();
+    });
+    report("TransformSystem one subtree dirty", oneDirtyTime, checksum(props));
+
+    auto cleanTime = measure([&]() {
+        transformSystem.update();
+    });
+    report("TransformSystem clean", cleanTime, checksum(props));
+
+    std::cout << fmt::format("TransformSystem: all dirty {0:.2f}x faster than baseline",
+                             baselineTime / allDirtyTime) << std::endl;
+
+    TransformArrays transforms;
+    transforms.resize(TRANSFORM_COUNT);
+
+    for (size_t idx = 0; idx < TRANSFORM_COUNT; idx++) {
+        auto position = props[idx]->position();
+        transforms.set(idx, position->position(), position->rotation(), position->scale());
+    }
+
+    std::vector<glm::mat4> parents(TRANSFORM_COUNT);
+
+    for (size_t idx = 0; idx < TRANSFORM_COUNT; idx++) {
+        parents[idx] = parentIndices[idx] < 0
+                       ? glm::mat4(1)
+                       : props[parentIndices[idx]]->position()->model();
+    }
+
+    for (auto isa: {TransformKernelIsa::Scalar, TransformKernelIsa::Sse, TransformKernelIsa::Avx2}) {
+        TransformKernel kernel(isa);
+
+        if (kernel.isa() != isa) {
+            std::cout << fmt::format("{0}: not supported", toString(isa)) << std::endl;
+            continue;
+        }
+
+        auto composeTime = measure([&]() {
+            kernel.compose(transforms, models.data(), TRANSFORM_COUNT);
+        });
+        report(fmt::format("{0} compose", toString(isa)), composeTime, checksum(models));
+
+        auto worldTime = measure([&]() {
+            kernel.compose(transforms, models.data(), TRANSFORM_COUNT);
+            kernel.multiply(parents.data(), models.data(), models.data(), TRANSFORM_COUNT);
+        });
+        report(fmt::format("{0} compose + multiply", toString(isa)), worldTime, checksum(models));
+
+        std::cout << fmt::format("{0}: {1:.2f}x faster than baseline",
+                                 toString(isa), baselineTime / worldTime) << std::endl;
+    }
+
+    return 0;
+}
@@ -2,10 +2,16 @@
 
 #version 450
 
+// matches SceneRenderStage.cpp
+const uint DIRECTIONAL_LIGHT_COUNT = 4;
+const uint CASCADE_COUNT = 4;
+
 struct ShadowData {
     mat4 matrix;
     vec3 position;
     float range;
+    // offset and size of tile in shadow atlas, zero size if light has no tile
+    vec4 rect;
 };
 
 struct LightData {
@@ -14,15 +20,53 @@ struct LightData {
     float range;
 };
 
+struct DirectionalLightData {
+    vec3 direction;
+    uint cascadeCount;
+    vec3 color;
+    // view depth where every cascade ends
+    vec4 splits;
+    mat4 matrices[CASCADE_COUNT];
+    vec4 rects[CASCADE_COUNT];
+};
+
+struct LightCluster {
+    uint offset;
+    uint count;
+};
+
 layout (constant_id = 0) const uint SHADOW_COUNT = 32;
 layout (constant_id = 1) const uint LIGHT_COUNT = 128;
+layout (constant_id = 2) const uint SAMPLE_COUNT = 1;
 
-layout (binding = 0, input_attachment_index = 0) uniform subpassInputMS albedo;
-layout (binding = 1, input_attachment_index = 1) uniform subpassInputMS position;
-layout (binding = 2, input_attachment_index = 2) uniform subpassInputMS normal;
-layout (binding = 3, input_attachment_index = 3) uniform subpassInputMS specular;
+// matches SceneLightClusters.hpp
+const uint CLUSTER_X = 16;
+const uint CLUSTER_Y = 9;
+const uint CLUSTER_Z = 24;
 
-layout (binding = 4) uniform sampler2DArray shadowMaps;
+// matches LIGHT_ATTENUATION_CUTOFF of SceneRenderStage.cpp, lights are not binned into clusters beyond it
+const float ATTENUATION_CUTOFF = 1.0 / 256.0;
+
+// MULTISAMPLED variant is used when G-buffer targets have more than one sample
+#ifdef MULTISAMPLED
+#define SUBPASS_INPUT subpassInputMS
+#define LOAD(input, sampleIdx) subpassLoad(input, sampleIdx)
+#else
+#define SUBPASS_INPUT subpassInput
+#define LOAD(input, sampleIdx) subpassLoad(input)
+#endif
+
+// COMPACT_GBUFFER variant reconstructs position from depth and reads octahedral encoded normal
+layout (binding = 0, input_attachment_index = 0) uniform SUBPASS_INPUT albedo;
+#ifdef COMPACT_GBUFFER
+layout (binding = 1, input_attachment_index = 1) uniform SUBPASS_INPUT depth;
+#else
+layout (binding = 1, input_attachment_index = 1) uniform SUBPASS_INPUT position;
+#endif
+layout (binding = 2, input_attachment_index = 2) uniform SUBPASS_INPUT normal;
+layout (binding = 3, input_attachment_index = 3) uniform SUBPASS_INPUT specular;
+
+layout (binding = 4) uniform sampler2D shadowAtlas;
 
 layout (binding = 5) uniform ShadowDataArray {
     ShadowData[SHADOW_COUNT] data;
@@ -33,15 +77,36 @@ layout (binding = 6) uniform LightDataArray {
 } lights;
 
 layout (binding = 7) uniform CameraData {
+    mat4 view;
     vec3 position;
+    float near;
+    vec2 tileSize;
+    float sliceScale;
+    float sliceBias;
+    mat4 inverseViewProjection;
+    // scaled extent that scene is rendered at
+    vec2 extent;
 } camera;
 
 layout (binding = 8) uniform SceneData {
     float ambient;
     uint shadowCount;
     uint lightCount;
+    uint directionalCount;
 } scene;
 
+layout (std430, binding = 9) readonly buffer LightClusterArray {
+    LightCluster data[];
+} clusters;
+
+layout (std430, binding = 10) readonly buffer LightIndexArray {
+    uint data[];
+} lightIndices;
+
+layout (binding = 11) uniform DirectionalLightDataArray {
+    DirectionalLightData data[DIRECTIONAL_LIGHT_COUNT];
+} directionalLights;
+
 layout (location = 0) out vec3 outColor;
 
 const mat4 biasMat = mat4(
@@ -51,13 +116,59 @@ const mat4 biasMat = mat4(
 0.5, 0.5, 0.0, 1.0
 );
 
-float projectShadowMap(int shadowIdx, vec4 shadowCoord)
+// Samples share position of pixel center, depth is the only per sample value. Exact sample position would need
+// gl_SamplePosition, which forces shading of every sample, so position is off by less than half a pixel.
+vec3 reconstructPosition(float depth)
+{
+    vec2 ndc = gl_FragCoord.xy / camera.extent * 2.0 - 1.0;
+    vec4 position = camera.inverseViewProjection * vec4(ndc, depth, 1.0);
+
+    return position.xyz / position.w;
+}
+
+// matches encodeNormal of scene-model.frag
+vec3 decodeNormal(vec2 encoded)
+{
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-n.z, 0.0);
+
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+
+    return normalize(n);
+}
+
+vec3 loadPosition(int sampleIdx)
+{
+#ifdef COMPACT_GBUFFER
+    return reconstructPosition(LOAD(depth, sampleIdx).r);
+#else
+    return LOAD(position, sampleIdx).rgb;
+#endif
+}
+
+vec3 loadNormal(int sampleIdx)
+{
+#ifdef COMPACT_GBUFFER
+    return decodeNormal(LOAD(normal, sampleIdx).rg);
+#else
+    return LOAD(normal, sampleIdx).rgb;
+#endif
+}
+
+float projectShadowMap(vec4 rect, vec4 shadowCoord)
 {
     vec4 normalized = shadowCoord / shadowCoord.w;
 
+    // neighbouring tiles belong to other lights, so area outside of tile is lit
+    if (rect.z == 0.0 || any(lessThan(normalized.st, vec2(0.0))) || any(greaterThan(normalized.st, vec2(1.0))))
+    {
+        return 1.0f;
+    }
+
     if (normalized.z > -1.0 && normalized.z < 1.0)
     {
-        float dist = texture(shadowMaps, vec3(normalized.st, shadowIdx)).r;
+        float dist = texture(shadowAtlas, rect.xy + normalized.st * rect.zw).r;
         if (normalized.w > 0.0 && dist < normalized.z)
         {
             return scene.ambient;
@@ -67,50 +178,150 @@ float projectShadowMap(int shadowIdx, vec4 shadowCoord)
     return 1.0f;
 }
 
-void main() {
-    vec4 albedo = subpassLoad(albedo, 0);
-    vec3 position = subpassLoad(position, 0).rgb;
-    vec3 normal = subpassLoad(normal, 0).rgb;
-    float specular = subpassLoad(specular, 0).r;
+float attenuate(float range, float dist)
+{
+    return max(range / (pow(dist, 2.0) + 1.0) - ATTENUATION_CUTOFF, 0.0);
+}
+
+uint getClusterIdx(vec3 position)
+{
+    float depth = max(-(camera.view * vec4(position, 1)).z, camera.near);
+
+    uint slice = uint(clamp(log(depth) * camera.sliceScale - camera.sliceBias, 0.0, float(CLUSTER_Z - 1)));
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / camera.tileSize), uvec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+
+    return (slice * CLUSTER_Y + tile.y) * CLUSTER_X + tile.x;
+}
 
+vec3 shade(vec4 albedo, vec3 position, vec3 normal, float specular)
+{
     vec3 fragColor = albedo.rgb;
 
-    for (int lightIdx = 0; lightIdx < scene.lightCount; lightIdx++) {
-        float dist = length(lights.data[lightIdx].position - position);
+    vec3 N = normalize(normal);
+    vec3 V = normalize(camera.position - position);
 
-        vec3 L = normalize(lights.data[lightIdx].position - position);
-        vec3 V = normalize(camera.position - position);
+    float shadow = scene.ambient;
 
-        float atten = lights.data[lightIdx].range / (pow(dist, 2.0) + 1.0);
+    // light and shadow of same index belong to same light source
+    LightCluster cluster = clusters.data[getClusterIdx(position)];
 
-        vec3 N = normalize(normal);
-        float NdotL = max(0.0, dot(N, L));
-        vec3 diff = lights.data[lightIdx].color * albedo.rgb * NdotL * atten;
+    for (uint clusterLightIdx = 0; clusterLightIdx < cluster.count; clusterLightIdx++) {
+        uint lightIdx = lightIndices.data[cluster.offset + clusterLightIdx];
 
-        vec3 R = reflect(-L, N);
-        float NdotR = max(0.0, dot(R, V));
-        vec3 spec = lights.data[lightIdx].color * specular * pow(NdotR, 32.0) * atten;
+        if (lightIdx < scene.lightCount) {
+            float dist = length(lights.data[lightIdx].position - position);
+            float atten = attenuate(lights.data[lightIdx].range, dist);
+
+            vec3 L = normalize(lights.data[lightIdx].position - position);
+
+            float NdotL = max(0.0, dot(N, L));
+            vec3 diff = lights.data[lightIdx].color * albedo.rgb * NdotL * atten;
+
+            vec3 R = reflect(-L, N);
+            float NdotR = max(0.0, dot(R, V));
+            vec3 spec = lights.data[lightIdx].color * specular * pow(NdotR, 32.0) * atten;
+
+            fragColor += diff + spec;
+        }
 
-        fragColor += diff + spec;
+        if (lightIdx < scene.shadowCount) {
+            float dist = length(shadows.data[lightIdx].position - position);
+            float atten = attenuate(shadows.data[lightIdx].range, dist);
+
+            vec4 inShadowCoord = (biasMat * shadows.data[lightIdx].matrix) * vec4(position, 1);
+            shadow += atten * projectShadowMap(shadows.data[lightIdx].rect, inShadowCoord);
+        }
     }
 
     if (scene.lightCount > 0) {
         fragColor /= scene.lightCount;
     }
 
-    float shadow = scene.ambient;
+    if (scene.shadowCount > 0) {
+        shadow /= scene.shadowCount;
+    }
+
+    // directional lights are not attenuated, their shadows come from cascade covering depth of pixel
+    vec3 directionalColor = vec3(0.0);
+    float depth = -(camera.view * vec4(position, 1)).z;
+
+    for (uint directionalIdx = 0; directionalIdx < scene.directionalCount; directionalIdx++) {
+        DirectionalLightData light = directionalLights.data[directionalIdx];
+
+        vec3 L = -normalize(light.direction);
+
+        float NdotL = max(0.0, dot(N, L));
+        vec3 diff = light.color * albedo.rgb * NdotL;
+
+        vec3 R = reflect(-L, N);
+        float NdotR = max(0.0, dot(R, V));
+        vec3 spec = light.color * specular * pow(NdotR, 32.0);
+
+        uint cascadeIdx = 0;
 
-    for (int shadowIdx = 0; shadowIdx < scene.shadowCount; shadowIdx++) {
-        float dist = length(shadows.data[shadowIdx].position - position);
-        float atten = shadows.data[shadowIdx].range / (pow(dist, 2.0) + 1.0);
+        while (cascadeIdx + 1 < light.cascadeCount && depth > light.splits[cascadeIdx]) {
+            cascadeIdx++;
+        }
 
-        vec4 inShadowCoord = (biasMat * shadows.data[shadowIdx].matrix) * vec4(position, 1);
-        shadow += atten * projectShadowMap(shadowIdx, inShadowCoord);
+        vec4 inShadowCoord = (biasMat * light.matrices[cascadeIdx]) * vec4(position, 1);
+        directionalColor += (diff + spec) * projectShadowMap(light.rects[cascadeIdx], inShadowCoord);
     }
 
-    if (scene.shadowCount > 0) {
-        shadow /= scene.shadowCount;
+    return shadow * fragColor + directionalColor;
+}
+
+#ifdef MULTISAMPLED
+#ifdef COMPACT_GBUFFER
+// Depth is stored per sample and changes across pixel on any surface that is not parallel to screen, so it differs
+// between samples of single triangle. Edges are found by normal and albedo, written once per pixel, and by depth only
+// when it changes more than its slope between neighbouring pixels allows.
+bool differsFromFirstSample(int sampleIdx, float depthSlope)
+{
+    return LOAD(normal, sampleIdx).rg != LOAD(normal, 0).rg ||
+           LOAD(albedo, sampleIdx) != LOAD(albedo, 0) ||
+           abs(LOAD(depth, sampleIdx).r - LOAD(depth, 0).r) > depthSlope;
+}
+#else
+bool differsFromFirstSample(int sampleIdx, float depthSlope)
+{
+    return LOAD(position, sampleIdx).rgb != LOAD(position, 0).rgb ||
+           LOAD(normal, sampleIdx).rgb != LOAD(normal, 0).rgb;
+}
+#endif
+
+void main() {
+    vec3 position0 = loadPosition(0);
+    vec3 normal0 = loadNormal(0);
+
+#ifdef COMPACT_GBUFFER
+    // derivatives are taken in uniform control flow, before per sample branches
+    float depthSlope = fwidth(LOAD(depth, 0).r) + 1e-6;
+#else
+    float depthSlope = 0.0;
+#endif
+
+    // samples covered by single triangle hold same values, so only pixels on edges are shaded per sample
+    bool edge = false;
+
+    for (int sampleIdx = 1; sampleIdx < int(SAMPLE_COUNT) && !edge; sampleIdx++) {
+        edge = differsFromFirstSample(sampleIdx, depthSlope);
+    }
+
+    vec3 color = shade(LOAD(albedo, 0), position0, normal0, LOAD(specular, 0).r);
+
+    if (edge) {
+        for (int sampleIdx = 1; sampleIdx < int(SAMPLE_COUNT); sampleIdx++) {
+            color += shade(LOAD(albedo, sampleIdx), loadPosition(sampleIdx), loadNormal(sampleIdx),
+                           LOAD(specular, sampleIdx).r);
+        }
+
+        color /= float(SAMPLE_COUNT);
     }
 
-    outColor = shadow * fragColor;
+    outColor = color;
+}
+#else
+void main() {
+    outColor = shade(LOAD(albedo, 0), loadPosition(0), loadNormal(0), LOAD(specular, 0).r);
 }
+#endif
@@ -0,0 +1,34 @@
+#version 450
+
+struct InstanceData {
+    mat4 model;
+    mat4 modelRotation;
+    uint albedoTextureIdx;
+    uint specularTextureIdx;
+    uint batchIdx;
+};
+
+layout (push_constant) uniform SceneConstants {
+    mat4 viewProjection;
+} sceneConstants;
+
+layout (set = 1, binding = 0) readonly buffer InstanceDataArray {
+    InstanceData data[];
+} instances;
+
+layout (set = 1, binding = 1) readonly buffer VisibleInstanceArray {
+    uint data[];
+} visibleInstances;
+
+layout (location = 0) in vec3 inPosition;
+
+// depth must match the one of scene-model.vert exactly, G-buffer is drawn with equal depth test
+invariant gl_Position;
+
+void main() {
+    uint instanceIdx = visibleInstances.data[gl_InstanceIndex];
+
+    vec4 position = instances.data[instanceIdx].model * vec4(inPosition, 1.0);
+
+    gl_Position = sceneConstants.viewProjection * position;
+}
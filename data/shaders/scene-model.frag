@@ -1,21 +1,45 @@
 #version 450
 
-layout (set = 0, binding = 0) uniform sampler2D albedoTexture;
-layout (set = 0, binding = 1) uniform sampler2D specTexture;
+#extension GL_EXT_nonuniform_qualifier : require
+
+// bindless texture table, indexed by per-instance texture indices
+layout (set = 0, binding = 0) uniform sampler2D textures[];
 
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) in vec3 inNormal;
 layout (location = 2) in vec3 inColor;
 layout (location = 3) in vec2 inUV;
+layout (location = 4) flat in uint inAlbedoTextureIdx;
+layout (location = 5) flat in uint inSpecularTextureIdx;
+
+// COMPACT_GBUFFER variant drops position, which composition reconstructs from depth, and packs normal into two channels
+#ifdef COMPACT_GBUFFER
+layout (location = 0) out vec4 outAlbedo;
+layout (location = 1) out vec2 outNormal;
+layout (location = 2) out vec4 outSpecular;
 
+// octahedral encoding, matches decodeNormal of scene-composition.frag
+vec2 encodeNormal(vec3 normal)
+{
+    vec3 n = normal / (abs(normal.x) + abs(normal.y) + abs(normal.z));
+    vec2 signs = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+
+    return n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * signs;
+}
+#else
 layout (location = 0) out vec4 outAlbedo;
 layout (location = 1) out vec4 outPosition;
 layout (location = 2) out vec4 outNormal;
 layout (location = 3) out vec4 outSpecular;
+#endif
 
 void main() {
-    outAlbedo = texture(albedoTexture, inUV);
+    outAlbedo = texture(textures[nonuniformEXT(inAlbedoTextureIdx)], inUV);
+#ifdef COMPACT_GBUFFER
+    outNormal = encodeNormal(normalize(inNormal));
+#else
     outPosition = vec4(inPosition, 1);
     outNormal = vec4(inNormal, 1);
-    outSpecular = texture(specTexture, inUV);
+#endif
+    outSpecular = texture(textures[nonuniformEXT(inSpecularTextureIdx)], inUV);
 }
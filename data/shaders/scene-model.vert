@@ -1,10 +1,25 @@
 #version 450
 
-layout (push_constant) uniform MeshConstants {
-    mat4 matrix;
+struct InstanceData {
     mat4 model;
     mat4 modelRotation;
-} meshConstants;
+    uint albedoTextureIdx;
+    uint specularTextureIdx;
+    uint batchIdx;
+};
+
+layout (push_constant) uniform SceneConstants {
+    mat4 viewProjection;
+} sceneConstants;
+
+layout (set = 1, binding = 0) readonly buffer InstanceDataArray {
+    InstanceData data[];
+} instances;
+
+// slots of instances grouped by batch, either visible ones produced by scene-cull.comp or all of them
+layout (set = 1, binding = 1) readonly buffer VisibleInstanceArray {
+    uint data[];
+} visibleInstances;
 
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) in vec3 inNormal;
@@ -15,12 +30,25 @@ layout (location = 0) out vec3 outPosition;
 layout (location = 1) out vec3 outNormal;
 layout (location = 2) out vec3 outColor;
 layout (location = 3) out vec2 outUV;
+layout (location = 4) flat out uint outAlbedoTextureIdx;
+layout (location = 5) flat out uint outSpecularTextureIdx;
+
+// depth must match the one of scene-depth.vert exactly, G-buffer is drawn with equal depth test after prepass
+invariant gl_Position;
 
 void main() {
-    outPosition = (meshConstants.model * vec4(inPosition, 1)).xyz;
-    outNormal = (meshConstants.modelRotation * vec4(inNormal, 1)).xyz;
+    uint instanceIdx = visibleInstances.data[gl_InstanceIndex];
+
+    InstanceData instance = instances.data[instanceIdx];
+
+    vec4 position = instance.model * vec4(inPosition, 1.0);
+
+    outPosition = position.xyz;
+    outNormal = (instance.modelRotation * vec4(inNormal, 1)).xyz;
     outColor = inColor;
     outUV = inUV;
+    outAlbedoTextureIdx = instance.albedoTextureIdx;
+    outSpecularTextureIdx = instance.specularTextureIdx;
 
-    gl_Position = meshConstants.matrix * vec4(inPosition, 1.0);
+    gl_Position = sceneConstants.viewProjection * position;
 }
@@ -1,11 +1,30 @@
 #version 450
 
-layout (push_constant) uniform MeshConstants {
+struct InstanceData {
+    mat4 model;
+    mat4 modelRotation;
+    uint albedoTextureIdx;
+    uint specularTextureIdx;
+    uint batchIdx;
+};
+
+layout (push_constant) uniform ShadowConstants {
     mat4 matrix;
-} meshConstants;
+} shadowConstants;
+
+layout (set = 0, binding = 0) readonly buffer InstanceDataArray {
+    InstanceData data[];
+} instances;
+
+// instances inside of light volume, listed for every shadow map
+layout (set = 0, binding = 2) readonly buffer ShadowInstanceArray {
+    uint data[];
+} shadowInstances;
 
 layout (location = 0) in vec3 inPosition;
 
 void main() {
-    gl_Position = meshConstants.matrix * vec4(inPosition, 1.0);
-}
\ No newline at end of file
+    uint instanceIdx = shadowInstances.data[gl_InstanceIndex];
+
+    gl_Position = shadowConstants.matrix * instances.data[instanceIdx].model * vec4(inPosition, 1.0);
+}
@@ -0,0 +1,18 @@
+#version 450
+
+// matches UpscaleConstants of UpscaleRenderStage.cpp
+layout (push_constant) uniform UpscaleConstants {
+    vec2 scale;
+    vec2 limit;
+} constants;
+
+layout (binding = 0) uniform sampler2D sceneColor;
+
+layout (location = 0) in vec2 inUV;
+
+layout (location = 0) out vec4 outColor;
+
+void main() {
+    // scene is rendered into top left corner of its image, texels outside of it are left from larger extents
+    outColor = vec4(texture(sceneColor, min(inUV * constants.scale, constants.limit)).rgb, 1.0);
+}
@@ -0,0 +1,29 @@
+#include "DebugUIDrawData.hpp"
+
+DebugUIDrawData::DebugUIDrawData(const ImDrawData *source)
+        : _drawData(*source) {
+    this->_drawLists.reserve(source->CmdListsCount);
+
+    for (int idx = 0; idx < source->CmdListsCount; idx++) {
+        this->_drawLists.push_back(source->CmdLists[idx]->CloneOutput());
+    }
+
+    this->_drawData.CmdLists = this->_drawLists.data();
+    this->_drawData.OwnerViewport = nullptr;
+}
+
+DebugUIDrawData::~DebugUIDrawData() {
+    for (const auto &drawList: this->_drawLists) {
+        IM_DELETE(drawList);
+    }
+}
+
+void DebugUIDrawData::setFontTextureId(ImTextureID textureId) {
+    for (const auto &drawList: this->_drawLists) {
+        for (auto &command: drawList->CmdBuffer) {
+            if (command.TextureId == nullptr) {
+                command.TextureId = textureId;
+            }
+        }
+    }
+}
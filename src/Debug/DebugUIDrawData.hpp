@@ -0,0 +1,28 @@
+#ifndef DEBUG_DEBUGUIDRAWDATA_HPP
+#define DEBUG_DEBUGUIDRAWDATA_HPP
+
+#include <vector>
+
+#include <imgui.h>
+
+// owning copy of Dear ImGui draw data, allows to render UI frame on another thread
+class DebugUIDrawData {
+private:
+    std::vector<ImDrawList *> _drawLists;
+    ImDrawData _drawData;
+
+public:
+    explicit DebugUIDrawData(const ImDrawData *source);
+    ~DebugUIDrawData();
+
+    DebugUIDrawData(const DebugUIDrawData &) = delete;
+    DebugUIDrawData &operator=(const DebugUIDrawData &) = delete;
+
+    // font atlas is captured with null texture id, its texture is owned by render thread and could be recreated after
+    // draw data was captured, textures of other commands are kept as is
+    void setFontTextureId(ImTextureID textureId);
+
+    [[nodiscard]] ImDrawData *getDrawData() { return &this->_drawData; }
+};
+
+#endif // DEBUG_DEBUGUIDRAWDATA_HPP
@@ -2,74 +2,73 @@
 
 #include <fmt/core.h>
 #include <imgui.h>
-#include <imgui_impl_glfw.h>
 #include <imgui_impl_vulkan.h>
 
-#include "src/Debug/DebugUIRoot.hpp"
+#include "src/Debug/DebugUIDrawData.hpp"
 #include "src/Engine/EngineError.hpp"
 #include "src/Rendering/CommandManager.hpp"
+#include "src/Rendering/DescriptorAllocator.hpp"
 #include "src/Rendering/GpuManager.hpp"
+#include "src/Rendering/GpuTimeline.hpp"
+#include "src/Rendering/PipelineCache.hpp"
 #include "src/Rendering/Swapchain.hpp"
-#include "src/Rendering/Proxies/CommandBufferProxy.hpp"
 #include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
 #include "src/Rendering/Proxies/PhysicalDeviceProxy.hpp"
+#include "src/Rendering/Types/FramePacket.hpp"
+#include "src/Rendering/Types/RenderFrame.hpp"
 
-DebugUIRenderStage::DebugUIRenderStage(const std::shared_ptr<GpuManager> &gpuManager,
-                                       const std::shared_ptr<DebugUIRoot> &debugUIRoot)
+// font atlas and textures shown in debug windows
+static constexpr const uint32_t DEBUG_UI_DESCRIPTOR_SET_COUNT = 64;
+
+DebugUIRenderStage::DebugUIRenderStage(const std::shared_ptr<GpuManager> &gpuManager)
         : _gpuManager(gpuManager),
-          _debugUIRoot(debugUIRoot) {
+          _fontTextureId(nullptr) {
     //
 }
 
 void DebugUIRenderStage::init() {
     if (this->_gpuManager->getPhysicalDeviceProxy().expired() ||
         this->_gpuManager->getLogicalDeviceProxy().expired() ||
-        this->_gpuManager->getCommandManager().expired()) {
+        this->_gpuManager->getCommandManager().expired() ||
+        this->_gpuManager->getDescriptorAllocator().expired() ||
+        this->_gpuManager->getTimeline().expired() ||
+        this->_gpuManager->getPipelineCache().expired()) {
         throw EngineError("GPU manager is not initialized");
     }
 
     this->_physicalDevice = this->_gpuManager->getPhysicalDeviceProxy().lock();
     this->_logicalDevice = this->_gpuManager->getLogicalDeviceProxy().lock();
     this->_commandManager = this->_gpuManager->getCommandManager().lock();
+    this->_descriptorAllocator = this->_gpuManager->getDescriptorAllocator().lock();
+    this->_timeline = this->_gpuManager->getTimeline().lock();
+    this->_pipelineCache = this->_gpuManager->getPipelineCache().lock();
 
-    auto poolSizes = {
-            vk::DescriptorPoolSize(vk::DescriptorType::eSampler, 1024),
-            vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, 1024),
-            vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, 1024),
-            vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, 1024),
-            vk::DescriptorPoolSize(vk::DescriptorType::eUniformTexelBuffer, 1024),
-            vk::DescriptorPoolSize(vk::DescriptorType::eStorageTexelBuffer, 1024),
-            vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, 1024),
-            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 1024),
-            vk::DescriptorPoolSize(vk::DescriptorType::eUniformBufferDynamic, 1024),
-            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBufferDynamic, 1024),
-            vk::DescriptorPoolSize(vk::DescriptorType::eInputAttachment, 1024),
-    };
-
-    auto descriptorPoolCreateInfo = vk::DescriptorPoolCreateInfo()
-            .setMaxSets(1024) // TODO: vars
-            .setPoolSizes(poolSizes);
-
-    this->_descriptorPool = this->_logicalDevice->getHandle().createDescriptorPool(descriptorPoolCreateInfo);
+    // ImGui frees sets of textures it displays by itself
+    this->_descriptorPool = this->_descriptorAllocator->createStandalonePool(
+            DEBUG_UI_DESCRIPTOR_SET_COUNT, vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
 }
 
 void DebugUIRenderStage::destroy() {
-    this->_logicalDevice->getHandle().destroy(this->_descriptorPool);
+    this->_descriptorAllocator->destroyStandalonePool(this->_descriptorPool);
 
     this->_commandManager = nullptr;
+    this->_descriptorAllocator = nullptr;
+    this->_timeline = nullptr;
+    this->_pipelineCache = nullptr;
     this->_logicalDevice = nullptr;
     this->_physicalDevice = nullptr;
 }
 
 void DebugUIRenderStage::onGraphCreate(const std::shared_ptr<Swapchain> swapchain,
-                                       const vk::RenderPass &renderPass) {
+                                       const vk::RenderPass &renderPass,
+                                       vk::SampleCountFlagBits sampleCount) {
     ImGui_ImplVulkan_InitInfo initInfo = {
             .Instance = this->_gpuManager->getInstance(),
             .PhysicalDevice = this->_physicalDevice->getHandle(),
             .Device = this->_logicalDevice->getHandle(),
             .QueueFamily = this->_physicalDevice->getGraphicsQueueFamilyIdx(),
             .Queue = this->_logicalDevice->getGraphicsQueue(),
-            .PipelineCache = nullptr,
+            .PipelineCache = this->_pipelineCache->getHandle(),
             .DescriptorPool = this->_descriptorPool,
             .Subpass = 0,
             .MinImageCount = swapchain->getMinImageCount(),
@@ -85,41 +84,52 @@ void DebugUIRenderStage::onGraphCreate(const std::shared_ptr<Swapchain> swapchai
 
     ImGui_ImplVulkan_Init(&initInfo, renderPass);
 
-    auto commandBuffer = this->_commandManager->createPrimaryBuffer();
+    auto oneShotBuffer = this->_commandManager->acquireOneShotBuffer();
+    auto commandBuffer = oneShotBuffer.commandBuffer;
     auto commandBufferBeginInfo = vk::CommandBufferBeginInfo();
 
-    commandBuffer->getHandle().begin(commandBufferBeginInfo);
-    ImGui_ImplVulkan_CreateFontsTexture(commandBuffer->getHandle());
-    commandBuffer->getHandle().end();
+    commandBuffer.begin(commandBufferBeginInfo);
+    ImGui_ImplVulkan_CreateFontsTexture(commandBuffer);
+    commandBuffer.end();
 
-    auto submitInfo = vk::SubmitInfo()
-            .setCommandBuffers(commandBuffer->getHandle());
-    this->_logicalDevice->getGraphicsQueue().submit(submitInfo);
-    this->_logicalDevice->getGraphicsQueue().waitIdle();
+    auto value = this->_timeline->submit(GpuSubmission{
+            .commandBuffers = {commandBuffer}
+    });
+    this->_timeline->wait(value);
 
-    commandBuffer->destroy();
+    this->_commandManager->releaseOneShotBuffer(oneShotBuffer);
 
     ImGui_ImplVulkan_DestroyFontUploadObjects();
+
+    // backend publishes font texture through ImGuiIO, which is owned by main thread, so it is kept here and atlas id is
+    // reset for main thread to capture font commands with null texture id
+    this->_fontTextureId = ImGui::GetIO().Fonts->TexID;
+    ImGui::GetIO().Fonts->SetTexID(nullptr);
 }
 
 void DebugUIRenderStage::onGraphDestroy() {
+    this->_drawData = nullptr;
+    this->_fontTextureId = nullptr;
+
     ImGui_ImplVulkan_Shutdown();
 }
 
+void DebugUIRenderStage::onFrameBegin(const RenderFrame &frame) {
+    this->_drawData = frame.packet->debugUIDrawData;
+}
+
 void DebugUIRenderStage::onPassExecute(const RenderPassRef &passRef, const vk::CommandBuffer &commandBuffer) {
     if (passRef != "DebugUI") {
         throw EngineError(fmt::format("Unknown pass {0}", passRef));
     }
 
-    ImGui_ImplVulkan_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
+    if (this->_drawData == nullptr) {
+        return;
+    }
 
-    this->_debugUIRoot->render();
+    this->_drawData->setFontTextureId(this->_fontTextureId);
 
-    ImGui::Render();
-    ImDrawData *drawData = ImGui::GetDrawData();
-    ImGui_ImplVulkan_RenderDrawData(drawData, commandBuffer);
+    ImGui_ImplVulkan_RenderDrawData(this->_drawData->getDrawData(), commandBuffer);
 }
 
 RenderSubgraph DebugUIRenderStage::asSubgraph() {
@@ -130,9 +140,9 @@ RenderSubgraph DebugUIRenderStage::asSubgraph() {
                             RenderAttachment{
                                     .idx = 0,
                                     .targetRef = "Swapchain",
-                                    .loadOp = vk::AttachmentLoadOp::eClear,
+                                    .loadOp = vk::AttachmentLoadOp::eLoad,
                                     .storeOp = vk::AttachmentStoreOp::eStore,
-                                    .initialLayout = vk::ImageLayout::eUndefined,
+                                    .initialLayout = vk::ImageLayout::eColorAttachmentOptimal,
                                     .finalLayout = vk::ImageLayout::ePresentSrcKHR
                             }
                     }
@@ -147,6 +157,7 @@ RenderSubgraph DebugUIRenderStage::asSubgraph() {
                                             "Swapchain"
                                     },
                                     .depthRef = std::nullopt,
+                                    .resolveRefs = {},
                                     .dependencies = {}
                             }
                     }
@@ -4,37 +4,49 @@
 #include <memory>
 #include <vector>
 
+#include <imgui.h>
+
 #include "src/Rendering/Graph/RenderStage.hpp"
 
 class CommandManager;
+class DescriptorAllocator;
 class GpuManager;
+class GpuTimeline;
+class PipelineCache;
 class LogicalDeviceProxy;
 class PhysicalDeviceProxy;
-class DebugUIRoot;
+class DebugUIDrawData;
 
 class DebugUIRenderStage : public RenderStage, public std::enable_shared_from_this<DebugUIRenderStage> {
 private:
     std::shared_ptr<GpuManager> _gpuManager;
-    std::shared_ptr<DebugUIRoot> _debugUIRoot;
 
     std::shared_ptr<CommandManager> _commandManager;
+    std::shared_ptr<DescriptorAllocator> _descriptorAllocator;
+    std::shared_ptr<GpuTimeline> _timeline;
+    std::shared_ptr<PipelineCache> _pipelineCache;
     std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
     std::shared_ptr<PhysicalDeviceProxy> _physicalDevice;
 
     vk::DescriptorPool _descriptorPool;
+    ImTextureID _fontTextureId;
+
+    std::shared_ptr<DebugUIDrawData> _drawData;
 
 public:
-    DebugUIRenderStage(const std::shared_ptr<GpuManager> &gpuManager,
-                       const std::shared_ptr<DebugUIRoot> &debugUIRoot);
+    explicit DebugUIRenderStage(const std::shared_ptr<GpuManager> &gpuManager);
     ~DebugUIRenderStage() override = default;
 
     void init() override;
     void destroy() override;
 
     void onGraphCreate(const std::shared_ptr<Swapchain> swapchain,
-                       const vk::RenderPass &renderPass) override;
+                       const vk::RenderPass &renderPass,
+                       vk::SampleCountFlagBits sampleCount) override;
     void onGraphDestroy() override;
 
+    void onFrameBegin(const RenderFrame &frame) override;
+
     void onPassExecute(const RenderPassRef &passRef, const vk::CommandBuffer &commandBuffer) override;
 
     RenderSubgraph asSubgraph() override;
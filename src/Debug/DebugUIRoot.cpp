@@ -1,5 +1,10 @@
 #include "DebugUIRoot.hpp"
 
+#include <imgui.h>
+#include <imgui_impl_glfw.h>
+
+#include "src/Debug/DebugUIDrawData.hpp"
+
 #include "src/Debug/DebugUIState.hpp"
 #include "src/Debug/UI/LogWindow.hpp"
 #include "src/Debug/UI/MainMenuBar.hpp"
@@ -53,3 +58,14 @@ void DebugUIRoot::render() {
         this->_variablesWindow->draw(&this->_state->variablesWindowVisible);
     }
 }
+
+std::shared_ptr<DebugUIDrawData> DebugUIRoot::buildFrame() {
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+
+    this->render();
+
+    ImGui::Render();
+
+    return std::make_shared<DebugUIDrawData>(ImGui::GetDrawData());
+}
@@ -13,6 +13,7 @@ class ResourceDatabase;
 class ResourceLoader;
 class SceneManager;
 
+class DebugUIDrawData;
 struct DebugUIState;
 class LogWindow;
 class MainMenuBar;
@@ -43,6 +44,9 @@ public:
                 const std::shared_ptr<SceneManager> &sceneManager);
 
     void render();
+
+    // builds UI frame on main thread, result is rendered by DebugUIRenderStage
+    [[nodiscard]] std::shared_ptr<DebugUIDrawData> buildFrame();
 };
 
 #endif // DEBUG_DEBUGUIROOT_HPP
@@ -16,9 +16,10 @@
 #include "src/Resources/ResourceDatabase.hpp"
 
 static std::map<LightSourceType, std::string> LIGHT_SOURCE_TYPES = {
-        {POINT_LIGHT_SOURCE,     toString(POINT_LIGHT_SOURCE)},
-        {CONE_LIGHT_SOURCE,      toString(CONE_LIGHT_SOURCE)},
-        {RECTANGLE_LIGHT_SOURCE, toString(RECTANGLE_LIGHT_SOURCE)}
+        {POINT_LIGHT_SOURCE,       toString(POINT_LIGHT_SOURCE)},
+        {CONE_LIGHT_SOURCE,        toString(CONE_LIGHT_SOURCE)},
+        {RECTANGLE_LIGHT_SOURCE,   toString(RECTANGLE_LIGHT_SOURCE)},
+        {DIRECTIONAL_LIGHT_SOURCE, toString(DIRECTIONAL_LIGHT_SOURCE)}
 };
 
 // TODO
@@ -101,6 +102,7 @@ void ObjectEditVisitor::drawLightSourceObject(LightSource *lightSource) {
             break;
 
         case RECTANGLE_LIGHT_SOURCE:
+        case DIRECTIONAL_LIGHT_SOURCE:
             ImGui::InputScalarN("Rectangle", ImGuiDataType_Float, &lightSource->rect(), 2);
             break;
     }
@@ -133,9 +135,25 @@ void ObjectEditVisitor::drawModelComponent(ModelComponent *component) {
 void ObjectEditVisitor::drawPositionComponent(PositionComponent *component) {
     ImGui::Text("Position Component");
 
-    ImGui::InputScalarN("Position", ImGuiDataType_Float, &component->position(), 3);
-    ImGui::SliderFloat3("Rotation", reinterpret_cast<float *>(&component->rotation()), 0, glm::radians(360.0f));
-    ImGui::InputScalarN("Scale", ImGuiDataType_Float, &component->scale(), 3);
+    bool changed = false;
+
+    changed |= ImGui::InputScalarN("Position", ImGuiDataType_Float, &component->position(), 3);
+
+    // rotation is stored as quaternion and edited as euler angles
+    auto angles = component->eulerAngles();
+
+    if (ImGui::SliderFloat3("Rotation", reinterpret_cast<float *>(&angles), -glm::radians(180.0f),
+                            glm::radians(180.0f))) {
+        component->setEulerAngles(angles);
+        changed = true;
+    }
+
+    changed |= ImGui::InputScalarN("Scale", ImGuiDataType_Float, &component->scale(), 3);
+
+    // renderer reuses shadows of objects that are not dirty
+    if (changed) {
+        component->markDirty();
+    }
 }
 
 void ObjectEditVisitor::drawSkyboxComponent(SkyboxComponent *component) {
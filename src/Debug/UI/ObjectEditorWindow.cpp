@@ -40,7 +40,7 @@ void ObjectEditorWindow::draw(bool *visible) {
 
     ImGui::Separator();
 
-    for (std::shared_ptr<Component> component: object->components()) {
+    for (auto component: object->components()) {
         component->acceptEdit(this->_objectEditVisitor);
 
         ImGui::Separator();
@@ -3,6 +3,7 @@
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 
+#include "src/Debug/DebugUIDrawData.hpp"
 #include "src/Debug/DebugUIRoot.hpp"
 #include "src/Debug/DebugUIRenderStage.hpp"
 #include "src/Engine/EngineError.hpp"
@@ -15,11 +16,16 @@
 #include "src/Rendering/GpuManager.hpp"
 #include "src/Rendering/Renderer.hpp"
 #include "src/Rendering/Graph/RenderGraph.hpp"
+#include "src/Rendering/Stages/SceneRenderStage.hpp"
+#include "src/Rendering/Stages/UpscaleRenderStage.hpp"
+#include "src/Rendering/Types/FramePacket.hpp"
 #include "src/Resources/ResourceDatabase.hpp"
 #include "src/Resources/ResourceLoader.hpp"
 #include "src/Resources/Readers/SceneReader.hpp"
 #include "src/Objects/Camera.hpp"
 #include "src/Objects/Components/PositionComponent.hpp"
+#include "src/Scene/FramePacketBuilder.hpp"
+#include "src/Scene/TransformSystem.hpp"
 #include "src/Scene/Scene.hpp"
 #include "src/Scene/SceneNode.hpp"
 #include "src/Scene/SceneManager.hpp"
@@ -51,7 +57,12 @@ Engine::Engine()
                                                      this->_vars,
                                                      this->_resourceDatabase,
                                                      this->_resourceLoader,
-                                                     this->_sceneManager)) {
+                                                     this->_sceneManager)),
+          _transformSystem(std::make_shared<TransformSystem>(this->_sceneManager)),
+          _framePacketBuilder(std::make_shared<FramePacketBuilder>(this->_vars,
+                                                                   this->_gpuManager,
+                                                                   this->_sceneManager,
+                                                                   this->_transformSystem)) {
     //
 }
 
@@ -59,9 +70,31 @@ void Engine::init() {
     this->_vars->set(WINDOW_TITLE_VAR, "TheVulkanProject");
     this->_vars->set(WINDOW_WIDTH_VAR, 1280);
     this->_vars->set(WINDOW_HEIGHT_VAR, 720);
+    this->_vars->set(std::string(RENDERING_PRESENT_MODE), "fifo");
+    this->_vars->set(std::string(RENDERING_FRAME_LIMIT), 0);
+    this->_vars->set(std::string(RENDERING_LOW_LATENCY), false);
+    this->_vars->set(std::string(RENDERING_INFLIGHT_FRAME_COUNT), 2);
+    this->_vars->set(std::string(RENDERING_FRAME_PIPELINE_DEPTH), 2);
+    this->_vars->set(std::string(RENDERING_PARALLEL_RECORDING), false);
+    this->_vars->set(std::string(RENDERING_RECORDING_THREAD_COUNT), 0);
+    this->_vars->set(std::string(RENDERING_PIPELINE_CACHE_PATH), "pipeline.cache");
+    this->_vars->set(std::string(RENDERING_PIPELINE_COMPILER_THREAD_COUNT), 0);
+    this->_vars->set(std::string(RENDERING_GPU_CULLING), true);
+    this->_vars->set(std::string(RENDERING_GEOMETRY_POOL_VERTEX_CAPACITY), 262144);
+    this->_vars->set(std::string(RENDERING_GEOMETRY_POOL_INDEX_CAPACITY), 1048576);
+    this->_vars->set(std::string(RENDERING_TEXTURE_TABLE_SIZE), 4096);
+    this->_vars->set(std::string(RENDERING_DESCRIPTOR_POOL_SIZE), 256);
+    this->_vars->set(std::string(RENDERING_SAMPLE_COUNT), 4);
+    this->_vars->set(std::string(RENDERING_DYNAMIC_RESOLUTION), true);
+    this->_vars->set(std::string(RENDERING_DYNAMIC_RESOLUTION_FRAME_TIME), 16000);
+    this->_vars->set(std::string(RENDERING_DYNAMIC_RESOLUTION_MIN_SCALE), 50);
     this->_vars->set(RENDERING_SCENE_STAGE_LIGHT_COUNT, 128);
     this->_vars->set(RENDERING_SCENE_STAGE_SHADOW_MAP_COUNT, 32);
     this->_vars->set(RENDERING_SCENE_STAGE_SHADOW_MAP_SIZE, 1024);
+    this->_vars->set(RENDERING_SCENE_STAGE_SHADOW_ATLAS_SIZE, 4096);
+    this->_vars->set(RENDERING_SCENE_STAGE_SHADOW_CASCADE_COUNT, 4);
+    this->_vars->set(RENDERING_SCENE_STAGE_DEPTH_PREPASS, false);
+    this->_vars->set(RENDERING_SCENE_STAGE_COMPACT_GBUFFER, false);
     this->_vars->set(RESOURCES_DEFAULT_TEXTURE, "textures/default");
 
     this->_resourceDatabase->tryAddDirectory("data");
@@ -74,6 +107,9 @@ void Engine::init() {
     ImGui::CreateContext();
     ImGui::StyleColorsDark();
 
+    // UI frames are built on main thread, font atlas must be ready before render thread uploads it
+    ImGui::GetIO().Fonts->Build();
+
     this->_window->create();
 
     this->_eventQueue->addHandler([this](const Event &event) {
@@ -85,10 +121,26 @@ void Engine::init() {
     });
 
     this->_gpuManager->init();
+    this->_framePacketBuilder->init();
 
     // TODO: this should be configured externally
-    auto debugUIRenderStage = std::make_shared<DebugUIRenderStage>(this->_gpuManager,
-                                                                   this->_debugUIRoot);
+    auto sceneRenderStage = std::make_shared<SceneRenderStage>(this->_log, this->_vars, this->_resourceDatabase,
+                                                               this->_resourceLoader, this->_gpuManager);
+    this->_renderer->addRenderStage("Scene", sceneRenderStage);
+
+    auto sceneSubgraph = sceneRenderStage->asSubgraph();
+    sceneSubgraph.stageRef = "Scene";
+    sceneSubgraph.next = {"Upscale"};
+
+    auto upscaleRenderStage = std::make_shared<UpscaleRenderStage>(this->_resourceDatabase, this->_resourceLoader,
+                                                                   this->_gpuManager);
+    this->_renderer->addRenderStage("Upscale", upscaleRenderStage);
+
+    auto upscaleSubgraph = upscaleRenderStage->asSubgraph();
+    upscaleSubgraph.stageRef = "Upscale";
+    upscaleSubgraph.next = {"DebugUI"};
+
+    auto debugUIRenderStage = std::make_shared<DebugUIRenderStage>(this->_gpuManager);
     this->_renderer->addRenderStage("DebugUI", debugUIRenderStage);
 
     auto debugUISubgraph = debugUIRenderStage->asSubgraph();
@@ -102,17 +154,96 @@ void Engine::init() {
                                     .type = RenderTargetType::Color,
                                     .source = RenderTargetSource::Swapchain,
                                     .format = RenderTargetFormat::SwapchainColor,
+                                    .samples = RenderTargetSamples::Single,
+                                    .clearValue = {.rgba = {0, 0, 0, 1}}
+                            }
+                    },
+                    {
+                            "SceneColor",
+                            RenderTarget{
+                                    .type = RenderTargetType::Color | RenderTargetType::Sampled,
+                                    .source = RenderTargetSource::Image,
+                                    .format = RenderTargetFormat::DefaultColor,
+                                    .samples = RenderTargetSamples::Single,
                                     .clearValue = {.rgba = {0, 0, 0, 1}}
                             }
+                    },
+                    {
+                            "SceneAlbedo",
+                            RenderTarget{
+                                    .type = RenderTargetType::Color | RenderTargetType::Input,
+                                    .source = RenderTargetSource::Image,
+                                    .format = RenderTargetFormat::DefaultColor,
+                                    .samples = RenderTargetSamples::Multiple,
+                                    .clearValue = {.rgba = {0, 0, 0, 0}}
+                            }
+                    },
+                    {
+                            "ScenePosition",
+                            RenderTarget{
+                                    .type = RenderTargetType::Color | RenderTargetType::Input,
+                                    .source = RenderTargetSource::Image,
+                                    .format = RenderTargetFormat::HighPrecisionColor,
+                                    .samples = RenderTargetSamples::Multiple,
+                                    .clearValue = {.rgba = {0, 0, 0, 0}}
+                            }
+                    },
+                    {
+                            "SceneNormal",
+                            RenderTarget{
+                                    .type = RenderTargetType::Color | RenderTargetType::Input,
+                                    .source = RenderTargetSource::Image,
+                                    .format = RenderTargetFormat::HighPrecisionColor,
+                                    .samples = RenderTargetSamples::Multiple,
+                                    .clearValue = {.rgba = {0, 0, 0, 0}}
+                            }
+                    },
+                    {
+                            "ScenePackedNormal",
+                            RenderTarget{
+                                    .type = RenderTargetType::Color | RenderTargetType::Input,
+                                    .source = RenderTargetSource::Image,
+                                    .format = RenderTargetFormat::PackedNormal,
+                                    .samples = RenderTargetSamples::Multiple,
+                                    .clearValue = {.rgba = {0, 0, 0, 0}}
+                            }
+                    },
+                    {
+                            "SceneSpecular",
+                            RenderTarget{
+                                    .type = RenderTargetType::Color | RenderTargetType::Input,
+                                    .source = RenderTargetSource::Image,
+                                    .format = RenderTargetFormat::DefaultColor,
+                                    .samples = RenderTargetSamples::Multiple,
+                                    .clearValue = {.rgba = {0, 0, 0, 0}}
+                            }
+                    },
+                    {
+                            "SceneDepth",
+                            RenderTarget{
+                                    .type = RenderTargetType::DepthStencil | RenderTargetType::Input,
+                                    .source = RenderTargetSource::Image,
+                                    .format = RenderTargetFormat::DefaultDepth,
+                                    .samples = RenderTargetSamples::Multiple,
+                                    .clearValue = {.depth = 1, .stencil = 0}
+                            }
                     }
             },
             .subgraphs = {
+                    {
+                            "Scene",
+                            sceneSubgraph
+                    },
+                    {
+                            "Upscale",
+                            upscaleSubgraph
+                    },
                     {
                             "DebugUI",
                             debugUISubgraph
                     }
             },
-            .firstSubgraph = "DebugUI"
+            .firstSubgraph = "Scene"
     };
     this->_renderer->setRenderGraph(renderGraph);
 
@@ -141,6 +272,7 @@ void Engine::cleanup() {
     this->_sceneManager->setScene(nullptr);
 
     this->_renderer->destroy();
+    this->_framePacketBuilder->destroy();
     this->_gpuManager->destroy();
 
     ImGui::DestroyContext();
@@ -157,8 +289,21 @@ void Engine::run() {
     this->_work = true;
 
     while (this->_work) {
+        // input is sampled only after renderer is ready to accept next frame
+        this->_renderer->waitForNextFrame();
+
         glfwPollEvents();
 
         this->_eventQueue->process();
+
+        // world transforms follow edits made since previous packet
+        this->_transformSystem->update();
+
+        auto packet = this->_framePacketBuilder->build();
+        packet->debugUIDrawData = this->_debugUIRoot->buildFrame();
+
+        if (!this->_renderer->submitFrame(packet)) {
+            break;
+        }
     }
 }
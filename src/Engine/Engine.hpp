@@ -15,6 +15,8 @@ class Renderer;
 class Window;
 class SceneManager;
 class DebugUIRoot;
+class FramePacketBuilder;
+class TransformSystem;
 
 class Engine {
 private:
@@ -29,6 +31,8 @@ private:
     std::shared_ptr<Renderer> _renderer;
     std::shared_ptr<SceneManager> _sceneManager;
     std::shared_ptr<DebugUIRoot> _debugUIRoot;
+    std::shared_ptr<TransformSystem> _transformSystem;
+    std::shared_ptr<FramePacketBuilder> _framePacketBuilder;
 
     volatile bool _work = false;
 
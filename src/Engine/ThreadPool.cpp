@@ -0,0 +1,75 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+void ThreadPool::threadFunc(const std::stop_token &stopToken, uint32_t threadIdx) {
+    while (!stopToken.stop_requested()) {
+        PendingJob pendingJob;
+
+        {
+            std::unique_lock lock(this->_mutex);
+
+            if (!this->_condition.wait(lock, stopToken, [this]() { return !this->_jobs.empty(); })) {
+                return;
+            }
+
+            pendingJob = std::move(this->_jobs.front());
+            this->_jobs.pop();
+        }
+
+        try {
+            pendingJob.job(threadIdx);
+            pendingJob.promise.set_value();
+        } catch (...) {
+            pendingJob.promise.set_exception(std::current_exception());
+        }
+    }
+}
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+        : _threadCount(std::max<uint32_t>(threadCount, 1)) {
+    //
+}
+
+void ThreadPool::init() {
+    this->_threads.reserve(this->_threadCount);
+
+    for (uint32_t threadIdx = 0; threadIdx < this->_threadCount; threadIdx++) {
+        this->_threads.emplace_back([this, threadIdx](std::stop_token stopToken) {
+            this->threadFunc(stopToken, threadIdx);
+        });
+    }
+}
+
+void ThreadPool::destroy() {
+    for (auto &thread: this->_threads) {
+        thread.request_stop();
+    }
+
+    this->_threads.clear();
+
+    std::lock_guard lock(this->_mutex);
+
+    while (!this->_jobs.empty()) {
+        this->_jobs.front().promise.set_exception(
+                std::make_exception_ptr(std::runtime_error("Thread pool is destroyed")));
+        this->_jobs.pop();
+    }
+}
+
+std::future<void> ThreadPool::submit(const ThreadPoolJob &job) {
+    PendingJob pendingJob;
+    pendingJob.job = job;
+
+    auto future = pendingJob.promise.get_future();
+
+    {
+        std::lock_guard lock(this->_mutex);
+        this->_jobs.push(std::move(pendingJob));
+    }
+
+    this->_condition.notify_one();
+
+    return future;
+}
@@ -0,0 +1,41 @@
+#ifndef ENGINE_THREADPOOL_HPP
+#define ENGINE_THREADPOOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using ThreadPoolJob = std::function<void(uint32_t threadIdx)>;
+
+class ThreadPool {
+private:
+    struct PendingJob {
+        ThreadPoolJob job;
+        std::promise<void> promise;
+    };
+
+    uint32_t _threadCount;
+
+    std::mutex _mutex;
+    std::condition_variable_any _condition;
+    std::queue<PendingJob> _jobs;
+    std::vector<std::jthread> _threads;
+
+    void threadFunc(const std::stop_token &stopToken, uint32_t threadIdx);
+
+public:
+    explicit ThreadPool(uint32_t threadCount);
+
+    void init();
+    void destroy();
+
+    [[nodiscard]] std::future<void> submit(const ThreadPoolJob &job);
+
+    [[nodiscard]] const uint32_t &getThreadCount() const { return this->_threadCount; }
+};
+
+#endif // ENGINE_THREADPOOL_HPP
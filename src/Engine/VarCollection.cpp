@@ -40,6 +40,14 @@ std::string VarCollection::getOrDefault(const std::string &key, const std::strin
     return this->get<std::string>(key).value_or(defaultValue);
 }
 
+bool VarCollection::getBoolOrDefault(const std::string_view &key, const bool &defaultValue) {
+    return this->get<bool>(std::string(key)).value_or(defaultValue);
+}
+
 int32_t VarCollection::getIntOrDefault(const std::string_view &key, const int32_t &defaultValue) {
     return this->get<int32_t>(std::string(key)).value_or(defaultValue);
 }
+
+std::string VarCollection::getStringOrDefault(const std::string_view &key, const std::string &defaultValue) {
+    return this->get<std::string>(std::string(key)).value_or(defaultValue);
+}
@@ -41,7 +41,9 @@ public:
     [[deprecated]] std::string getOrDefault(const std::string &key, const char *defaultValue);
     [[deprecated]] std::string getOrDefault(const std::string &key, const std::string &defaultValue);
 
+    [[nodiscard]] bool getBoolOrDefault(const std::string_view &key, const bool &defaultValue);
     [[nodiscard]] int32_t getIntOrDefault(const std::string_view &key, const int32_t &defaultValue);
+    [[nodiscard]] std::string getStringOrDefault(const std::string_view &key, const std::string &defaultValue);
 
     [[nodiscard]] VarMap &vars() { return this->_vars; }
 };
@@ -7,12 +7,32 @@ static constexpr const char *WINDOW_TITLE_VAR = "Window.Title";
 static constexpr const char *WINDOW_WIDTH_VAR = "Window.Width";
 static constexpr const char *WINDOW_HEIGHT_VAR = "Window.Height";
 
-static constexpr const std::string_view RENDERING_VSYNC = "Rendering.VSync";
+static constexpr const std::string_view RENDERING_PRESENT_MODE = "Rendering.PresentMode";
+static constexpr const std::string_view RENDERING_FRAME_LIMIT = "Rendering.FrameLimit";
+static constexpr const std::string_view RENDERING_LOW_LATENCY = "Rendering.LowLatency";
 static constexpr const std::string_view RENDERING_INFLIGHT_FRAME_COUNT = "Rendering.InflightFrameCount";
+static constexpr const std::string_view RENDERING_FRAME_PIPELINE_DEPTH = "Rendering.FramePipelineDepth";
+static constexpr const std::string_view RENDERING_PARALLEL_RECORDING = "Rendering.ParallelRecording";
+static constexpr const std::string_view RENDERING_RECORDING_THREAD_COUNT = "Rendering.RecordingThreadCount";
+static constexpr const std::string_view RENDERING_PIPELINE_CACHE_PATH = "Rendering.PipelineCachePath";
+static constexpr const std::string_view RENDERING_PIPELINE_COMPILER_THREAD_COUNT = "Rendering.PipelineCompilerThreadCount";
+static constexpr const std::string_view RENDERING_GPU_CULLING = "Rendering.GpuCulling";
+static constexpr const std::string_view RENDERING_GEOMETRY_POOL_VERTEX_CAPACITY = "Rendering.GeometryPool.VertexCapacity";
+static constexpr const std::string_view RENDERING_GEOMETRY_POOL_INDEX_CAPACITY = "Rendering.GeometryPool.IndexCapacity";
+static constexpr const std::string_view RENDERING_TEXTURE_TABLE_SIZE = "Rendering.TextureTableSize";
+static constexpr const std::string_view RENDERING_DESCRIPTOR_POOL_SIZE = "Rendering.DescriptorPoolSize";
+static constexpr const std::string_view RENDERING_SAMPLE_COUNT = "Rendering.SampleCount";
+static constexpr const std::string_view RENDERING_DYNAMIC_RESOLUTION = "Rendering.DynamicResolution";
+static constexpr const std::string_view RENDERING_DYNAMIC_RESOLUTION_FRAME_TIME = "Rendering.DynamicResolution.FrameTime";
+static constexpr const std::string_view RENDERING_DYNAMIC_RESOLUTION_MIN_SCALE = "Rendering.DynamicResolution.MinScale";
 
 static constexpr const char *RENDERING_SCENE_STAGE_SHADOW_MAP_SIZE = "Rendering.SceneStage.ShadowMapSize";
 static constexpr const char *RENDERING_SCENE_STAGE_SHADOW_MAP_COUNT = "Rendering.SceneStage.ShadowMapCount";
+static constexpr const char *RENDERING_SCENE_STAGE_SHADOW_ATLAS_SIZE = "Rendering.SceneStage.ShadowAtlasSize";
+static constexpr const char *RENDERING_SCENE_STAGE_SHADOW_CASCADE_COUNT = "Rendering.SceneStage.ShadowCascadeCount";
 static constexpr const char *RENDERING_SCENE_STAGE_LIGHT_COUNT = "Rendering.SceneStage.LightCount";
+static constexpr const char *RENDERING_SCENE_STAGE_DEPTH_PREPASS = "Rendering.SceneStage.DepthPrepass";
+static constexpr const char *RENDERING_SCENE_STAGE_COMPACT_GBUFFER = "Rendering.SceneStage.CompactGBuffer";
 
 static constexpr const char *RESOURCES_DEFAULT_TEXTURE = "Resources.DefaultTexture";
 
@@ -7,35 +7,24 @@
 #include "src/Debug/UI/ObjectEditVisitor.hpp"
 #include "src/Objects/Components/PositionComponent.hpp"
 
-static glm::vec3 radius(float phi, float theta) {
-    return glm::vec3(
-            sin(phi) * cos(theta),
-            cos(phi),
-            sin(phi) * sin(theta)
-    );
-}
-
-Camera::Camera() : Camera(std::make_shared<PositionComponent>()) {
+Camera::Camera() : Camera(PositionComponent()) {
     //
 }
 
-Camera::Camera(const std::shared_ptr<PositionComponent> &position)
-        : _position(position),
-          _near(0.01f),
+Camera::Camera(const PositionComponent &position)
+        : _near(0.01f),
           _far(100.0f),
           _fov(glm::radians(90.0f)) {
-    this->_components.push_back(this->_position);
+    this->addComponent<PositionComponent>(position);
 }
 
 std::string Camera::displayName() {
     return fmt::format("({0}) camera", this->id());
 }
 
+// unrotated camera looks along Y axis with its top towards negative X axis
 glm::vec3 Camera::forward() const {
-    float phi = -this->_position->rotation().y;
-    float theta = this->_position->rotation().x;
-
-    return radius(phi, theta);
+    return this->position()->worldRotation() * glm::vec3(0, 1, 0);
 }
 
 glm::vec3 Camera::side() const {
@@ -43,10 +32,7 @@ glm::vec3 Camera::side() const {
 }
 
 glm::vec3 Camera::up() const {
-    float phi = -this->_position->rotation().y - glm::radians(90.0f);
-    float theta = this->_position->rotation().x;
-
-    return radius(phi, theta);
+    return this->position()->worldRotation() * glm::vec3(-1, 0, 0);
 }
 
 glm::mat4 Camera::projection(float aspect) const {
@@ -57,9 +43,15 @@ glm::mat4 Camera::view(bool ignorePosition) const {
     glm::vec3 forward = this->forward();
     glm::vec3 up = this->up();
 
+    glm::vec3 position = this->position()->worldPosition();
+
     return ignorePosition
            ? glm::lookAt(glm::vec3(0), forward, up)
-           : glm::lookAt(this->_position->position(), this->_position->position() + forward, up);
+           : glm::lookAt(position, position + forward, up);
+}
+
+PositionComponent *Camera::position() const {
+    return this->getComponent<PositionComponent>();
 }
 
 void Camera::acceptEdit(const std::shared_ptr<ObjectEditVisitor> &visitor) {
@@ -10,15 +10,13 @@ class PositionComponent;
 
 class Camera : public Object {
 private:
-    std::shared_ptr<PositionComponent> _position;
-
     float _near;
     float _far;
     float _fov;
 
 public:
     explicit Camera();
-    explicit Camera(const std::shared_ptr<PositionComponent> &position);
+    explicit Camera(const PositionComponent &position);
 
     ~Camera() override = default;
 
@@ -37,7 +35,7 @@ public:
     [[nodiscard]] glm::mat4 projection(float aspect) const;
     [[nodiscard]] glm::mat4 view(bool ignorePosition) const;
 
-    [[nodiscard]] const std::shared_ptr<PositionComponent> position() const { return this->_position; }
+    [[nodiscard]] PositionComponent *position() const;
 
     void acceptEdit(const std::shared_ptr<ObjectEditVisitor> &visitor) override;
 };
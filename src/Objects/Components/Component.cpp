@@ -1,5 +1,9 @@
 #include "Component.hpp"
 
+void Component::markDirty() {
+    this->_dirty = true;
+}
+
 void Component::resetDirty() {
     this->_dirty = false;
 }
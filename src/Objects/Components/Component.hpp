@@ -14,6 +14,7 @@ public:
 
     [[nodiscard]] bool isDirty() { return this->_dirty; }
 
+    void markDirty();
     void resetDirty();
 
     virtual void acceptEdit(const std::shared_ptr<ObjectEditVisitor> &visitor);
@@ -0,0 +1,7 @@
+#include "ComponentStorage.hpp"
+
+std::vector<ComponentStorageBase *> &ComponentStorageBase::storages() {
+    static std::vector<ComponentStorageBase *> storages;
+
+    return storages;
+}
@@ -0,0 +1,124 @@
+#ifndef OBJECTS_COMPONENTS_COMPONENTSTORAGE_HPP
+#define OBJECTS_COMPONENTS_COMPONENTSTORAGE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class Component;
+
+// type erased access to storage, used when every component of object is visited
+class ComponentStorageBase {
+public:
+    virtual ~ComponentStorageBase() = default;
+
+    [[nodiscard]] virtual Component *tryGetComponent(uint64_t objectId) = 0;
+
+    virtual void remove(uint64_t objectId) = 0;
+
+    // storages of every component type in order of their first use
+    [[nodiscard]] static std::vector<ComponentStorageBase *> &storages();
+};
+
+// Sparse set of components of single type. Components are packed into contiguous array, so systems iterate them
+// linearly, and are found by object id through sparse array of their indices in constant time. Object ids are
+// sequential, so sparse array stays small. Removal moves the last component in place of removed one, pointers to
+// components are valid only until storage is modified.
+template<typename T>
+class ComponentStorage : public ComponentStorageBase {
+private:
+    static constexpr const uint32_t NO_INDEX = std::numeric_limits<uint32_t>::max();
+
+    std::vector<uint32_t> _indices;
+    std::vector<uint64_t> _objectIds;
+    std::vector<T> _components;
+
+    ComponentStorage();
+
+public:
+    ~ComponentStorage() override = default;
+
+    template<typename ...Args>
+    T &emplace(uint64_t objectId, Args &&...args);
+
+    void remove(uint64_t objectId) override;
+
+    [[nodiscard]] T *tryGet(uint64_t objectId);
+
+    [[nodiscard]] Component *tryGetComponent(uint64_t objectId) override { return this->tryGet(objectId); }
+
+    // id of object that owns component of the same index
+    [[nodiscard]] const std::vector<uint64_t> &objectIds() const { return this->_objectIds; }
+
+    [[nodiscard]] std::vector<T> &components() { return this->_components; }
+
+    [[nodiscard]] static ComponentStorage<T> &instance();
+};
+
+template<typename T>
+ComponentStorage<T>::ComponentStorage() {
+    static_assert(std::is_base_of<Component, T>::value);
+
+    storages().push_back(this);
+}
+
+template<typename T>
+template<typename ...Args>
+T &ComponentStorage<T>::emplace(uint64_t objectId, Args &&...args) {
+    if (objectId >= this->_indices.size()) {
+        this->_indices.resize(objectId + 1, NO_INDEX);
+    }
+
+    auto idx = this->_indices[objectId];
+
+    if (idx != NO_INDEX) {
+        this->_components[idx] = T(std::forward<Args>(args)...);
+
+        return this->_components[idx];
+    }
+
+    this->_indices[objectId] = static_cast<uint32_t>(this->_components.size());
+    this->_objectIds.push_back(objectId);
+
+    return this->_components.emplace_back(std::forward<Args>(args)...);
+}
+
+template<typename T>
+void ComponentStorage<T>::remove(uint64_t objectId) {
+    if (objectId >= this->_indices.size() || this->_indices[objectId] == NO_INDEX) {
+        return;
+    }
+
+    auto idx = this->_indices[objectId];
+    auto lastIdx = static_cast<uint32_t>(this->_components.size() - 1);
+
+    if (idx != lastIdx) {
+        this->_components[idx] = std::move(this->_components[lastIdx]);
+        this->_objectIds[idx] = this->_objectIds[lastIdx];
+        this->_indices[this->_objectIds[idx]] = idx;
+    }
+
+    this->_components.pop_back();
+    this->_objectIds.pop_back();
+    this->_indices[objectId] = NO_INDEX;
+}
+
+template<typename T>
+T *ComponentStorage<T>::tryGet(uint64_t objectId) {
+    if (objectId >= this->_indices.size() || this->_indices[objectId] == NO_INDEX) {
+        return nullptr;
+    }
+
+    return &this->_components[this->_indices[objectId]];
+}
+
+template<typename T>
+ComponentStorage<T> &ComponentStorage<T>::instance() {
+    static ComponentStorage<T> storage;
+
+    return storage;
+}
+
+#endif // OBJECTS_COMPONENTS_COMPONENTSTORAGE_HPP
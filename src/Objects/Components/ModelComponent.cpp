@@ -8,6 +8,7 @@ ModelComponent::~ModelComponent() {
 
 void ModelComponent::setMeshId(const std::optional<ResourceId> &meshId) {
     this->_meshId = meshId;
+    this->_dirty = true;
 }
 
 void ModelComponent::setAlbedoTextureId(const std::optional<ResourceId> &textureId) {
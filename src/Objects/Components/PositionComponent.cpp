@@ -2,20 +2,34 @@
 
 #include "src/Debug/UI/ObjectEditVisitor.hpp"
 
-glm::mat3 PositionComponent::rotationMat3() const {
-    return mat3_cast(glm::quat(this->_rotation));
+glm::vec3 PositionComponent::eulerAngles() const {
+    return glm::eulerAngles(this->_rotation);
 }
 
-glm::mat4 PositionComponent::rotationMat4() const {
-    return mat4_cast(glm::quat(this->_rotation));
+void PositionComponent::setEulerAngles(const glm::vec3 &angles) {
+    this->_rotation = glm::quat(angles);
 }
 
-glm::mat4 PositionComponent::model() const {
+glm::mat4 PositionComponent::localModel() const {
     return glm::translate(glm::mat4(1), this->_position) *
-           mat4_cast(glm::quat(this->_rotation)) *
+           mat4_cast(this->_rotation) *
            glm::scale(glm::mat4(1), this->_scale);
 }
 
+void PositionComponent::setWorld(const glm::mat4 &model, const glm::quat &rotation) {
+    this->_model = model;
+    this->_worldRotation = rotation;
+    this->_moved = true;
+}
+
+glm::mat3 PositionComponent::rotationMat3() const {
+    return mat3_cast(this->_worldRotation);
+}
+
+glm::mat4 PositionComponent::rotationMat4() const {
+    return mat4_cast(this->_worldRotation);
+}
+
 void PositionComponent::acceptEdit(const std::shared_ptr<ObjectEditVisitor> &visitor) {
     visitor->drawPositionComponent(this);
 }
@@ -2,27 +2,52 @@
 #define OBJECTS_COMPONENTS_POSITIONCOMPONENT_HPP
 
 #include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
 #include <glm/gtc/quaternion.hpp>
 
 #include "src/Objects/Components/Component.hpp"
 
+// Local transform relative to the nearest ancestor in scene tree that has position. World transform is cached and
+// updated by TransformSystem when component or one of its ancestors is marked dirty, dirty flag is reset by the
+// update and component is flagged as moved instead.
 class PositionComponent : public Component {
 private:
     glm::vec3 _position = glm::vec3(0);
-    glm::vec3 _rotation = glm::vec3(0);
+    glm::quat _rotation = glm::quat(1, 0, 0, 0);
     glm::vec3 _scale = glm::vec3(1);
 
+    glm::mat4 _model = glm::mat4(1);
+    glm::quat _worldRotation = glm::quat(1, 0, 0, 0);
+    bool _moved = false;
+
 public:
     ~PositionComponent() override = default;
 
     [[nodiscard]] glm::vec3 &position() { return this->_position; }
-    [[nodiscard]] glm::vec3 &rotation() { return this->_rotation; }
+    [[nodiscard]] glm::quat &rotation() { return this->_rotation; }
     [[nodiscard]] glm::vec3 &scale() { return this->_scale; }
 
-    glm::mat3 rotationMat3() const;
-    glm::mat4 rotationMat4() const;
+    // pitch, yaw and roll in radians
+    [[nodiscard]] glm::vec3 eulerAngles() const;
+    void setEulerAngles(const glm::vec3 &angles);
+
+    [[nodiscard]] glm::mat4 localModel() const;
+
+    // world transform is computed in batch by TransformSystem
+    void setWorld(const glm::mat4 &model, const glm::quat &rotation);
+
+    // world transform changed in the last update of TransformSystem
+    [[nodiscard]] bool moved() const { return this->_moved; }
+    void resetMoved() { this->_moved = false; }
+
+    // world transform as of last update of TransformSystem
+    [[nodiscard]] const glm::mat4 &model() const { return this->_model; }
+    [[nodiscard]] glm::vec3 worldPosition() const { return glm::vec3(this->_model[3]); }
+    [[nodiscard]] const glm::quat &worldRotation() const { return this->_worldRotation; }
 
-    [[nodiscard]] glm::mat4 model() const;
+    // world rotation, also transforms normals
+    [[nodiscard]] glm::mat3 rotationMat3() const;
+    [[nodiscard]] glm::mat4 rotationMat4() const;
 
     void acceptEdit(const std::shared_ptr<ObjectEditVisitor> &visitor) override;
 };
@@ -9,18 +9,17 @@
 
 static constexpr const float NEAR = 0.01;
 
-LightSource::LightSource() : LightSource(std::make_shared<PositionComponent>()) {
+LightSource::LightSource() : LightSource(PositionComponent()) {
     //
 }
 
-LightSource::LightSource(const std::shared_ptr<PositionComponent> &position)
-        : _position(position),
-          _type(POINT_LIGHT_SOURCE),
+LightSource::LightSource(const PositionComponent &position)
+        : _type(POINT_LIGHT_SOURCE),
           _color(glm::vec3(1)),
           _range(10),
           _angle(glm::radians(90.0f)),
           _rect(glm::vec2(5)) {
-    this->_components.push_back(this->_position);
+    this->addComponent<PositionComponent>(position);
 }
 
 std::string LightSource::displayName() {
@@ -28,7 +27,7 @@ std::string LightSource::displayName() {
 }
 
 glm::vec3 LightSource::forward() const {
-    return this->_position->rotationMat3() * glm::vec3(1, 0, 0);
+    return this->position()->rotationMat3() * glm::vec3(1, 0, 0);
 }
 
 glm::mat4 LightSource::projection() const {
@@ -40,7 +39,9 @@ glm::mat4 LightSource::projection() const {
             projection = glm::perspective(this->_angle, 1.0f, NEAR, this->_range);
             break;
 
+        // directional light sources are shadowed by cascades fitted to camera, rectangle covers area around position
         case RECTANGLE_LIGHT_SOURCE:
+        case DIRECTIONAL_LIGHT_SOURCE:
             projection = glm::ortho(-this->_rect.x, this->_rect.x, -this->_rect.y, this->_rect.y,
                                     NEAR, this->_range);
             break;
@@ -50,15 +51,23 @@ glm::mat4 LightSource::projection() const {
 }
 
 glm::mat4 LightSource::view() const {
-    glm::mat3 rotation = this->_position->rotationMat3();
+    glm::mat3 rotation = this->position()->rotationMat3();
     glm::vec3 forward = rotation * glm::vec3(1, 0, 0);
     glm::vec3 up = rotation * glm::vec3(0, 1, 0);
 
-    return glm::lookAt(this->_position->position(), this->_position->position() + forward, up);
+    glm::vec3 position = this->position()->worldPosition();
+
+    return glm::lookAt(position, position + forward, up);
 }
 
 glm::mat4 LightSource::view(const glm::vec3 &forward) const {
-    return glm::lookAt(this->_position->position(), this->_position->position() + forward, glm::vec3(0, 1, 0));
+    glm::vec3 position = this->position()->worldPosition();
+
+    return glm::lookAt(position, position + forward, glm::vec3(0, 1, 0));
+}
+
+PositionComponent *LightSource::position() const {
+    return this->getComponent<PositionComponent>();
 }
 
 void LightSource::acceptEdit(const std::shared_ptr<ObjectEditVisitor> &visitor) {
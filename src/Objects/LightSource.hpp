@@ -11,8 +11,6 @@ class PositionComponent;
 
 class LightSource : public Object {
 private:
-    std::shared_ptr<PositionComponent> _position;
-
     LightSourceType _type;
     bool _enabled;
     glm::vec3 _color;
@@ -22,7 +20,7 @@ private:
 
 public:
     explicit LightSource();
-    explicit LightSource(const std::shared_ptr<PositionComponent> &position);
+    explicit LightSource(const PositionComponent &position);
 
     ~LightSource() override = default;
 
@@ -47,7 +45,7 @@ public:
     [[nodiscard]] glm::mat4 view() const;
     [[nodiscard]] glm::mat4 view(const glm::vec3 &forward) const;
 
-    [[nodiscard]] const std::shared_ptr<PositionComponent> position() const { return this->_position; }
+    [[nodiscard]] PositionComponent *position() const;
 
     void acceptEdit(const std::shared_ptr<ObjectEditVisitor> &visitor) override;
 };
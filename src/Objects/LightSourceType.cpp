@@ -5,6 +5,7 @@
 static constexpr const char *POINT_LIGHT_SOURCE_NAME = "point";
 static constexpr const char *CONE_LIGHT_SOURCE_NAME = "cone";
 static constexpr const char *RECTANGLE_LIGHT_SOURCE_NAME = "rectangle";
+static constexpr const char *DIRECTIONAL_LIGHT_SOURCE_NAME = "directional";
 
 LightSourceType lightSourceTypeFromString(const std::string &value) {
     if (value == POINT_LIGHT_SOURCE_NAME) {
@@ -19,6 +20,10 @@ LightSourceType lightSourceTypeFromString(const std::string &value) {
         return RECTANGLE_LIGHT_SOURCE;
     }
 
+    if (value == DIRECTIONAL_LIGHT_SOURCE_NAME) {
+        return DIRECTIONAL_LIGHT_SOURCE;
+    }
+
     throw std::out_of_range(fmt::format("Unknown resource type {0}", value));
 }
 
@@ -32,6 +37,9 @@ std::string toString(const LightSourceType &type) {
 
         case RECTANGLE_LIGHT_SOURCE:
             return RECTANGLE_LIGHT_SOURCE_NAME;
+
+        case DIRECTIONAL_LIGHT_SOURCE:
+            return DIRECTIONAL_LIGHT_SOURCE_NAME;
     }
 
     throw std::out_of_range("Unknown resource type");
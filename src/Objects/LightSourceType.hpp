@@ -6,7 +6,8 @@
 enum LightSourceType : uint8_t {
     POINT_LIGHT_SOURCE,
     CONE_LIGHT_SOURCE,
-    RECTANGLE_LIGHT_SOURCE
+    RECTANGLE_LIGHT_SOURCE,
+    DIRECTIONAL_LIGHT_SOURCE
 };
 
 LightSourceType lightSourceTypeFromString(const std::string &value);
@@ -6,6 +6,24 @@ Object::Object() : _id(++ids) {
     //
 }
 
+Object::~Object() {
+    for (auto storage: ComponentStorageBase::storages()) {
+        storage->remove(this->_id);
+    }
+}
+
+std::vector<Component *> Object::components() const {
+    std::vector<Component *> components;
+
+    for (auto storage: ComponentStorageBase::storages()) {
+        if (auto component = storage->tryGetComponent(this->_id)) {
+            components.push_back(component);
+        }
+    }
+
+    return components;
+}
+
 void Object::acceptEdit(const std::shared_ptr<ObjectEditVisitor> &visitor) {
     // nothing to do
 }
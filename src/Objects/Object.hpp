@@ -1,54 +1,54 @@
 #ifndef OBJECTS_OBJECT_HPP
 #define OBJECTS_OBJECT_HPP
 
-#include <algorithm>
 #include <cstdint>
 #include <memory>
-#include <optional>
-#include <type_traits>
+#include <utility>
 #include <vector>
 #include <string>
 
+#include "src/Objects/Components/ComponentStorage.hpp"
+
 class ObjectEditVisitor;
 class Component;
 
+// Components of objects are kept in storages of their types and keyed by object id. Storages are not thread safe,
+// objects are created, edited and read by systems on main thread only.
 class Object {
 private:
     uint64_t _id;
 
 protected:
-    std::vector<std::shared_ptr<Component>> _components;
-
     Object();
 
+    template<typename T, typename ...Args>
+    T &addComponent(Args &&...args);
+
 public:
-    virtual ~Object() = default;
+    virtual ~Object();
 
     [[nodiscard]] virtual std::string displayName() = 0;
 
     [[nodiscard]] const uint64_t &id() const { return this->_id; }
-    [[nodiscard]] const std::vector<std::shared_ptr<Component>> &components() const { return this->_components; }
+
+    // valid until components of the same types are added or removed
+    [[nodiscard]] std::vector<Component *> components() const;
 
     virtual void acceptEdit(const std::shared_ptr<ObjectEditVisitor> &visitor);
 
+    // nullptr if object has no such component
     template<typename T>
-    [[nodiscard]] std::weak_ptr<T> getComponent();
+    [[nodiscard]] T *getComponent() const;
 };
 
-template<typename T>
-std::weak_ptr<T> Object::getComponent() {
-    static_assert(std::is_base_of<Component, T>::value);
-
-    auto it = std::find_if(this->_components.begin(), this->_components.end(),
-                           [](std::shared_ptr<Component> &component) {
-                               return std::dynamic_pointer_cast<T>(component) != nullptr;
-                           });
-
-    if (it == this->_components.end()) {
-        return std::weak_ptr<T>();
-    }
+template<typename T, typename ...Args>
+T &Object::addComponent(Args &&...args) {
+    return ComponentStorage<T>::instance().emplace(this->_id, std::forward<Args>(args)...);
+}
 
-    return std::dynamic_pointer_cast<T>(*it);
+template<typename T>
+T *Object::getComponent() const {
+    return ComponentStorage<T>::instance().tryGet(this->_id);
 }
 
 #endif // OBJECTS_OBJECT_HPP
@@ -5,19 +5,25 @@
 #include "src/Objects/Components/ModelComponent.hpp"
 #include "src/Objects/Components/PositionComponent.hpp"
 
-Prop::Prop() : Prop(std::make_shared<PositionComponent>(),
-                    std::make_shared<ModelComponent>()) {
+Prop::Prop() : Prop(PositionComponent(),
+                    ModelComponent()) {
     //
 }
 
-Prop::Prop(const std::shared_ptr<PositionComponent> &position,
-           const std::shared_ptr<ModelComponent> &model)
-        : _position(position),
-          _model(model) {
-    this->_components.push_back(this->_position);
-    this->_components.push_back(this->_model);
+Prop::Prop(const PositionComponent &position,
+           const ModelComponent &model) {
+    this->addComponent<PositionComponent>(position);
+    this->addComponent<ModelComponent>(model);
 }
 
 std::string Prop::displayName() {
     return fmt::format("({0}) prop", this->id());
 }
+
+PositionComponent *Prop::position() const {
+    return this->getComponent<PositionComponent>();
+}
+
+ModelComponent *Prop::model() const {
+    return this->getComponent<ModelComponent>();
+}
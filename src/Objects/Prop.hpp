@@ -7,22 +7,18 @@ class PositionComponent;
 class ModelComponent;
 
 class Prop : public Object {
-private:
-    std::shared_ptr<PositionComponent> _position;
-    std::shared_ptr<ModelComponent> _model;
-
 public:
     explicit Prop();
-    explicit Prop(const std::shared_ptr<PositionComponent> &position,
-                  const std::shared_ptr<ModelComponent> &model);
+    explicit Prop(const PositionComponent &position,
+                  const ModelComponent &model);
 
     ~Prop() override = default;
 
     std::string displayName() override;
 
-    [[nodiscard]] const std::shared_ptr<PositionComponent> position() const { return this->_position; }
+    [[nodiscard]] PositionComponent *position() const;
 
-    [[nodiscard]] const std::shared_ptr<ModelComponent> model() const { return this->_model; }
+    [[nodiscard]] ModelComponent *model() const;
 };
 
 #endif // OBJECTS_PROP_HPP
@@ -4,15 +4,18 @@
 
 #include "src/Objects/Components/SkyboxComponent.hpp"
 
-World::World() : World(std::make_shared<SkyboxComponent>()) {
+World::World() : World(SkyboxComponent()) {
     //
 }
 
-World::World(const std::shared_ptr<SkyboxComponent> &skybox)
-        : _skybox(skybox) {
-    this->_components.push_back(this->_skybox);
+World::World(const SkyboxComponent &skybox) {
+    this->addComponent<SkyboxComponent>(skybox);
 }
 
 std::string World::displayName() {
     return fmt::format("({0}) world", this->id());
 }
+
+SkyboxComponent *World::skybox() const {
+    return this->getComponent<SkyboxComponent>();
+}
@@ -6,18 +6,15 @@
 class SkyboxComponent;
 
 class World : public Object {
-private:
-    std::shared_ptr<SkyboxComponent> _skybox;
-
 public:
     explicit World();
-    explicit World(const std::shared_ptr<SkyboxComponent> &skybox);
+    explicit World(const SkyboxComponent &skybox);
 
     ~World() override = default;
 
     std::string displayName() override;
 
-    [[nodiscard]] const std::shared_ptr<SkyboxComponent> &skybox() const { return this->_skybox; }
+    [[nodiscard]] SkyboxComponent *skybox() const;
 };
 
 #endif // OBJECTS_WORLD_HPP
@@ -2,12 +2,57 @@
 
 #include "src/Engine/EngineError.hpp"
 #include "src/Engine/Log.hpp"
-#include "src/Rendering/Proxies/CommandBufferProxy.hpp"
 #include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
 #include "src/Rendering/Proxies/PhysicalDeviceProxy.hpp"
 
 static constexpr const char *COMMAND_MANAGER_TAG = "CommandManager";
 
+// transient pools grow in batches to avoid allocating buffers one at a time
+static constexpr const uint32_t TRANSIENT_BUFFER_BATCH_SIZE = 4;
+
+vk::CommandPool CommandManager::createCommandPool(vk::CommandPoolCreateFlags flags) const {
+    vk::CommandPoolCreateInfo createInfo = vk::CommandPoolCreateInfo()
+            .setFlags(flags)
+            .setQueueFamilyIndex(this->_physicalDevice->getGraphicsQueueFamilyIdx());
+
+    return this->_logicalDevice->getHandle().createCommandPool(createInfo);
+}
+
+std::vector<vk::CommandBuffer> CommandManager::allocateBuffers(const vk::CommandPool &commandPool,
+                                                               vk::CommandBufferLevel level,
+                                                               uint32_t count) const {
+    vk::CommandBufferAllocateInfo allocateInfo = vk::CommandBufferAllocateInfo()
+            .setCommandPool(commandPool)
+            .setLevel(level)
+            .setCommandBufferCount(count);
+
+    try {
+        return this->_logicalDevice->getHandle().allocateCommandBuffers(allocateInfo);
+    } catch (const std::exception &error) {
+        this->_log->error(COMMAND_MANAGER_TAG, error);
+        throw EngineError("Failed to allocate command buffers");
+    }
+}
+
+vk::CommandBuffer CommandManager::acquireTransientBuffer(uint32_t frameIdx, uint32_t threadIdx,
+                                                         vk::CommandBufferLevel level) {
+    auto &pool = this->_framePools[frameIdx][threadIdx];
+
+    auto &buffers = level == vk::CommandBufferLevel::ePrimary
+                    ? pool.primaryBuffers
+                    : pool.secondaryBuffers;
+    auto &used = level == vk::CommandBufferLevel::ePrimary
+                 ? pool.usedPrimaryBuffers
+                 : pool.usedSecondaryBuffers;
+
+    if (used == buffers.size()) {
+        auto allocated = this->allocateBuffers(pool.commandPool, level, TRANSIENT_BUFFER_BATCH_SIZE);
+        buffers.insert(buffers.end(), allocated.begin(), allocated.end());
+    }
+
+    return buffers[used++];
+}
+
 CommandManager::CommandManager(const std::shared_ptr<Log> &log,
                                const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
                                const std::shared_ptr<LogicalDeviceProxy> &logicalDevice)
@@ -18,37 +63,113 @@ CommandManager::CommandManager(const std::shared_ptr<Log> &log,
 }
 
 void CommandManager::init() {
-    vk::CommandPoolCreateInfo createInfo = vk::CommandPoolCreateInfo()
-            .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
-            .setQueueFamilyIndex(this->_physicalDevice->getGraphicsQueueFamilyIdx());
+    //
+}
+
+void CommandManager::destroy() {
+    this->destroyFramePools();
+
+    {
+        std::lock_guard lock(this->_oneShotPoolsMutex);
+
+        if (this->_heldOneShotBuffers > 0) {
+            this->_log->warning(COMMAND_MANAGER_TAG, "One-shot command buffers are not released before destroy");
+        }
+
+        for (const auto &pool: this->_idleOneShotPools) {
+            this->_logicalDevice->getHandle().destroy(pool.commandPool);
+        }
+
+        this->_idleOneShotPools.clear();
+    }
+}
+
+void CommandManager::initFramePools(uint32_t frameCount, uint32_t threadCount) {
+    this->_framePools = std::vector<std::vector<TransientPool>>(frameCount,
+                                                                std::vector<TransientPool>(threadCount));
 
     try {
-        this->_commandPool = this->_logicalDevice->getHandle().createCommandPool(createInfo);
+        for (auto &framePools: this->_framePools) {
+            for (auto &pool: framePools) {
+                pool.commandPool = this->createCommandPool(vk::CommandPoolCreateFlagBits::eTransient);
+            }
+        }
     } catch (const std::exception &error) {
         this->_log->error(COMMAND_MANAGER_TAG, error);
-        throw EngineError("Failed to initialize command manager");
+        throw EngineError("Failed to initialize frame command pools");
     }
 }
 
-void CommandManager::destroy() {
-    this->_logicalDevice->getHandle().destroy(this->_commandPool);
+void CommandManager::destroyFramePools() {
+    for (const auto &framePools: this->_framePools) {
+        for (const auto &pool: framePools) {
+            this->_logicalDevice->getHandle().destroy(pool.commandPool);
+        }
+    }
+
+    this->_framePools.clear();
 }
 
-std::shared_ptr<CommandBufferProxy> CommandManager::createPrimaryBuffer() const {
-    vk::CommandBufferAllocateInfo allocateInfo = vk::CommandBufferAllocateInfo()
-            .setCommandPool(this->_commandPool)
-            .setLevel(vk::CommandBufferLevel::ePrimary)
-            .setCommandBufferCount(1);
+void CommandManager::resetFramePools(uint32_t frameIdx) {
+    for (auto &pool: this->_framePools[frameIdx]) {
+        this->_logicalDevice->getHandle().resetCommandPool(pool.commandPool);
 
+        pool.usedPrimaryBuffers = 0;
+        pool.usedSecondaryBuffers = 0;
+    }
+}
 
-    std::vector<vk::CommandBuffer> buffers;
+vk::CommandBuffer CommandManager::acquirePrimaryBuffer(uint32_t frameIdx, uint32_t threadIdx) {
+    return this->acquireTransientBuffer(frameIdx, threadIdx, vk::CommandBufferLevel::ePrimary);
+}
+
+vk::CommandBuffer CommandManager::acquireSecondaryBuffer(uint32_t frameIdx, uint32_t threadIdx) {
+    return this->acquireTransientBuffer(frameIdx, threadIdx, vk::CommandBufferLevel::eSecondary);
+}
+
+OneShotBuffer CommandManager::acquireOneShotBuffer() {
+    {
+        std::lock_guard lock(this->_oneShotPoolsMutex);
+
+        this->_heldOneShotBuffers++;
+
+        if (!this->_idleOneShotPools.empty()) {
+            auto oneShotBuffer = this->_idleOneShotPools.back();
+            this->_idleOneShotPools.pop_back();
+
+            return oneShotBuffer;
+        }
+    }
+
+    // pool is not shared yet, so it is created without lock held
+    OneShotBuffer oneShotBuffer;
 
     try {
-        buffers = this->_logicalDevice->getHandle().allocateCommandBuffers(allocateInfo);
+        oneShotBuffer.commandPool = this->createCommandPool(vk::CommandPoolCreateFlagBits::eTransient);
+        oneShotBuffer.commandBuffer = this->allocateBuffers(oneShotBuffer.commandPool,
+                                                            vk::CommandBufferLevel::ePrimary, 1)[0];
     } catch (const std::exception &error) {
         this->_log->error(COMMAND_MANAGER_TAG, error);
-        throw EngineError("Failed to create primary command buffer");
+
+        if (oneShotBuffer.commandPool) {
+            this->_logicalDevice->getHandle().destroy(oneShotBuffer.commandPool);
+        }
+
+        std::lock_guard lock(this->_oneShotPoolsMutex);
+        this->_heldOneShotBuffers--;
+
+        throw EngineError("Failed to create one-shot command buffer");
     }
 
-    return std::make_shared<CommandBufferProxy>(this->_logicalDevice, this->_commandPool, buffers[0]);
+    return oneShotBuffer;
+}
+
+void CommandManager::releaseOneShotBuffer(const OneShotBuffer &oneShotBuffer) {
+    // pool belongs to caller until it is returned, so it is reset without lock held
+    this->_logicalDevice->getHandle().resetCommandPool(oneShotBuffer.commandPool);
+
+    std::lock_guard lock(this->_oneShotPoolsMutex);
+
+    this->_idleOneShotPools.push_back(oneShotBuffer);
+    this->_heldOneShotBuffers--;
 }
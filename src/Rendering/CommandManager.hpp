@@ -2,21 +2,49 @@
 #define RENDERING_COMMANDMANAGER_HPP
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <vulkan/vulkan.hpp>
 
 class Log;
-class CommandBufferProxy;
 class LogicalDeviceProxy;
 class PhysicalDeviceProxy;
 
+// one-shot buffer with pool it was allocated from, pool is used only by holder of buffer until it is released
+struct OneShotBuffer {
+    vk::CommandPool commandPool;
+    vk::CommandBuffer commandBuffer;
+};
+
 class CommandManager {
 private:
+    struct TransientPool {
+        vk::CommandPool commandPool;
+        std::vector<vk::CommandBuffer> primaryBuffers;
+        std::vector<vk::CommandBuffer> secondaryBuffers;
+        uint32_t usedPrimaryBuffers = 0;
+        uint32_t usedSecondaryBuffers = 0;
+    };
+
     std::shared_ptr<Log> _log;
     std::shared_ptr<PhysicalDeviceProxy> _physicalDevice;
     std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
 
-    vk::CommandPool _commandPool;
+    // [frameIdx][threadIdx], every pool is reset as a whole once its frame is retired
+    std::vector<std::vector<TransientPool>> _framePools;
+
+    // every idle pool keeps its single buffer, so pool count is the peak of concurrently held one-shot buffers
+    std::mutex _oneShotPoolsMutex;
+    std::vector<OneShotBuffer> _idleOneShotPools;
+    uint32_t _heldOneShotBuffers = 0;
+
+    vk::CommandPool createCommandPool(vk::CommandPoolCreateFlags flags) const;
+    std::vector<vk::CommandBuffer> allocateBuffers(const vk::CommandPool &commandPool,
+                                                   vk::CommandBufferLevel level,
+                                                   uint32_t count) const;
+
+    vk::CommandBuffer acquireTransientBuffer(uint32_t frameIdx, uint32_t threadIdx, vk::CommandBufferLevel level);
 
 public:
     CommandManager(const std::shared_ptr<Log> &log,
@@ -26,7 +54,17 @@ public:
     void init();
     void destroy();
 
-    [[nodiscard]] std::shared_ptr<CommandBufferProxy> createPrimaryBuffer() const;
+    void initFramePools(uint32_t frameCount, uint32_t threadCount);
+    void destroyFramePools();
+    void resetFramePools(uint32_t frameIdx);
+
+    // valid until frame pools of frameIdx are reset, threadIdx pool must be used by single thread at a time
+    [[nodiscard]] vk::CommandBuffer acquirePrimaryBuffer(uint32_t frameIdx, uint32_t threadIdx);
+    [[nodiscard]] vk::CommandBuffer acquireSecondaryBuffer(uint32_t frameIdx, uint32_t threadIdx);
+
+    // one-shot buffer could be recorded by any thread and released by another once its execution is completed
+    [[nodiscard]] OneShotBuffer acquireOneShotBuffer();
+    void releaseOneShotBuffer(const OneShotBuffer &oneShotBuffer);
 };
 
 #endif // RENDERING_COMMANDMANAGER_HPP
@@ -0,0 +1,83 @@
+#include "DeletionQueue.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "src/Rendering/GpuTimeline.hpp"
+
+DeletionQueue::DeletionQueue(const std::shared_ptr<GpuTimeline> &timeline)
+        : _timeline(timeline) {
+    //
+}
+
+void DeletionQueue::push(DeletionJob job, uint32_t frameCount) {
+    std::lock_guard lock(this->_mutex);
+
+    this->_jobs.push_back(PendingJob{
+            .value = std::nullopt,
+            .framesLeft = std::max<uint32_t>(frameCount, 1),
+            .job = std::move(job)
+    });
+}
+
+void DeletionQueue::stamp(uint64_t value) {
+    std::lock_guard lock(this->_mutex);
+
+    for (auto it = this->_jobs.rbegin(); it != this->_jobs.rend() && !it->value.has_value(); ++it) {
+        it->value = value;
+    }
+}
+
+void DeletionQueue::collect() {
+    auto completedValue = this->_timeline->getCompletedValue();
+
+    std::vector<DeletionJob> jobs;
+    std::vector<PendingJob> delayedJobs;
+
+    {
+        std::lock_guard lock(this->_mutex);
+
+        while (!this->_jobs.empty()) {
+            auto &pending = this->_jobs.front();
+
+            if (!pending.value.has_value() || pending.value.value() > completedValue) {
+                break;
+            }
+
+            if (pending.framesLeft > 1) {
+                delayedJobs.push_back(PendingJob{
+                        .value = std::nullopt,
+                        .framesLeft = pending.framesLeft - 1,
+                        .job = std::move(pending.job)
+                });
+            } else {
+                jobs.push_back(std::move(pending.job));
+            }
+
+            this->_jobs.pop_front();
+        }
+
+        // delayed jobs go to the back to be stamped with the next submission
+        for (auto &pending: delayedJobs) {
+            this->_jobs.push_back(std::move(pending));
+        }
+    }
+
+    // jobs could free resources through other components, so they are executed without lock held
+    for (const auto &job: jobs) {
+        job();
+    }
+}
+
+void DeletionQueue::flush() {
+    std::deque<PendingJob> jobs;
+
+    {
+        std::lock_guard lock(this->_mutex);
+        std::swap(jobs, this->_jobs);
+    }
+
+    for (const auto &pending: jobs) {
+        pending.job();
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef RENDERING_DELETIONQUEUE_HPP
+#define RENDERING_DELETIONQUEUE_HPP
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+class GpuTimeline;
+
+using DeletionJob = std::function<void()>;
+
+// Holds destruction of GPU objects until frames that could reference them are retired. Pushed jobs are stamped with
+// value of the next frame submission and executed once GPU timeline reaches it. Jobs pushed with frame count above one
+// are stamped again on every completion until that many submissions made after push are completed.
+class DeletionQueue {
+private:
+    struct PendingJob {
+        std::optional<uint64_t> value;
+        uint32_t framesLeft;
+        DeletionJob job;
+    };
+
+    std::shared_ptr<GpuTimeline> _timeline;
+
+    std::mutex _mutex;
+    std::deque<PendingJob> _jobs;
+
+public:
+    explicit DeletionQueue(const std::shared_ptr<GpuTimeline> &timeline);
+
+    void push(DeletionJob job, uint32_t frameCount = 1);
+
+    // called right after frame submission, value is the one frame was submitted with
+    void stamp(uint64_t value);
+
+    void collect();
+    void flush();
+};
+
+#endif // RENDERING_DELETIONQUEUE_HPP
@@ -0,0 +1,286 @@
+#include "DescriptorAllocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <map>
+
+#include "src/Engine/EngineError.hpp"
+#include "src/Engine/Log.hpp"
+#include "src/Engine/VarCollection.hpp"
+#include "src/Engine/Vars.hpp"
+#include "src/Rendering/DeletionQueue.hpp"
+#include "src/Rendering/PipelineCompiler.hpp"
+#include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
+
+static constexpr const char *DESCRIPTOR_ALLOCATOR_TAG = "DescriptorAllocator";
+
+struct DescriptorRatio {
+    vk::DescriptorType type;
+    float perSet;
+};
+
+// average number of descriptors of each type per set, used for pools shared by different layouts
+static constexpr const std::array<DescriptorRatio, 11> DESCRIPTOR_RATIOS = {
+        DescriptorRatio{vk::DescriptorType::eSampler, 0.5f},
+        DescriptorRatio{vk::DescriptorType::eCombinedImageSampler, 4.0f},
+        DescriptorRatio{vk::DescriptorType::eSampledImage, 4.0f},
+        DescriptorRatio{vk::DescriptorType::eStorageImage, 1.0f},
+        DescriptorRatio{vk::DescriptorType::eUniformTexelBuffer, 1.0f},
+        DescriptorRatio{vk::DescriptorType::eStorageTexelBuffer, 1.0f},
+        DescriptorRatio{vk::DescriptorType::eUniformBuffer, 4.0f},
+        DescriptorRatio{vk::DescriptorType::eStorageBuffer, 4.0f},
+        DescriptorRatio{vk::DescriptorType::eUniformBufferDynamic, 1.0f},
+        DescriptorRatio{vk::DescriptorType::eStorageBufferDynamic, 1.0f},
+        DescriptorRatio{vk::DescriptorType::eInputAttachment, 1.0f}
+};
+
+std::size_t DescriptorAllocator::hashBindings(const std::vector<vk::DescriptorSetLayoutBinding> &bindings) {
+    std::size_t hash = 0;
+
+    for (const auto &binding: bindings) {
+        hashCombine(hash, binding.binding);
+        hashCombine(hash, static_cast<uint32_t>(binding.descriptorType));
+        hashCombine(hash, binding.descriptorCount);
+        hashCombine(hash, static_cast<VkShaderStageFlags>(binding.stageFlags));
+    }
+
+    return hash;
+}
+
+std::vector<vk::DescriptorPoolSize> DescriptorAllocator::getPoolSizes(uint32_t setCount) {
+    std::vector<vk::DescriptorPoolSize> poolSizes;
+
+    for (const auto &ratio: DESCRIPTOR_RATIOS) {
+        auto count = static_cast<uint32_t>(std::ceil(ratio.perSet * static_cast<float>(setCount)));
+
+        poolSizes.emplace_back(ratio.type, count);
+    }
+
+    return poolSizes;
+}
+
+vk::DescriptorPool DescriptorAllocator::createPool(const std::vector<vk::DescriptorPoolSize> &poolSizes,
+                                                   uint32_t setCount,
+                                                   vk::DescriptorPoolCreateFlags flags) {
+    auto createInfo = vk::DescriptorPoolCreateInfo()
+            .setFlags(flags)
+            .setMaxSets(setCount)
+            .setPoolSizes(poolSizes);
+
+    try {
+        return this->_logicalDevice->getHandle().createDescriptorPool(createInfo);
+    } catch (const std::exception &error) {
+        this->_log->error(DESCRIPTOR_ALLOCATOR_TAG, error);
+        throw EngineError("Failed to create descriptor pool");
+    }
+}
+
+DescriptorAllocator::DescriptorAllocator(const std::shared_ptr<Log> &log,
+                                         const std::shared_ptr<VarCollection> &varCollection,
+                                         const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                                         const std::shared_ptr<DeletionQueue> &deletionQueue)
+        : _log(log),
+          _varCollection(varCollection),
+          _logicalDevice(logicalDevice),
+          _deletionQueue(deletionQueue) {
+    //
+}
+
+void DescriptorAllocator::init() {
+    this->_poolSetCount = std::max(this->_varCollection->getIntOrDefault(RENDERING_DESCRIPTOR_POOL_SIZE, 256), 1);
+    this->_framePoolSizes = getPoolSizes(this->_poolSetCount);
+}
+
+void DescriptorAllocator::destroy() {
+    this->destroyFramePools();
+
+    std::lock_guard lock(this->_layoutsMutex);
+
+    auto device = this->_logicalDevice->getHandle();
+
+    for (const auto &[layout, layoutPools]: this->_layoutPools) {
+        for (const auto &layoutPool: layoutPools.pools) {
+            device.destroy(layoutPool.pool);
+        }
+    }
+
+    for (const auto &[hash, cachedLayouts]: this->_layouts) {
+        for (const auto &cachedLayout: cachedLayouts) {
+            device.destroy(cachedLayout.layout);
+        }
+    }
+
+    this->_layoutPools.clear();
+    this->_layouts.clear();
+}
+
+vk::DescriptorSetLayout DescriptorAllocator::getLayout(const std::vector<vk::DescriptorSetLayoutBinding> &bindings) {
+    std::lock_guard lock(this->_layoutsMutex);
+
+    auto &cachedLayouts = this->_layouts[hashBindings(bindings)];
+
+    auto it = std::find_if(cachedLayouts.begin(), cachedLayouts.end(), [&bindings](const CachedLayout &cached) {
+        return cached.bindings == bindings;
+    });
+
+    if (it != cachedLayouts.end()) {
+        return it->layout;
+    }
+
+    vk::DescriptorSetLayout layout;
+
+    try {
+        layout = this->_logicalDevice->getHandle().createDescriptorSetLayout(
+                vk::DescriptorSetLayoutCreateInfo().setBindings(bindings));
+    } catch (const std::exception &error) {
+        this->_log->error(DESCRIPTOR_ALLOCATOR_TAG, error);
+        throw EngineError("Failed to create descriptor set layout");
+    }
+
+    cachedLayouts.push_back(CachedLayout{
+            .bindings = bindings,
+            .layout = layout
+    });
+
+    // pools of layout fit exactly pool size sets of it
+    std::map<vk::DescriptorType, uint32_t> counts;
+
+    for (const auto &binding: bindings) {
+        counts[binding.descriptorType] += binding.descriptorCount * this->_poolSetCount;
+    }
+
+    auto &layoutPools = this->_layoutPools[static_cast<VkDescriptorSetLayout>(layout)];
+
+    for (const auto &[type, count]: counts) {
+        layoutPools.poolSizes.emplace_back(type, count);
+    }
+
+    return layout;
+}
+
+vk::DescriptorSet DescriptorAllocator::allocate(const vk::DescriptorSetLayout &layout) {
+    std::lock_guard lock(this->_layoutsMutex);
+
+    auto it = this->_layoutPools.find(static_cast<VkDescriptorSetLayout>(layout));
+
+    if (it == this->_layoutPools.end()) {
+        throw EngineError("Descriptor set layout is not owned by allocator");
+    }
+
+    auto &layoutPools = it->second;
+
+    auto poolIt = std::find_if(layoutPools.pools.begin(), layoutPools.pools.end(), [](const LayoutPool &layoutPool) {
+        return layoutPool.freeCount > 0;
+    });
+
+    if (poolIt == layoutPools.pools.end()) {
+        layoutPools.pools.push_back(LayoutPool{
+                .pool = this->createPool(layoutPools.poolSizes, this->_poolSetCount,
+                                         vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet),
+                .freeCount = this->_poolSetCount
+        });
+
+        poolIt = std::prev(layoutPools.pools.end());
+    }
+
+    auto set = this->_logicalDevice->getHandle().allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+                                                                                .setDescriptorPool(poolIt->pool)
+                                                                                .setSetLayouts(layout))[0];
+
+    poolIt->freeCount--;
+    layoutPools.poolIndices[static_cast<VkDescriptorSet>(set)] = std::distance(layoutPools.pools.begin(), poolIt);
+
+    return set;
+}
+
+void DescriptorAllocator::free(const vk::DescriptorSetLayout &layout, const vk::DescriptorSet &set) {
+    this->_deletionQueue->push([this, layout, set]() {
+        std::lock_guard lock(this->_layoutsMutex);
+
+        auto &layoutPools = this->_layoutPools.at(static_cast<VkDescriptorSetLayout>(layout));
+        auto poolIdx = layoutPools.poolIndices.at(static_cast<VkDescriptorSet>(set));
+        auto &layoutPool = layoutPools.pools[poolIdx];
+
+        this->_logicalDevice->getHandle().freeDescriptorSets(layoutPool.pool, set);
+
+        layoutPool.freeCount++;
+        layoutPools.poolIndices.erase(static_cast<VkDescriptorSet>(set));
+    });
+}
+
+void DescriptorAllocator::initFramePools(uint32_t frameCount) {
+    std::lock_guard lock(this->_framePoolsMutex);
+
+    this->_framePools = std::vector<FramePools>(frameCount);
+}
+
+void DescriptorAllocator::destroyFramePools() {
+    std::lock_guard lock(this->_framePoolsMutex);
+
+    for (const auto &framePools: this->_framePools) {
+        for (const auto &pool: framePools.pools) {
+            this->_logicalDevice->getHandle().destroy(pool);
+        }
+    }
+
+    this->_framePools.clear();
+}
+
+void DescriptorAllocator::resetFramePools(uint32_t frameIdx) {
+    std::lock_guard lock(this->_framePoolsMutex);
+
+    auto &framePools = this->_framePools[frameIdx];
+
+    // pools are kept, so frames after warm up do not create any
+    for (const auto &pool: framePools.pools) {
+        this->_logicalDevice->getHandle().resetDescriptorPool(pool);
+    }
+
+    framePools.currentPool = 0;
+}
+
+vk::DescriptorSet DescriptorAllocator::allocateFrameSet(uint32_t frameIdx, const vk::DescriptorSetLayout &layout) {
+    std::lock_guard lock(this->_framePoolsMutex);
+
+    auto &framePools = this->_framePools[frameIdx];
+
+    while (true) {
+        bool created = false;
+
+        if (framePools.currentPool == framePools.pools.size()) {
+            framePools.pools.push_back(this->createPool(this->_framePoolSizes, this->_poolSetCount,
+                                                        vk::DescriptorPoolCreateFlags()));
+            created = true;
+        }
+
+        auto allocateInfo = vk::DescriptorSetAllocateInfo()
+                .setDescriptorPool(framePools.pools[framePools.currentPool])
+                .setSetLayouts(layout);
+
+        try {
+            return this->_logicalDevice->getHandle().allocateDescriptorSets(allocateInfo)[0];
+        } catch (const vk::OutOfPoolMemoryError &error) {
+            if (created) {
+                this->_log->error(DESCRIPTOR_ALLOCATOR_TAG, error);
+                throw EngineError("Descriptor set does not fit into frame descriptor pool");
+            }
+        } catch (const vk::FragmentedPoolError &error) {
+            if (created) {
+                this->_log->error(DESCRIPTOR_ALLOCATOR_TAG, error);
+                throw EngineError("Descriptor set does not fit into frame descriptor pool");
+            }
+        }
+
+        framePools.currentPool++;
+    }
+}
+
+vk::DescriptorPool DescriptorAllocator::createStandalonePool(uint32_t setCount, vk::DescriptorPoolCreateFlags flags) {
+    return this->createPool(getPoolSizes(setCount), setCount, flags);
+}
+
+void DescriptorAllocator::destroyStandalonePool(const vk::DescriptorPool &pool) {
+    this->_logicalDevice->getHandle().destroy(pool);
+}
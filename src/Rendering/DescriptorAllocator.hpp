@@ -0,0 +1,97 @@
+#ifndef RENDERING_DESCRIPTORALLOCATOR_HPP
+#define RENDERING_DESCRIPTORALLOCATOR_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+class Log;
+class VarCollection;
+class DeletionQueue;
+class LogicalDeviceProxy;
+
+// Descriptor sets of render stages. Set layouts are cached by hash of their bindings, so equal layouts are shared.
+// Long-lived sets come from pools dedicated to their layout: every set of such pool has same size, so freed sets are
+// reused without fragmentation. Sets of a single frame come from per-frame pools, which are reset as a whole once
+// that frame is retired.
+class DescriptorAllocator {
+private:
+    struct CachedLayout {
+        std::vector<vk::DescriptorSetLayoutBinding> bindings;
+        vk::DescriptorSetLayout layout;
+    };
+
+    struct LayoutPool {
+        vk::DescriptorPool pool;
+        uint32_t freeCount;
+    };
+
+    struct LayoutPools {
+        std::vector<vk::DescriptorPoolSize> poolSizes;
+        std::vector<LayoutPool> pools;
+        std::unordered_map<VkDescriptorSet, std::size_t> poolIndices;
+    };
+
+    struct FramePools {
+        std::vector<vk::DescriptorPool> pools;
+
+        // pools before current one are exhausted
+        std::size_t currentPool;
+    };
+
+    std::shared_ptr<Log> _log;
+    std::shared_ptr<VarCollection> _varCollection;
+    std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
+
+    uint32_t _poolSetCount;
+    std::vector<vk::DescriptorPoolSize> _framePoolSizes;
+
+    std::mutex _layoutsMutex;
+    std::unordered_map<std::size_t, std::vector<CachedLayout>> _layouts;
+    std::unordered_map<VkDescriptorSetLayout, LayoutPools> _layoutPools;
+
+    std::mutex _framePoolsMutex;
+    std::vector<FramePools> _framePools;
+
+    static std::size_t hashBindings(const std::vector<vk::DescriptorSetLayoutBinding> &bindings);
+    static std::vector<vk::DescriptorPoolSize> getPoolSizes(uint32_t setCount);
+
+    vk::DescriptorPool createPool(const std::vector<vk::DescriptorPoolSize> &poolSizes, uint32_t setCount,
+                                  vk::DescriptorPoolCreateFlags flags);
+
+public:
+    DescriptorAllocator(const std::shared_ptr<Log> &log,
+                        const std::shared_ptr<VarCollection> &varCollection,
+                        const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                        const std::shared_ptr<DeletionQueue> &deletionQueue);
+
+    void init();
+    void destroy();
+
+    // cached layouts are owned by allocator
+    [[nodiscard]] vk::DescriptorSetLayout getLayout(const std::vector<vk::DescriptorSetLayoutBinding> &bindings);
+
+    // layout must be obtained from allocator
+    [[nodiscard]] vk::DescriptorSet allocate(const vk::DescriptorSetLayout &layout);
+
+    // set is reused after frames that could use it are retired
+    void free(const vk::DescriptorSetLayout &layout, const vk::DescriptorSet &set);
+
+    void initFramePools(uint32_t frameCount);
+    void destroyFramePools();
+    void resetFramePools(uint32_t frameIdx);
+
+    // valid until frame pools of frameIdx are reset
+    [[nodiscard]] vk::DescriptorSet allocateFrameSet(uint32_t frameIdx, const vk::DescriptorSetLayout &layout);
+
+    // pool for users that allocate sets by themselves, sized with common ratios of descriptor types
+    [[nodiscard]] vk::DescriptorPool createStandalonePool(uint32_t setCount, vk::DescriptorPoolCreateFlags flags);
+    void destroyStandalonePool(const vk::DescriptorPool &pool);
+};
+
+#endif // RENDERING_DESCRIPTORALLOCATOR_HPP
@@ -0,0 +1,69 @@
+#include "FramePipeline.hpp"
+
+#include <algorithm>
+
+#include "src/Rendering/Types/FramePacket.hpp"
+
+FramePipeline::FramePipeline(uint32_t depth)
+        : _depth(std::max<uint32_t>(depth, 1)) {
+    //
+}
+
+bool FramePipeline::push(const std::shared_ptr<const FramePacket> &packet) {
+    {
+        std::unique_lock lock(this->_mutex);
+
+        this->_condition.wait(lock, [this]() {
+            return this->_closed || this->_packets.size() < this->_depth;
+        });
+
+        if (this->_closed) {
+            return false;
+        }
+
+        this->_packets.push_back(packet);
+    }
+
+    this->_condition.notify_all();
+
+    return true;
+}
+
+std::shared_ptr<const FramePacket> FramePipeline::pop(const std::stop_token &stopToken) {
+    std::shared_ptr<const FramePacket> packet;
+
+    {
+        std::unique_lock lock(this->_mutex);
+
+        if (!this->_condition.wait(lock, stopToken, [this]() { return this->_closed || !this->_packets.empty(); }) ||
+            this->_packets.empty()) {
+            return nullptr;
+        }
+
+        packet = this->_packets.front();
+        this->_packets.pop_front();
+    }
+
+    this->_condition.notify_all();
+
+    return packet;
+}
+
+void FramePipeline::waitEmpty() {
+    std::unique_lock lock(this->_mutex);
+
+    this->_condition.wait(lock, [this]() {
+        return this->_closed || this->_packets.empty();
+    });
+}
+
+void FramePipeline::close() {
+    {
+        std::lock_guard lock(this->_mutex);
+
+        this->_closed = true;
+        this->_packets.clear();
+    }
+
+    this->_condition.notify_all();
+}
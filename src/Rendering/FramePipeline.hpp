@@ -0,0 +1,38 @@
+#ifndef RENDERING_FRAMEPIPELINE_HPP
+#define RENDERING_FRAMEPIPELINE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+
+struct FramePacket;
+
+class FramePipeline {
+private:
+    uint32_t _depth;
+
+    std::mutex _mutex;
+    std::condition_variable_any _condition;
+    std::deque<std::shared_ptr<const FramePacket>> _packets;
+    bool _closed = false;
+
+public:
+    explicit FramePipeline(uint32_t depth);
+
+    // blocks producer while pipeline is full, returns false if pipeline is closed
+    bool push(const std::shared_ptr<const FramePacket> &packet);
+
+    // blocks consumer until packet is available, returns nullptr on stop or close
+    [[nodiscard]] std::shared_ptr<const FramePacket> pop(const std::stop_token &stopToken);
+
+    // blocks until consumer took every pushed packet
+    void waitEmpty();
+
+    void close();
+
+    [[nodiscard]] const uint32_t &getDepth() const { return this->_depth; }
+};
+
+#endif // RENDERING_FRAMEPIPELINE_HPP
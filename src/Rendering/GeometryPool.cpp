@@ -0,0 +1,258 @@
+#include "GeometryPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fmt/core.h>
+
+#include "src/Engine/EngineError.hpp"
+#include "src/Engine/Log.hpp"
+#include "src/Engine/VarCollection.hpp"
+#include "src/Engine/Vars.hpp"
+#include "src/Rendering/CommandManager.hpp"
+#include "src/Rendering/DeletionQueue.hpp"
+#include "src/Rendering/GpuAllocator.hpp"
+#include "src/Rendering/GpuTimeline.hpp"
+
+static constexpr const char *GEOMETRY_POOL_TAG = "GeometryPool";
+
+std::shared_ptr<BufferView> GeometryPool::allocateRegionBuffer(const Region &region, uint32_t capacity) {
+    return this->_allocator->allocateBuffer(BufferRequirements{
+            .size = region.elementSize * capacity,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | region.usage,
+            .memoryProperties = vk::MemoryPropertyFlagBits::eDeviceLocal
+    }, false).lock();
+}
+
+void GeometryPool::execute(const std::function<void(const vk::CommandBuffer &)> &record) {
+    auto oneShotBuffer = this->_commandManager->acquireOneShotBuffer();
+    auto commandBuffer = oneShotBuffer.commandBuffer;
+
+    auto beginInfo = vk::CommandBufferBeginInfo()
+            .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+    commandBuffer.begin(beginInfo);
+
+    record(commandBuffer);
+
+    // copied geometry is read by frames submitted after this one
+    auto barrier = vk::MemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead);
+
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                  vk::PipelineStageFlagBits::eVertexInput,
+                                  vk::DependencyFlags(), barrier, nullptr, nullptr);
+
+    commandBuffer.end();
+
+    auto value = this->_timeline->submit(GpuSubmission{
+            .commandBuffers = {commandBuffer}
+    });
+
+    this->_timeline->wait(value);
+
+    this->_commandManager->releaseOneShotBuffer(oneShotBuffer);
+}
+
+std::optional<uint32_t> GeometryPool::tryTakeRange(Region &region, uint32_t count) {
+    auto it = std::find_if(region.freeRanges.begin(), region.freeRanges.end(), [count](const Range &range) {
+        return range.count >= count;
+    });
+
+    if (it == region.freeRanges.end()) {
+        return std::nullopt;
+    }
+
+    auto offset = it->offset;
+
+    if (it->count == count) {
+        region.freeRanges.erase(it);
+    } else {
+        it->offset += count;
+        it->count -= count;
+    }
+
+    return offset;
+}
+
+void GeometryPool::returnRange(Region &region, uint32_t offset, uint32_t count) {
+    auto it = std::lower_bound(region.freeRanges.begin(), region.freeRanges.end(), offset,
+                               [](const Range &range, uint32_t value) {
+                                   return range.offset < value;
+                               });
+
+    it = region.freeRanges.insert(it, Range{.offset = offset, .count = count});
+
+    if (auto next = std::next(it); next != region.freeRanges.end() && it->offset + it->count == next->offset) {
+        it->count += next->count;
+        region.freeRanges.erase(next);
+    }
+
+    if (it != region.freeRanges.begin()) {
+        if (auto prev = std::prev(it); prev->offset + prev->count == it->offset) {
+            prev->count += it->count;
+            region.freeRanges.erase(it);
+        }
+    }
+}
+
+void GeometryPool::grow(Region &region, uint32_t count) {
+    auto capacity = std::max(region.capacity * 2, region.capacity + count);
+    auto buffer = this->allocateRegionBuffer(region, capacity);
+
+    this->_log->info(GEOMETRY_POOL_TAG, fmt::format("Growing pool region from {0} to {1} elements",
+                                                    region.capacity, capacity));
+
+    this->execute([&region, &buffer](const vk::CommandBuffer &commandBuffer) {
+        auto copy = vk::BufferCopy()
+                .setSize(region.elementSize * region.capacity);
+
+        commandBuffer.copyBuffer(region.buffer->buffer, buffer->buffer, copy);
+    });
+
+    // frames in flight still read previous buffer
+    this->_allocator->freeBuffer(region.buffer);
+
+    this->returnRange(region, region.capacity, capacity - region.capacity);
+
+    region.buffer = buffer;
+    region.capacity = capacity;
+}
+
+uint32_t GeometryPool::allocate(Region &region, const void *data, uint32_t count) {
+    auto offset = this->tryTakeRange(region, count);
+
+    if (!offset.has_value()) {
+        this->grow(region, count);
+        offset = this->tryTakeRange(region, count);
+    }
+
+    auto size = region.elementSize * count;
+
+    auto stagingBuffer = this->_allocator->allocateBuffer(BufferRequirements{
+            .size = size,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc,
+            .memoryProperties = vk::MemoryPropertyFlagBits::eHostVisible |
+                                vk::MemoryPropertyFlagBits::eHostCoherent
+    }, true).lock();
+
+    std::memcpy(stagingBuffer->ptr.value(), data, size);
+
+    this->execute([&region, &stagingBuffer, &offset, size](const vk::CommandBuffer &commandBuffer) {
+        auto copy = vk::BufferCopy()
+                .setDstOffset(region.elementSize * offset.value())
+                .setSize(size);
+
+        commandBuffer.copyBuffer(stagingBuffer->buffer, region.buffer->buffer, copy);
+    });
+
+    this->_allocator->freeBuffer(stagingBuffer);
+
+    return offset.value();
+}
+
+GeometryPool::GeometryPool(const std::shared_ptr<Log> &log,
+                           const std::shared_ptr<VarCollection> &varCollection,
+                           const std::shared_ptr<CommandManager> &commandManager,
+                           const std::shared_ptr<GpuAllocator> &allocator,
+                           const std::shared_ptr<GpuTimeline> &timeline,
+                           const std::shared_ptr<DeletionQueue> &deletionQueue)
+        : _log(log),
+          _varCollection(varCollection),
+          _commandManager(commandManager),
+          _allocator(allocator),
+          _timeline(timeline),
+          _deletionQueue(deletionQueue) {
+    //
+}
+
+void GeometryPool::init() {
+    auto vertexCapacity = std::max(
+            this->_varCollection->getIntOrDefault(RENDERING_GEOMETRY_POOL_VERTEX_CAPACITY, 262144), 1);
+    auto indexCapacity = std::max(
+            this->_varCollection->getIntOrDefault(RENDERING_GEOMETRY_POOL_INDEX_CAPACITY, 1048576), 1);
+
+    this->_vertices = Region{
+            .usage = vk::BufferUsageFlagBits::eVertexBuffer,
+            .elementSize = sizeof(Vertex),
+            .capacity = static_cast<uint32_t>(vertexCapacity)
+    };
+
+    this->_indices = Region{
+            .usage = vk::BufferUsageFlagBits::eIndexBuffer,
+            .elementSize = sizeof(uint32_t),
+            .capacity = static_cast<uint32_t>(indexCapacity)
+    };
+
+    try {
+        for (auto region: {&this->_vertices, &this->_indices}) {
+            region->buffer = this->allocateRegionBuffer(*region, region->capacity);
+            region->freeRanges.push_back(Range{.offset = 0, .count = region->capacity});
+        }
+    } catch (const std::exception &error) {
+        this->_log->error(GEOMETRY_POOL_TAG, error);
+        throw EngineError("Failed to initialize geometry pool");
+    }
+}
+
+void GeometryPool::destroy() {
+    std::lock_guard lock(this->_mutex);
+
+    for (auto region: {&this->_vertices, &this->_indices}) {
+        this->_allocator->freeBuffer(region->buffer);
+
+        region->buffer = nullptr;
+        region->freeRanges.clear();
+    }
+}
+
+GeometryAllocation GeometryPool::allocate(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices) {
+    if (vertices.empty() || indices.empty()) {
+        throw EngineError("Attempt to allocate empty geometry");
+    }
+
+    std::lock_guard lock(this->_mutex);
+
+    auto vertexCount = static_cast<uint32_t>(vertices.size());
+    auto indexCount = static_cast<uint32_t>(indices.size());
+
+    auto vertexOffset = this->allocate(this->_vertices, vertices.data(), vertexCount);
+
+    uint32_t firstIndex;
+
+    try {
+        firstIndex = this->allocate(this->_indices, indices.data(), indexCount);
+    } catch (...) {
+        this->returnRange(this->_vertices, vertexOffset, vertexCount);
+        throw;
+    }
+
+    return GeometryAllocation{
+            .vertexOffset = static_cast<int32_t>(vertexOffset),
+            .vertexCount = vertexCount,
+            .firstIndex = firstIndex,
+            .indexCount = indexCount
+    };
+}
+
+void GeometryPool::free(const GeometryAllocation &allocation) {
+    this->_deletionQueue->push([this, allocation]() {
+        std::lock_guard lock(this->_mutex);
+
+        this->returnRange(this->_vertices, static_cast<uint32_t>(allocation.vertexOffset), allocation.vertexCount);
+        this->returnRange(this->_indices, allocation.firstIndex, allocation.indexCount);
+    });
+}
+
+vk::Buffer GeometryPool::getVertexBuffer() {
+    std::lock_guard lock(this->_mutex);
+
+    return this->_vertices.buffer->buffer;
+}
+
+vk::Buffer GeometryPool::getIndexBuffer() {
+    std::lock_guard lock(this->_mutex);
+
+    return this->_indices.buffer->buffer;
+}
@@ -0,0 +1,92 @@
+#ifndef RENDERING_GEOMETRYPOOL_HPP
+#define RENDERING_GEOMETRYPOOL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "src/Types/Vertex.hpp"
+
+class Log;
+class VarCollection;
+class CommandManager;
+class DeletionQueue;
+class GpuAllocator;
+class GpuTimeline;
+struct BufferView;
+
+struct GeometryAllocation {
+    int32_t vertexOffset;
+    uint32_t vertexCount;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+};
+
+// Vertices and indices of all meshes, kept in two shared buffers so draws of different meshes do not rebind them.
+// Ranges are sub-allocated first-fit; when no free range is large enough, buffer is grown and copied on GPU.
+class GeometryPool {
+private:
+    struct Range {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    struct Region {
+        vk::BufferUsageFlags usage;
+        vk::DeviceSize elementSize;
+        uint32_t capacity;
+        std::shared_ptr<BufferView> buffer;
+
+        // sorted by offset, adjacent ranges are merged
+        std::vector<Range> freeRanges;
+    };
+
+    std::shared_ptr<Log> _log;
+    std::shared_ptr<VarCollection> _varCollection;
+    std::shared_ptr<CommandManager> _commandManager;
+    std::shared_ptr<GpuAllocator> _allocator;
+    std::shared_ptr<GpuTimeline> _timeline;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
+
+    std::mutex _mutex;
+    Region _vertices;
+    Region _indices;
+
+    std::shared_ptr<BufferView> allocateRegionBuffer(const Region &region, uint32_t capacity);
+    void execute(const std::function<void(const vk::CommandBuffer &commandBuffer)> &record);
+
+    std::optional<uint32_t> tryTakeRange(Region &region, uint32_t count);
+    void returnRange(Region &region, uint32_t offset, uint32_t count);
+    void grow(Region &region, uint32_t count);
+
+    uint32_t allocate(Region &region, const void *data, uint32_t count);
+
+public:
+    GeometryPool(const std::shared_ptr<Log> &log,
+                 const std::shared_ptr<VarCollection> &varCollection,
+                 const std::shared_ptr<CommandManager> &commandManager,
+                 const std::shared_ptr<GpuAllocator> &allocator,
+                 const std::shared_ptr<GpuTimeline> &timeline,
+                 const std::shared_ptr<DeletionQueue> &deletionQueue);
+
+    void init();
+    void destroy();
+
+    // uploads geometry and blocks until it is available to GPU
+    [[nodiscard]] GeometryAllocation allocate(const std::vector<Vertex> &vertices,
+                                              const std::vector<uint32_t> &indices);
+
+    // ranges are reused after frames that could use them are retired
+    void free(const GeometryAllocation &allocation);
+
+    // buffers are replaced when pool grows, so they should be queried after all meshes of the frame are loaded
+    [[nodiscard]] vk::Buffer getVertexBuffer();
+    [[nodiscard]] vk::Buffer getIndexBuffer();
+};
+
+#endif // RENDERING_GEOMETRYPOOL_HPP
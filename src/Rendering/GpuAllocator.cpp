@@ -2,6 +2,7 @@
 
 #include "src/Engine/EngineError.hpp"
 #include "src/Engine/Log.hpp"
+#include "src/Rendering/DeletionQueue.hpp"
 #include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
 #include "src/Rendering/Proxies/PhysicalDeviceProxy.hpp"
 
@@ -166,14 +167,18 @@ std::shared_ptr<ImageView> GpuAllocator::createImageView(const GpuAllocator::Ima
 
 GpuAllocator::GpuAllocator(const std::shared_ptr<Log> &log,
                            const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
-                           const std::shared_ptr<LogicalDeviceProxy> &logicalDevice)
+                           const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                           const std::shared_ptr<DeletionQueue> &deletionQueue)
         : _log(log),
           _physicalDevice(physicalDevice),
-          _logicalDevice(logicalDevice) {
+          _logicalDevice(logicalDevice),
+          _deletionQueue(deletionQueue) {
     //
 }
 
 std::weak_ptr<BufferView> GpuAllocator::allocateBuffer(const BufferRequirements &requirements, bool map) {
+    std::lock_guard lock(this->_mutex);
+
     auto allocation = this->createBufferAllocation(requirements);
     auto view = this->createBufferView(allocation);
 
@@ -190,6 +195,8 @@ std::weak_ptr<BufferView> GpuAllocator::allocateBuffer(const BufferRequirements
 }
 
 std::weak_ptr<ImageView> GpuAllocator::allocateImage(const ImageRequirements &requirements) {
+    std::lock_guard lock(this->_mutex);
+
     auto allocation = this->createImageAllocation(requirements);
     return this->createImageView(allocation);
 }
@@ -202,6 +209,8 @@ void GpuAllocator::freeBuffer(const std::weak_ptr<BufferView> &bufferView) {
 
     auto lockedBufferView = bufferView.lock();
 
+    std::lock_guard lock(this->_mutex);
+
     auto viewIt = std::find_if(this->_bufferViews.begin(), this->_bufferViews.end(),
                                [&lockedBufferView](const std::shared_ptr<BufferView> view) {
                                    return view->buffer == lockedBufferView->buffer;
@@ -224,8 +233,12 @@ void GpuAllocator::freeBuffer(const std::weak_ptr<BufferView> &bufferView) {
         return;
     }
 
-    this->freeBufferAllocation(*bufferIt);
+    auto allocation = *bufferIt;
     this->_buffers.erase(bufferIt);
+
+    this->_deletionQueue->push([this, allocation]() {
+        this->freeBufferAllocation(allocation);
+    });
 }
 
 void GpuAllocator::freeImage(const std::weak_ptr<ImageView> &imageView) {
@@ -236,6 +249,8 @@ void GpuAllocator::freeImage(const std::weak_ptr<ImageView> &imageView) {
 
     auto lockedImageView = imageView.lock();
 
+    std::lock_guard lock(this->_mutex);
+
     auto viewIt = std::find_if(this->_imageViews.begin(), this->_imageViews.end(),
                                [&lockedImageView](const std::shared_ptr<ImageView> view) {
                                    return view->image == lockedImageView->image;
@@ -258,11 +273,17 @@ void GpuAllocator::freeImage(const std::weak_ptr<ImageView> &imageView) {
         return;
     }
 
-    this->freeImageAllocation(*imageIt);
+    auto allocation = *imageIt;
     this->_images.erase(imageIt);
+
+    this->_deletionQueue->push([this, allocation]() {
+        this->freeImageAllocation(allocation);
+    });
 }
 
 void GpuAllocator::freeAll() {
+    std::lock_guard lock(this->_mutex);
+
     this->_bufferViews.clear();
     this->_imageViews.clear();
 
@@ -5,6 +5,7 @@
 #define RENDERING_GPUALLOCATOR_HPP
 
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -15,6 +16,7 @@
 #include "src/Rendering/Types/ImageView.hpp"
 
 class Log;
+class DeletionQueue;
 class LogicalDeviceProxy;
 class PhysicalDeviceProxy;
 
@@ -42,7 +44,9 @@ private:
     std::shared_ptr<Log> _log;
     std::shared_ptr<PhysicalDeviceProxy> _physicalDevice;
     std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
 
+    std::mutex _mutex;
     std::vector<BufferAllocation> _buffers;
     std::vector<std::shared_ptr<BufferView>> _bufferViews;
 
@@ -64,11 +68,13 @@ private:
 public:
     GpuAllocator(const std::shared_ptr<Log> &log,
                  const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
-                 const std::shared_ptr<LogicalDeviceProxy> &logicalDevice);
+                 const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                 const std::shared_ptr<DeletionQueue> &deletionQueue);
 
     [[nodiscard]] std::weak_ptr<BufferView> allocateBuffer(const BufferRequirements &requirements, bool map);
     [[nodiscard]] std::weak_ptr<ImageView> allocateImage(const ImageRequirements &requirements);
 
+    // views are invalidated immediately, memory is released after frames that could use it are retired
     void freeBuffer(const std::weak_ptr<BufferView> &bufferView);
     void freeImage(const std::weak_ptr<ImageView> &imageView);
 
@@ -12,11 +12,18 @@
 #include "src/Engine/VarCollection.hpp"
 #include "src/Engine/Vars.hpp"
 #include "src/Rendering/CommandManager.hpp"
+#include "src/Rendering/DeletionQueue.hpp"
+#include "src/Rendering/DescriptorAllocator.hpp"
 #include "src/Rendering/Extensions.hpp"
+#include "src/Rendering/GeometryPool.hpp"
 #include "src/Rendering/GpuAllocator.hpp"
 #include "src/Rendering/GpuResourceManager.hpp"
+#include "src/Rendering/GpuTimeline.hpp"
+#include "src/Rendering/PipelineCache.hpp"
+#include "src/Rendering/PipelineCompiler.hpp"
 #include "src/Rendering/SurfaceManager.hpp"
 #include "src/Rendering/SwapchainManager.hpp"
+#include "src/Rendering/TextureTable.hpp"
 #include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
 #include "src/Rendering/Proxies/PhysicalDeviceProxy.hpp"
 #include "src/System/Window.hpp"
@@ -37,8 +44,27 @@ std::vector<const char *> GpuManager::getRequiredInstanceExtensions() {
 }
 
 vk::PhysicalDeviceFeatures GpuManager::getEnabledFeatures() {
+    const auto &supportedFeatures = this->_physicalDevice->getSupportedFeatures();
+
     vk::PhysicalDeviceFeatures features = vk::PhysicalDeviceFeatures()
-            .setSamplerAnisotropy(true);
+            .setSamplerAnisotropy(true)
+            .setMultiDrawIndirect(supportedFeatures.multiDrawIndirect);
+
+    return features;
+}
+
+vk::PhysicalDeviceVulkan12Features GpuManager::getEnabledVulkan12Features() {
+    const auto &supportedFeatures = this->_physicalDevice->getSupportedVulkan12Features();
+
+    vk::PhysicalDeviceVulkan12Features features = vk::PhysicalDeviceVulkan12Features()
+            .setTimelineSemaphore(supportedFeatures.timelineSemaphore)
+            .setDrawIndirectCount(supportedFeatures.drawIndirectCount)
+            .setRuntimeDescriptorArray(supportedFeatures.runtimeDescriptorArray)
+            .setDescriptorBindingPartiallyBound(supportedFeatures.descriptorBindingPartiallyBound)
+            .setDescriptorBindingSampledImageUpdateAfterBind(
+                    supportedFeatures.descriptorBindingSampledImageUpdateAfterBind)
+            .setDescriptorBindingUpdateUnusedWhilePending(supportedFeatures.descriptorBindingUpdateUnusedWhilePending)
+            .setShaderSampledImageArrayNonUniformIndexing(supportedFeatures.shaderSampledImageArrayNonUniformIndexing);
 
     return features;
 }
@@ -126,7 +152,13 @@ void GpuManager::initPhysicalDevice() {
             continue;
         }
 
-        selectedPhysicalDevice = std::make_shared<PhysicalDeviceProxy>(physicalDevice, properties, supportInfo.value());
+        auto supportedVulkan12Features = PhysicalDeviceProxy::getSupportedVulkan12FeaturesFor(physicalDevice,
+                                                                                              properties);
+
+        selectedPhysicalDevice = std::make_shared<PhysicalDeviceProxy>(physicalDevice, properties,
+                                                                       physicalDevice.getFeatures(),
+                                                                       supportedVulkan12Features,
+                                                                       supportInfo.value());
 
         break;
     }
@@ -156,11 +188,15 @@ void GpuManager::initLogicalDevice() {
     }
 
     vk::PhysicalDeviceFeatures features = this->getEnabledFeatures();
+    vk::PhysicalDeviceVulkan12Features vulkan12Features = this->getEnabledVulkan12Features();
 
     auto requiredLayers = getRequiredLayersCStr();
     auto requiredDeviceExtensions = getRequiredDeviceExtensionsCStr();
 
     vk::DeviceCreateInfo createInfo = vk::DeviceCreateInfo()
+            .setPNext(this->_physicalDevice->getProperties().apiVersion >= VK_API_VERSION_1_2
+                      ? &vulkan12Features
+                      : nullptr)
             .setQueueCreateInfos(queueCreateInfos)
             .setPEnabledFeatures(&features)
             .setPEnabledLayerNames(requiredLayers)
@@ -173,6 +209,37 @@ void GpuManager::initLogicalDevice() {
     this->_logicalDevice = std::make_shared<LogicalDeviceProxy>(device, graphicsQueue, presentQueue);
 }
 
+void GpuManager::initTimeline() {
+    this->_timeline = std::make_shared<GpuTimeline>(this->_log,
+                                                    this->_physicalDevice,
+                                                    this->_logicalDevice);
+
+    this->_timeline->init();
+}
+
+void GpuManager::initDeletionQueue() {
+    this->_deletionQueue = std::make_shared<DeletionQueue>(this->_timeline);
+}
+
+void GpuManager::initPipelineCache() {
+    this->_pipelineCache = std::make_shared<PipelineCache>(this->_log,
+                                                           this->_varCollection,
+                                                           this->_physicalDevice,
+                                                           this->_logicalDevice);
+
+    this->_pipelineCache->init();
+}
+
+void GpuManager::initPipelineCompiler() {
+    this->_pipelineCompiler = std::make_shared<PipelineCompiler>(this->_log,
+                                                                 this->_varCollection,
+                                                                 this->_logicalDevice,
+                                                                 this->_pipelineCache,
+                                                                 this->_deletionQueue);
+
+    this->_pipelineCompiler->init();
+}
+
 void GpuManager::initCommandManager() {
     this->_commandManager = std::make_shared<CommandManager>(this->_log,
                                                              this->_physicalDevice,
@@ -181,10 +248,41 @@ void GpuManager::initCommandManager() {
     this->_commandManager->init();
 }
 
+void GpuManager::initDescriptorAllocator() {
+    this->_descriptorAllocator = std::make_shared<DescriptorAllocator>(this->_log,
+                                                                       this->_varCollection,
+                                                                       this->_logicalDevice,
+                                                                       this->_deletionQueue);
+
+    this->_descriptorAllocator->init();
+}
+
 void GpuManager::initAllocator() {
     this->_allocator = std::make_shared<GpuAllocator>(this->_log,
                                                       this->_physicalDevice,
-                                                      this->_logicalDevice);
+                                                      this->_logicalDevice,
+                                                      this->_deletionQueue);
+}
+
+void GpuManager::initGeometryPool() {
+    this->_geometryPool = std::make_shared<GeometryPool>(this->_log,
+                                                         this->_varCollection,
+                                                         this->_commandManager,
+                                                         this->_allocator,
+                                                         this->_timeline,
+                                                         this->_deletionQueue);
+
+    this->_geometryPool->init();
+}
+
+void GpuManager::initTextureTable() {
+    this->_textureTable = std::make_shared<TextureTable>(this->_log,
+                                                         this->_varCollection,
+                                                         this->_physicalDevice,
+                                                         this->_logicalDevice,
+                                                         this->_deletionQueue);
+
+    this->_textureTable->init();
 }
 
 void GpuManager::initResourceManager() {
@@ -194,7 +292,9 @@ void GpuManager::initResourceManager() {
                                                                   this->_resourceLoader,
                                                                   this->_commandManager,
                                                                   this->_allocator,
-                                                                  this->_logicalDevice);
+                                                                  this->_geometryPool,
+                                                                  this->_textureTable,
+                                                                  this->_timeline);
 
     this->_resourceManager->init();
 }
@@ -205,7 +305,8 @@ void GpuManager::initSwapchainManager() {
                                                                  this->_eventQueue,
                                                                  this->_surfaceManager,
                                                                  this->_physicalDevice,
-                                                                 this->_logicalDevice);
+                                                                 this->_logicalDevice,
+                                                                 this->_deletionQueue);
 
     this->_swapchainManager->init();
 }
@@ -262,8 +363,15 @@ void GpuManager::init() {
     this->initSurfaceManager();
     this->initPhysicalDevice();
     this->initLogicalDevice();
+    this->initTimeline();
+    this->initDeletionQueue();
+    this->initPipelineCache();
+    this->initPipelineCompiler();
     this->initCommandManager();
+    this->initDescriptorAllocator();
     this->initAllocator();
+    this->initGeometryPool();
+    this->initTextureTable();
     this->initResourceManager();
     this->initSwapchainManager();
 }
@@ -273,8 +381,15 @@ void GpuManager::destroy() {
 
     this->_swapchainManager->destroy();
     this->_resourceManager->freeAll();
+    this->_geometryPool->destroy();
+    this->_deletionQueue->flush();
+    this->_textureTable->destroy();
+    this->_descriptorAllocator->destroy();
     this->_allocator->freeAll();
     this->_commandManager->destroy();
+    this->_pipelineCompiler->destroy();
+    this->_pipelineCache->destroy();
+    this->_timeline->destroy();
     this->_logicalDevice->destroy();
     this->_physicalDevice = nullptr;
     this->_surfaceManager->destroy();
@@ -14,10 +14,17 @@ class ResourceLoader;
 class Window;
 
 class CommandManager;
+class DeletionQueue;
+class DescriptorAllocator;
+class GeometryPool;
 class GpuAllocator;
 class GpuResourceManager;
+class GpuTimeline;
+class PipelineCache;
+class PipelineCompiler;
 class SurfaceManager;
 class SwapchainManager;
+class TextureTable;
 class LogicalDeviceProxy;
 class PhysicalDeviceProxy;
 
@@ -35,20 +42,35 @@ private:
     vk::SurfaceKHR _surface;
     std::shared_ptr<PhysicalDeviceProxy> _physicalDevice;
     std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+    std::shared_ptr<GpuTimeline> _timeline;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
+    std::shared_ptr<PipelineCache> _pipelineCache;
+    std::shared_ptr<PipelineCompiler> _pipelineCompiler;
     std::shared_ptr<CommandManager> _commandManager;
+    std::shared_ptr<DescriptorAllocator> _descriptorAllocator;
     std::shared_ptr<GpuAllocator> _allocator;
+    std::shared_ptr<GeometryPool> _geometryPool;
+    std::shared_ptr<TextureTable> _textureTable;
     std::shared_ptr<GpuResourceManager> _resourceManager;
     std::shared_ptr<SwapchainManager> _swapchainManager;
 
     std::vector<const char *> getRequiredInstanceExtensions();
     vk::PhysicalDeviceFeatures getEnabledFeatures();
+    vk::PhysicalDeviceVulkan12Features getEnabledVulkan12Features();
 
     void initInstance();
     void initSurfaceManager();
     void initPhysicalDevice();
     void initLogicalDevice();
+    void initTimeline();
+    void initDeletionQueue();
+    void initPipelineCache();
+    void initPipelineCompiler();
     void initCommandManager();
+    void initDescriptorAllocator();
     void initAllocator();
+    void initGeometryPool();
+    void initTextureTable();
     void initResourceManager();
     void initSwapchainManager();
 
@@ -76,10 +98,26 @@ public:
 
     [[nodiscard]] std::weak_ptr<LogicalDeviceProxy> getLogicalDeviceProxy() const { return this->_logicalDevice; }
 
+    [[nodiscard]] std::weak_ptr<GpuTimeline> getTimeline() const { return this->_timeline; }
+
+    [[nodiscard]] std::weak_ptr<DeletionQueue> getDeletionQueue() const { return this->_deletionQueue; }
+
+    [[nodiscard]] std::weak_ptr<PipelineCache> getPipelineCache() const { return this->_pipelineCache; }
+
+    [[nodiscard]] std::weak_ptr<PipelineCompiler> getPipelineCompiler() const { return this->_pipelineCompiler; }
+
     [[nodiscard]] std::weak_ptr<CommandManager> getCommandManager() const { return this->_commandManager; }
 
+    [[nodiscard]] std::weak_ptr<DescriptorAllocator> getDescriptorAllocator() const {
+        return this->_descriptorAllocator;
+    }
+
     [[nodiscard]] std::weak_ptr<GpuAllocator> getAllocator() const { return this->_allocator; }
 
+    [[nodiscard]] std::weak_ptr<GeometryPool> getGeometryPool() const { return this->_geometryPool; }
+
+    [[nodiscard]] std::weak_ptr<TextureTable> getTextureTable() const { return this->_textureTable; }
+
     [[nodiscard]] std::weak_ptr<GpuResourceManager> getResourceManager() const { return this->_resourceManager; }
 
     [[nodiscard]] std::weak_ptr<SwapchainManager> getSwapchainManager() const { return this->_swapchainManager; }
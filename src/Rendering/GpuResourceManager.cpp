@@ -8,9 +8,10 @@
 #include "src/Engine/Log.hpp"
 #include "src/Events/EventQueue.hpp"
 #include "src/Rendering/CommandManager.hpp"
+#include "src/Rendering/GeometryPool.hpp"
 #include "src/Rendering/GpuAllocator.hpp"
-#include "src/Rendering/Proxies/CommandBufferProxy.hpp"
-#include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
+#include "src/Rendering/GpuTimeline.hpp"
+#include "src/Rendering/TextureTable.hpp"
 #include "src/Resources/Resource.hpp"
 #include "src/Resources/ResourceDatabase.hpp"
 #include "src/Resources/ResourceLoader.hpp"
@@ -19,64 +20,9 @@
 
 static constexpr std::string_view GPU_RESOURCE_MANAGER_TAG = "GpuResourceManager";
 
-template<typename T>
-std::weak_ptr<BufferView> uploadBuffer(const std::shared_ptr<CommandManager> &commandManager,
-                                       const std::shared_ptr<GpuAllocator> &allocator,
-                                       const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
-                                       const std::vector<T> &data,
-                                       vk::BufferUsageFlags targetUsage) {
-    vk::DeviceSize size = sizeof(T) * data.size();
-
-    BufferRequirements stagingBufferRequirements = {
-            .size = size,
-            .usage = vk::BufferUsageFlagBits::eTransferSrc,
-            .memoryProperties = vk::MemoryPropertyFlagBits::eHostVisible |
-                                vk::MemoryPropertyFlagBits::eHostCoherent
-    };
-
-    auto stagingBufferView = allocator->allocateBuffer(stagingBufferRequirements, true).lock();
-
-    BufferRequirements resultBufferRequirements = {
-            .size = size,
-            .usage = vk::BufferUsageFlagBits::eTransferDst | targetUsage,
-            .memoryProperties = vk::MemoryPropertyFlagBits::eDeviceLocal
-    };
-
-    auto targetBufferView = allocator->allocateBuffer(resultBufferRequirements, true).lock();
-
-    auto commandBuffer = commandManager->createPrimaryBuffer();
-
-    auto beginInfo = vk::CommandBufferBeginInfo()
-            .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-
-    commandBuffer->getHandle().begin(beginInfo);
-
-    auto bufferCopy = vk::BufferCopy()
-            .setSize(size);
-
-    commandBuffer->getHandle().copyBuffer(stagingBufferView->buffer,
-                                          targetBufferView->buffer,
-                                          {bufferCopy});
-
-    commandBuffer->getHandle().end();
-
-    auto commandBuffers = {commandBuffer->getHandle()};
-    auto submit = vk::SubmitInfo()
-            .setCommandBuffers(commandBuffers);
-
-    logicalDevice->getGraphicsQueue().submit({submit});
-    logicalDevice->getGraphicsQueue().waitIdle();
-
-    commandBuffer->destroy();
-
-    allocator->freeBuffer(stagingBufferView);
-
-    return targetBufferView;
-}
-
 std::weak_ptr<ImageView> uploadImage(const std::shared_ptr<CommandManager> &commandManager,
                                      const std::shared_ptr<GpuAllocator> &allocator,
-                                     const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                                     const std::shared_ptr<GpuTimeline> &timeline,
                                      const std::unique_ptr<ImageData> &imageData) {
     vk::Extent3D extent = vk::Extent3D(imageData->width, imageData->height, 1);
 
@@ -99,12 +45,13 @@ std::weak_ptr<ImageView> uploadImage(const std::shared_ptr<CommandManager> &comm
 
     auto imageView = allocator->allocateImage(imageRequirements).lock();
 
-    auto commandBuffer = commandManager->createPrimaryBuffer();
+    auto oneShotBuffer = commandManager->acquireOneShotBuffer();
+    auto commandBuffer = oneShotBuffer.commandBuffer;
 
     auto beginInfo = vk::CommandBufferBeginInfo()
             .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 
-    commandBuffer->getHandle().begin(beginInfo);
+    commandBuffer.begin(beginInfo);
 
     auto memoryBarrier = vk::ImageMemoryBarrier()
             .setImage(imageView->image)
@@ -118,10 +65,10 @@ std::weak_ptr<ImageView> uploadImage(const std::shared_ptr<CommandManager> &comm
             .setOldLayout(vk::ImageLayout::eUndefined)
             .setNewLayout(vk::ImageLayout::eTransferDstOptimal);
 
-    commandBuffer->getHandle().pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
-                                               vk::PipelineStageFlagBits::eTransfer,
-                                               vk::DependencyFlags(),
-                                               {}, {}, {memoryBarrier});
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                                  vk::PipelineStageFlagBits::eTransfer,
+                                  vk::DependencyFlags(),
+                                  {}, {}, {memoryBarrier});
 
     auto bufferImageCopy = vk::BufferImageCopy()
             .setBufferRowLength(imageData->width)
@@ -131,10 +78,10 @@ std::weak_ptr<ImageView> uploadImage(const std::shared_ptr<CommandManager> &comm
                                          .setAspectMask(vk::ImageAspectFlagBits::eColor)
                                          .setLayerCount(1));
 
-    commandBuffer->getHandle().copyBufferToImage(stagingBufferView->buffer,
-                                                 imageView->image,
-                                                 vk::ImageLayout::eTransferDstOptimal,
-                                                 {bufferImageCopy});
+    commandBuffer.copyBufferToImage(stagingBufferView->buffer,
+                                    imageView->image,
+                                    vk::ImageLayout::eTransferDstOptimal,
+                                    {bufferImageCopy});
 
     memoryBarrier
             .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
@@ -142,21 +89,20 @@ std::weak_ptr<ImageView> uploadImage(const std::shared_ptr<CommandManager> &comm
             .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
             .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
 
-    commandBuffer->getHandle().pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
-                                               vk::PipelineStageFlagBits::eFragmentShader,
-                                               vk::DependencyFlags(),
-                                               {}, {}, {memoryBarrier});
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                                  vk::PipelineStageFlagBits::eFragmentShader,
+                                  vk::DependencyFlags(),
+                                  {}, {}, {memoryBarrier});
 
-    commandBuffer->getHandle().end();
+    commandBuffer.end();
 
-    auto commandBuffers = {commandBuffer->getHandle()};
-    auto submit = vk::SubmitInfo()
-            .setCommandBuffers(commandBuffers);
+    auto value = timeline->submit(GpuSubmission{
+            .commandBuffers = {commandBuffer}
+    });
 
-    logicalDevice->getGraphicsQueue().submit({submit});
-    logicalDevice->getGraphicsQueue().waitIdle();
+    timeline->wait(value);
 
-    commandBuffer->destroy();
+    commandManager->releaseOneShotBuffer(oneShotBuffer);
 
     allocator->freeBuffer(stagingBufferView);
 
@@ -207,24 +153,35 @@ std::shared_ptr<Mesh> GpuResourceManager::loadMesh(const ResourceId &resourceId)
 
     this->_resourceLoader->freeResource(resourceId);
 
-    auto mesh = std::make_shared<Mesh>();
+    GeometryAllocation geometry;
 
     try {
-        mesh->vertexBuffer = uploadBuffer(this->_commandManager, this->_allocator, this->_logicalDevice,
-                                          meshData.value()->vertices, vk::BufferUsageFlagBits::eVertexBuffer);
-        mesh->indexBuffer = uploadBuffer(this->_commandManager, this->_allocator, this->_logicalDevice,
-                                         meshData.value()->indices, vk::BufferUsageFlagBits::eIndexBuffer);
+        geometry = this->_geometryPool->allocate(meshData.value()->vertices, meshData.value()->indices);
     } catch (const std::exception &error) {
         this->_log->error(GPU_RESOURCE_MANAGER_TAG, error);
         throw generalException();
     }
 
-    return mesh;
-}
-
-void GpuResourceManager::freeMesh(const std::shared_ptr<Mesh> &mesh) {
-    this->_allocator->freeBuffer(mesh->vertexBuffer);
-    this->_allocator->freeBuffer(mesh->indexBuffer);
+    // geometry is returned to pool by the last owner, which could be render thread releasing frame packet
+    auto geometryPool = this->_geometryPool;
+
+    return std::shared_ptr<Mesh>(new Mesh{
+            .vertexOffset = geometry.vertexOffset,
+            .vertexCount = geometry.vertexCount,
+            .firstIndex = geometry.firstIndex,
+            .indexCount = geometry.indexCount,
+            .boundsCenter = meshData.value()->boundsCenter,
+            .boundsRadius = meshData.value()->boundsRadius
+    }, [geometryPool](Mesh *mesh) {
+        geometryPool->free(GeometryAllocation{
+                .vertexOffset = mesh->vertexOffset,
+                .vertexCount = mesh->vertexCount,
+                .firstIndex = mesh->firstIndex,
+                .indexCount = mesh->indexCount
+        });
+
+        delete mesh;
+    });
 }
 
 std::weak_ptr<Texture> GpuResourceManager::getTexture(const ResourceId &resourceId) {
@@ -269,21 +226,45 @@ std::shared_ptr<Texture> GpuResourceManager::loadTexture(const ResourceId &resou
         throw generalException();
     }
 
-    auto texture = std::make_shared<Texture>();
+    std::weak_ptr<ImageView> image;
+    uint32_t tableIdx;
 
     try {
-        texture->image = uploadImage(this->_commandManager, this->_allocator, this->_logicalDevice,
-                                     imageData.value());
+        image = uploadImage(this->_commandManager, this->_allocator, this->_timeline, imageData.value());
     } catch (const std::exception &error) {
         this->_log->error(GPU_RESOURCE_MANAGER_TAG, error);
         throw generalException();
     }
 
-    return texture;
+    try {
+        tableIdx = this->_textureTable->add(image.lock()->imageView);
+    } catch (const std::exception &error) {
+        this->_log->error(GPU_RESOURCE_MANAGER_TAG, error);
+        this->_allocator->freeImage(image);
+        throw generalException();
+    }
+
+    // both table slot and image are released with deferral, after frames sampling them are retired
+    auto textureTable = this->_textureTable;
+    auto allocator = this->_allocator;
+
+    return std::shared_ptr<Texture>(new Texture{
+            .image = image,
+            .tableIdx = tableIdx
+    }, [textureTable, allocator](Texture *texture) {
+        textureTable->remove(texture->tableIdx);
+        allocator->freeImage(texture->image);
+
+        delete texture;
+    });
 }
 
-void GpuResourceManager::freeTexture(const std::shared_ptr<Texture> &texture) {
-    this->_allocator->freeImage(texture->image);
+bool GpuResourceManager::tryErase(const ResourceId &resourceId) {
+    if (this->_meshes.erase(resourceId) > 0) {
+        return true;
+    }
+
+    return this->_textures.erase(resourceId) > 0;
 }
 
 GpuResourceManager::GpuResourceManager(const std::shared_ptr<Log> &log,
@@ -292,14 +273,18 @@ GpuResourceManager::GpuResourceManager(const std::shared_ptr<Log> &log,
                                        const std::shared_ptr<ResourceLoader> resourceLoader,
                                        const std::shared_ptr<CommandManager> &commandManager,
                                        const std::shared_ptr<GpuAllocator> &allocator,
-                                       const std::shared_ptr<LogicalDeviceProxy> &logicalDevice)
+                                       const std::shared_ptr<GeometryPool> &geometryPool,
+                                       const std::shared_ptr<TextureTable> &textureTable,
+                                       const std::shared_ptr<GpuTimeline> &timeline)
         : _log(log),
           _eventQueue(eventQueue),
           _resourceDatabase(resourceDatabase),
           _resourceLoader(resourceLoader),
           _commandManager(commandManager),
           _allocator(allocator),
-          _logicalDevice(logicalDevice),
+          _geometryPool(geometryPool),
+          _textureTable(textureTable),
+          _timeline(timeline),
           _imageReader(std::make_shared<ImageReader>(this->_log)),
           _meshReader(std::make_shared<MeshReader>(this->_log)) {
     //
@@ -313,12 +298,9 @@ void GpuResourceManager::init() {
 
         auto resourceId = std::get<ResourceId>(event.value);
 
-        auto meshIt = this->_meshes.find(resourceId);
-
-        if (meshIt != this->_meshes.end()) {
-            this->freeMesh(meshIt->second);
-            return;
-        }
+        // replaced resource could be fixed, so its load is tried again
+        this->_failedResources.erase(resourceId);
+        this->tryErase(resourceId);
     });
 }
 
@@ -329,37 +311,39 @@ void GpuResourceManager::destroy() {
 }
 
 std::optional<std::weak_ptr<Mesh>> GpuResourceManager::tryGetMesh(const ResourceId &resourceId) {
+    if (this->_failedResources.contains(resourceId)) {
+        return std::nullopt;
+    }
+
     try {
         return this->getMesh(resourceId);
     } catch (const std::exception &error) {
         this->_log->error(GPU_RESOURCE_MANAGER_TAG, error);
+        this->_failedResources.insert(resourceId);
 
         return std::nullopt;
     }
 }
 
 std::optional<std::weak_ptr<Texture>> GpuResourceManager::tryGetTexture(const ResourceId &resourceId) {
+    if (this->_failedResources.contains(resourceId)) {
+        return std::nullopt;
+    }
+
     try {
         return this->getTexture(resourceId);
     } catch (const std::exception &error) {
         this->_log->error(GPU_RESOURCE_MANAGER_TAG, error);
+        this->_failedResources.insert(resourceId);
 
         return std::nullopt;
     }
 }
 
 void GpuResourceManager::free(const ResourceId &resourceId) {
-    auto meshIt = this->_meshes.find(resourceId);
+    this->_failedResources.erase(resourceId);
 
-    if (meshIt != this->_meshes.end()) {
-        this->freeMesh(meshIt->second);
-        return;
-    }
-
-    auto textureIt = this->_textures.find(resourceId);
-
-    if (textureIt != this->_textures.end()) {
-        this->freeTexture(textureIt->second);
+    if (this->tryErase(resourceId)) {
         return;
     }
 
@@ -367,9 +351,7 @@ void GpuResourceManager::free(const ResourceId &resourceId) {
 }
 
 void GpuResourceManager::freeAll() {
-    for (const auto &[id, mesh]: this->_meshes) {
-        this->freeMesh(mesh);
-    }
-
     this->_meshes.clear();
+    this->_textures.clear();
+    this->_failedResources.clear();
 }
@@ -4,6 +4,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 
 #include "src/Events/EventHandlerIdx.hpp"
 #include "src/Rendering/Types/Mesh.hpp"
@@ -18,9 +19,15 @@ class ImageReader;
 class MeshReader;
 
 class CommandManager;
+class GeometryPool;
 class GpuAllocator;
-class LogicalDeviceProxy;
+class GpuTimeline;
+class TextureTable;
 
+// Meshes and textures uploaded to GPU, loaded on first request. Used by main thread only: frame packets carry
+// resolved resources, so render thread never touches maps or resource loader. Resources are freed when their last
+// reference is dropped, so packets still in flight keep them alive. Failed loads are remembered and not retried
+// until resource is replaced.
 class GpuResourceManager {
 private:
     std::shared_ptr<Log> _log;
@@ -29,7 +36,9 @@ private:
     std::shared_ptr<ResourceLoader> _resourceLoader;
     std::shared_ptr<CommandManager> _commandManager;
     std::shared_ptr<GpuAllocator> _allocator;
-    std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+    std::shared_ptr<GeometryPool> _geometryPool;
+    std::shared_ptr<TextureTable> _textureTable;
+    std::shared_ptr<GpuTimeline> _timeline;
 
     std::shared_ptr<ImageReader> _imageReader;
     std::shared_ptr<MeshReader> _meshReader;
@@ -37,14 +46,15 @@ private:
     EventHandlerIdx _handlerIdx;
     std::map<ResourceId, std::shared_ptr<Mesh>> _meshes;
     std::map<ResourceId, std::shared_ptr<Texture>> _textures;
+    std::set<ResourceId> _failedResources;
 
     std::weak_ptr<Mesh> getMesh(const ResourceId &resourceId);
     std::shared_ptr<Mesh> loadMesh(const ResourceId &resourceId);
-    void freeMesh(const std::shared_ptr<Mesh> &mesh);
 
     std::weak_ptr<Texture> getTexture(const ResourceId &resourceId);
     std::shared_ptr<Texture> loadTexture(const ResourceId &resourceId);
-    void freeTexture(const std::shared_ptr<Texture> &texture);
+
+    bool tryErase(const ResourceId &resourceId);
 
 public:
     GpuResourceManager(const std::shared_ptr<Log> &log,
@@ -53,7 +63,9 @@ public:
                        const std::shared_ptr<ResourceLoader> resourceLoader,
                        const std::shared_ptr<CommandManager> &commandManager,
                        const std::shared_ptr<GpuAllocator> &allocator,
-                       const std::shared_ptr<LogicalDeviceProxy> &logicalDevice);
+                       const std::shared_ptr<GeometryPool> &geometryPool,
+                       const std::shared_ptr<TextureTable> &textureTable,
+                       const std::shared_ptr<GpuTimeline> &timeline);
 
     void init();
     void destroy();
@@ -0,0 +1,251 @@
+#include "GpuTimeline.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "src/Engine/EngineError.hpp"
+#include "src/Engine/Log.hpp"
+#include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
+#include "src/Rendering/Proxies/PhysicalDeviceProxy.hpp"
+
+static constexpr const char *GPU_TIMELINE_TAG = "GpuTimeline";
+
+static void advanceValue(std::atomic<uint64_t> &target, uint64_t value) {
+    uint64_t current = target.load();
+
+    while (current < value && !target.compare_exchange_weak(current, value)) {
+        //
+    }
+}
+
+vk::Fence GpuTimeline::acquireFence() {
+    if (this->_freeFences.empty()) {
+        return this->_logicalDevice->getHandle().createFence(vk::FenceCreateInfo());
+    }
+
+    auto fence = this->_freeFences.back();
+    this->_freeFences.pop_back();
+
+    return fence;
+}
+
+void GpuTimeline::collectFences() {
+    while (!this->_pendingFences.empty()) {
+        auto pending = this->_pendingFences.front();
+
+        if (this->_logicalDevice->getHandle().getFenceStatus(pending.fence) != vk::Result::eSuccess) {
+            break;
+        }
+
+        if (pending.waiters > 0) {
+            advanceValue(this->_completedValue, pending.value);
+            break;
+        }
+
+        this->_logicalDevice->getHandle().resetFences(pending.fence);
+        this->_freeFences.push_back(pending.fence);
+        this->_pendingFences.pop_front();
+
+        advanceValue(this->_completedValue, pending.value);
+    }
+}
+
+GpuTimeline::GpuTimeline(const std::shared_ptr<Log> &log,
+                         const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
+                         const std::shared_ptr<LogicalDeviceProxy> &logicalDevice)
+        : _log(log),
+          _physicalDevice(physicalDevice),
+          _logicalDevice(logicalDevice) {
+    //
+}
+
+void GpuTimeline::init() {
+    this->_timelineSupported = this->_physicalDevice->getSupportedVulkan12Features().timelineSemaphore;
+
+    if (!this->_timelineSupported) {
+        this->_log->warning(GPU_TIMELINE_TAG, "Timeline semaphores are not supported, falling back to fences");
+        return;
+    }
+
+    auto semaphoreTypeCreateInfo = vk::SemaphoreTypeCreateInfo()
+            .setSemaphoreType(vk::SemaphoreType::eTimeline)
+            .setInitialValue(0);
+
+    auto semaphoreCreateInfo = vk::SemaphoreCreateInfo()
+            .setPNext(&semaphoreTypeCreateInfo);
+
+    try {
+        this->_semaphore = this->_logicalDevice->getHandle().createSemaphore(semaphoreCreateInfo);
+    } catch (const std::exception &error) {
+        this->_log->error(GPU_TIMELINE_TAG, error);
+        throw EngineError("Failed to initialize GPU timeline");
+    }
+}
+
+void GpuTimeline::destroy() {
+    if (this->_timelineSupported) {
+        this->_logicalDevice->getHandle().destroy(this->_semaphore);
+    }
+
+    for (const auto &pending: this->_pendingFences) {
+        this->_logicalDevice->getHandle().destroy(pending.fence);
+    }
+
+    for (const auto &fence: this->_freeFences) {
+        this->_logicalDevice->getHandle().destroy(fence);
+    }
+
+    this->_pendingFences.clear();
+    this->_freeFences.clear();
+}
+
+uint64_t GpuTimeline::submit(const GpuSubmission &submission) {
+    std::lock_guard lock(this->_mutex);
+
+    uint64_t value = this->_lastSubmittedValue + 1;
+
+    auto submitInfo = vk::SubmitInfo()
+            .setCommandBuffers(submission.commandBuffers)
+            .setWaitSemaphores(submission.waitSemaphores)
+            .setWaitDstStageMask(submission.waitStages)
+            .setSignalSemaphores(submission.signalSemaphores);
+
+    if (this->_timelineSupported) {
+        auto signalSemaphores = submission.signalSemaphores;
+        signalSemaphores.push_back(this->_semaphore);
+
+        // values of binary semaphores are ignored
+        auto waitValues = std::vector<uint64_t>(submission.waitSemaphores.size(), 0);
+        auto signalValues = std::vector<uint64_t>(signalSemaphores.size(), 0);
+        signalValues.back() = value;
+
+        auto timelineSubmitInfo = vk::TimelineSemaphoreSubmitInfo()
+                .setWaitSemaphoreValues(waitValues)
+                .setSignalSemaphoreValues(signalValues);
+
+        submitInfo
+                .setPNext(&timelineSubmitInfo)
+                .setSignalSemaphores(signalSemaphores);
+
+        this->_logicalDevice->getGraphicsQueue().submit(submitInfo);
+    } else {
+        auto fence = this->acquireFence();
+
+        try {
+            this->_logicalDevice->getGraphicsQueue().submit(submitInfo, fence);
+        } catch (...) {
+            this->_freeFences.push_back(fence);
+            throw;
+        }
+
+        this->_pendingFences.push_back(PendingFence{
+                .value = value,
+                .fence = fence
+        });
+    }
+
+    this->_lastSubmittedValue = value;
+
+    return value;
+}
+
+vk::Result GpuTimeline::present(const vk::PresentInfoKHR &presentInfo) {
+    std::lock_guard lock(this->_mutex);
+
+    return this->_logicalDevice->getPresentQueue().presentKHR(presentInfo);
+}
+
+uint64_t GpuTimeline::getCompletedValue() {
+    if (this->_timelineSupported) {
+        advanceValue(this->_completedValue,
+                     this->_logicalDevice->getHandle().getSemaphoreCounterValue(this->_semaphore));
+    } else {
+        std::lock_guard lock(this->_mutex);
+        this->collectFences();
+    }
+
+    return this->_completedValue;
+}
+
+uint64_t GpuTimeline::getLastSubmittedValue() {
+    std::lock_guard lock(this->_mutex);
+
+    return this->_lastSubmittedValue;
+}
+
+bool GpuTimeline::isCompleted(uint64_t value) {
+    return value <= this->_completedValue || value <= this->getCompletedValue();
+}
+
+void GpuTimeline::wait(uint64_t value) {
+    if (value <= this->_completedValue) {
+        return;
+    }
+
+    if (value > this->getLastSubmittedValue()) {
+        throw EngineError("Attempt to wait for GPU timeline value that was never submitted");
+    }
+
+    if (this->_timelineSupported) {
+        auto waitInfo = vk::SemaphoreWaitInfo()
+                .setSemaphores(this->_semaphore)
+                .setValues(value);
+
+        if (this->_logicalDevice->getHandle().waitSemaphores(waitInfo, std::numeric_limits<uint64_t>::max()) ==
+            vk::Result::eTimeout) {
+            throw EngineError("GPU timeline wait timeout");
+        }
+
+        advanceValue(this->_completedValue, value);
+
+        return;
+    }
+
+    vk::Fence fence;
+
+    {
+        std::lock_guard lock(this->_mutex);
+
+        auto it = std::find_if(this->_pendingFences.begin(), this->_pendingFences.end(),
+                               [value](const PendingFence &pending) { return pending.value >= value; });
+
+        if (it == this->_pendingFences.end()) {
+            // fence was collected after completed value was checked
+            return;
+        }
+
+        fence = it->fence;
+        it->waiters++;
+    }
+
+    // lock is not held during wait, otherwise submissions from other threads would stall on it
+    auto result = this->_logicalDevice->getHandle().waitForFences(fence, true, std::numeric_limits<uint64_t>::max());
+
+    std::lock_guard lock(this->_mutex);
+
+    for (auto &pending: this->_pendingFences) {
+        if (pending.fence == fence) {
+            pending.waiters--;
+            break;
+        }
+    }
+
+    if (result == vk::Result::eTimeout) {
+        throw EngineError("GPU timeline wait timeout");
+    }
+
+    this->collectFences();
+}
+
+void GpuTimeline::waitIdle() {
+    std::lock_guard lock(this->_mutex);
+
+    this->_logicalDevice->getGraphicsQueue().waitIdle();
+    this->_logicalDevice->getPresentQueue().waitIdle();
+
+    advanceValue(this->_completedValue, this->_lastSubmittedValue);
+
+    if (!this->_timelineSupported) {
+        this->collectFences();
+    }
+}
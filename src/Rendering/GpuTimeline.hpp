@@ -0,0 +1,74 @@
+#ifndef RENDERING_GPUTIMELINE_HPP
+#define RENDERING_GPUTIMELINE_HPP
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+class Log;
+class LogicalDeviceProxy;
+class PhysicalDeviceProxy;
+
+struct GpuSubmission {
+    std::vector<vk::CommandBuffer> commandBuffers;
+    std::vector<vk::Semaphore> waitSemaphores;
+    std::vector<vk::PipelineStageFlags> waitStages;
+    std::vector<vk::Semaphore> signalSemaphores;
+};
+
+// Every submission to graphics queue signals next value of single monotonic timeline. Value N is completed when
+// GPU finished all work submitted up to N. Falls back to fence per submission if timeline semaphores are not
+// supported. Also serializes access to device queues.
+class GpuTimeline {
+private:
+    struct PendingFence {
+        uint64_t value;
+        vk::Fence fence;
+
+        // fence is waited outside of the lock, so it is not recycled while anyone waits for it
+        uint32_t waiters = 0;
+    };
+
+    std::shared_ptr<Log> _log;
+    std::shared_ptr<PhysicalDeviceProxy> _physicalDevice;
+    std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+
+    bool _timelineSupported = false;
+    vk::Semaphore _semaphore;
+
+    std::mutex _mutex;
+    uint64_t _lastSubmittedValue = 0;
+    std::atomic<uint64_t> _completedValue = 0;
+
+    std::deque<PendingFence> _pendingFences;
+    std::vector<vk::Fence> _freeFences;
+
+    vk::Fence acquireFence();
+    void collectFences();
+
+public:
+    GpuTimeline(const std::shared_ptr<Log> &log,
+                const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
+                const std::shared_ptr<LogicalDeviceProxy> &logicalDevice);
+
+    void init();
+    void destroy();
+
+    [[nodiscard]] uint64_t submit(const GpuSubmission &submission);
+    [[nodiscard]] vk::Result present(const vk::PresentInfoKHR &presentInfo);
+
+    [[nodiscard]] uint64_t getCompletedValue();
+    [[nodiscard]] uint64_t getLastSubmittedValue();
+
+    [[nodiscard]] bool isCompleted(uint64_t value);
+    void wait(uint64_t value);
+    void waitIdle();
+
+    [[nodiscard]] bool isTimelineSupported() const { return this->_timelineSupported; }
+};
+
+#endif // RENDERING_GPUTIMELINE_HPP
@@ -8,7 +8,8 @@ bool operator==(const RenderPass &lhs, const RenderPass &rhs) {
            lhs.dependencies == rhs.dependencies &&
            lhs.inputRefs == rhs.inputRefs &&
            lhs.colorRefs == rhs.colorRefs &&
-           lhs.depthRef == rhs.depthRef;
+           lhs.depthRef == rhs.depthRef &&
+           lhs.resolveRefs == rhs.resolveRefs;
 }
 
 bool operator==(const RenderAttachment &lhs, const RenderAttachment &rhs) {
@@ -38,6 +39,7 @@ bool operator==(const RenderTarget &lhs, const RenderTarget &rhs) {
     return lhs.type == rhs.type &&
            lhs.source == rhs.source &&
            lhs.format == rhs.format &&
+           lhs.samples == rhs.samples &&
            lhs.clearValue == rhs.clearValue;
 }
 
@@ -19,9 +19,19 @@ using RenderStageRef = std::string;
 enum class RenderTargetType {
     Input = 1 << 0,
     Color = 1 << 1,
-    DepthStencil = 1 << 2
+    DepthStencil = 1 << 2,
+    Sampled = 1 << 3
 };
 
+// target may serve several roles, e.g. G-buffer is written as color and then read as input attachment
+constexpr RenderTargetType operator|(RenderTargetType lhs, RenderTargetType rhs) {
+    return static_cast<RenderTargetType>(static_cast<int>(lhs) | static_cast<int>(rhs));
+}
+
+constexpr bool operator&(RenderTargetType lhs, RenderTargetType rhs) {
+    return (static_cast<int>(lhs) & static_cast<int>(rhs)) != 0;
+}
+
 enum class RenderTargetSource {
     Image,
     Swapchain
@@ -29,8 +39,18 @@ enum class RenderTargetSource {
 
 enum class RenderTargetFormat {
     DefaultColor,
+    HighPrecisionColor,
     DefaultDepth,
-    SwapchainColor
+    SwapchainColor,
+
+    // two channels for octahedral encoded normals
+    PackedNormal
+};
+
+// multisampled targets get sample count chosen for physical device, swapchain targets are always single sampled
+enum class RenderTargetSamples {
+    Single,
+    Multiple
 };
 
 struct RenderTargetClearValue {
@@ -43,6 +63,7 @@ struct RenderTarget {
     RenderTargetType type;
     RenderTargetSource source;
     RenderTargetFormat format;
+    RenderTargetSamples samples;
     RenderTargetClearValue clearValue;
 };
 
@@ -63,6 +84,10 @@ struct RenderPass {
     std::vector<RenderAttachmentRef> colorRefs;
     std::optional<RenderAttachmentRef> depthRef;
 
+    // either empty or one single sampled attachment for every color attachment, multisampled colors are resolved into
+    // them at the end of pass
+    std::vector<RenderAttachmentRef> resolveRefs;
+
     std::vector<RenderPassRef> dependencies;
 };
 
@@ -1,15 +1,21 @@
 #include "RenderGraphExecutor.hpp"
 
+#include <algorithm>
+#include <future>
 #include <queue>
+#include <set>
 #include <string_view>
 
 #include <fmt/core.h>
 
 #include "src/Engine/EngineError.hpp"
+#include "src/Engine/ThreadPool.hpp"
+#include "src/Rendering/DeletionQueue.hpp"
 #include "src/Rendering/GpuAllocator.hpp"
 #include "src/Rendering/Renderer.hpp"
 #include "src/Rendering/Swapchain.hpp"
 #include "src/Rendering/Graph/RenderStage.hpp"
+#include "src/Rendering/Types/RenderFrame.hpp"
 #include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
 
 vk::Format RenderGraphExecutor::processFormat(const RenderTargetFormat &format) {
@@ -17,21 +23,41 @@ vk::Format RenderGraphExecutor::processFormat(const RenderTargetFormat &format)
         case RenderTargetFormat::DefaultColor:
             return vk::Format::eR8G8B8A8Srgb;
 
+        case RenderTargetFormat::HighPrecisionColor:
+            return vk::Format::eR16G16B16A16Sfloat;
+
         case RenderTargetFormat::DefaultDepth:
             return vk::Format::eD32Sfloat;
 
         case RenderTargetFormat::SwapchainColor:
             return this->_swapchain->getColorFormat();
 
+        case RenderTargetFormat::PackedNormal:
+            return vk::Format::eR16G16Sfloat;
+
         default:
             throw EngineError("Unsupported image format");
     }
 }
 
+vk::SampleCountFlagBits RenderGraphExecutor::processSamples(const RenderTargetSamples &samples) {
+    switch (samples) {
+        case RenderTargetSamples::Single:
+            return vk::SampleCountFlagBits::e1;
+
+        case RenderTargetSamples::Multiple:
+            return this->_sampleCount;
+
+        default:
+            throw EngineError("Unsupported sample count");
+    }
+}
+
 vk::RenderPass RenderGraphExecutor::processSubgraphRenderpass(const RenderSubgraph &subgraph) {
     std::map<RenderPassRef, std::vector<vk::AttachmentReference>> inputAttachmentsMap;
     std::map<RenderPassRef, std::vector<vk::AttachmentReference>> colorAttachmentsMap;
     std::map<RenderPassRef, vk::AttachmentReference *> depthAttachmentsMap;
+    std::map<RenderPassRef, std::vector<vk::AttachmentReference>> resolveAttachmentsMap;
 
     auto attachments = std::vector<vk::AttachmentDescription>(subgraph.attachments.size());
     auto subpasses = std::vector<vk::SubpassDescription>(subgraph.passes.size());
@@ -44,9 +70,15 @@ vk::RenderPass RenderGraphExecutor::processSubgraphRenderpass(const RenderSubgra
             throw EngineError(fmt::format("Attachment {0}: unknown target {1}", attachmentRef, attachment.targetRef));
         }
 
+        if (targetIterator->second.source == RenderTargetSource::Swapchain &&
+            targetIterator->second.samples != RenderTargetSamples::Single) {
+            throw EngineError(fmt::format("Attachment {0}: swapchain target {1} could not be multisampled",
+                                          attachmentRef, attachment.targetRef));
+        }
+
         attachments[attachment.idx] = vk::AttachmentDescription()
                 .setFormat(this->processFormat(targetIterator->second.format))
-                .setSamples(vk::SampleCountFlagBits::e1)
+                .setSamples(this->processSamples(targetIterator->second.samples))
                 .setLoadOp(attachment.loadOp)
                 .setStoreOp(attachment.storeOp)
                 .setInitialLayout(attachment.initialLayout)
@@ -57,6 +89,7 @@ vk::RenderPass RenderGraphExecutor::processSubgraphRenderpass(const RenderSubgra
         inputAttachmentsMap[passRef] = std::vector<vk::AttachmentReference>();
         colorAttachmentsMap[passRef] = std::vector<vk::AttachmentReference>();
         depthAttachmentsMap[passRef] = nullptr;
+        resolveAttachmentsMap[passRef] = std::vector<vk::AttachmentReference>();
 
         for (const auto &inputRef: pass.inputRefs) {
             auto attachmentIterator = subgraph.attachments.find(inputRef);
@@ -92,21 +125,51 @@ vk::RenderPass RenderGraphExecutor::processSubgraphRenderpass(const RenderSubgra
                                                                        vk::ImageLayout::eDepthStencilAttachmentOptimal);
         }
 
+        if (!pass.resolveRefs.empty() && pass.resolveRefs.size() != pass.colorRefs.size()) {
+            throw EngineError(fmt::format("Pass {0}: {1} resolve attachments for {2} color attachments", passRef,
+                                          pass.resolveRefs.size(), pass.colorRefs.size()));
+        }
+
+        for (const auto &resolveRef: pass.resolveRefs) {
+            auto attachmentIterator = subgraph.attachments.find(resolveRef);
+
+            if (attachmentIterator == subgraph.attachments.end()) {
+                throw EngineError(fmt::format("Pass {0}: unknown resolve attachment {1}", passRef, resolveRef));
+            }
+
+            resolveAttachmentsMap[passRef].push_back(vk::AttachmentReference(attachmentIterator->second.idx,
+                                                                             vk::ImageLayout::eColorAttachmentOptimal));
+        }
+
+        // resolve attachments share count of color attachments, their setter would override it
         subpasses[pass.idx] = vk::SubpassDescription()
                 .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
                 .setInputAttachments(inputAttachmentsMap[passRef])
                 .setColorAttachments(colorAttachmentsMap[passRef])
+                .setPResolveAttachments(resolveAttachmentsMap[passRef].empty()
+                                        ? nullptr
+                                        : resolveAttachmentsMap[passRef].data())
                 .setPDepthStencilAttachment(depthAttachmentsMap[passRef]);
 
         if (pass.dependencies.empty()) {
+            // previous subgraph may have written the same targets, either as color or as depth, or targets this one
+            // samples
             auto dependency = vk::SubpassDependency()
                     .setSrcSubpass(VK_SUBPASS_EXTERNAL)
                     .setDstSubpass(pass.idx)
-                    .setSrcStageMask(vk::PipelineStageFlags())
-                    .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-                    .setSrcAccessMask(vk::AccessFlags())
-                    .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite |
-                                      vk::AccessFlagBits::eColorAttachmentRead);
+                    .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput |
+                                     vk::PipelineStageFlagBits::eLateFragmentTests)
+                    .setDstStageMask(vk::PipelineStageFlagBits::eFragmentShader |
+                                     vk::PipelineStageFlagBits::eColorAttachmentOutput |
+                                     vk::PipelineStageFlagBits::eEarlyFragmentTests |
+                                     vk::PipelineStageFlagBits::eLateFragmentTests)
+                    .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite |
+                                      vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+                    .setDstAccessMask(vk::AccessFlagBits::eShaderRead |
+                                      vk::AccessFlagBits::eColorAttachmentWrite |
+                                      vk::AccessFlagBits::eColorAttachmentRead |
+                                      vk::AccessFlagBits::eDepthStencilAttachmentWrite |
+                                      vk::AccessFlagBits::eDepthStencilAttachmentRead);
 
             dependencies.push_back(dependency);
         } else {
@@ -118,15 +181,24 @@ vk::RenderPass RenderGraphExecutor::processSubgraphRenderpass(const RenderSubgra
                                                   dependencyPassRef));
                 }
 
+                // dependent pass reads attachments of previous one at the same pixel only
                 auto dependency = vk::SubpassDependency()
                         .setSrcSubpass(dependencyPassIterator->second.idx)
                         .setDstSubpass(pass.idx)
-                        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-                        .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
+                        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput |
+                                         vk::PipelineStageFlagBits::eLateFragmentTests)
+                        .setDstStageMask(vk::PipelineStageFlagBits::eFragmentShader |
+                                         vk::PipelineStageFlagBits::eColorAttachmentOutput |
+                                         vk::PipelineStageFlagBits::eEarlyFragmentTests |
+                                         vk::PipelineStageFlagBits::eLateFragmentTests)
                         .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite |
-                                          vk::AccessFlagBits::eColorAttachmentRead)
-                        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite |
-                                          vk::AccessFlagBits::eColorAttachmentRead);
+                                          vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+                        .setDstAccessMask(vk::AccessFlagBits::eInputAttachmentRead |
+                                          vk::AccessFlagBits::eColorAttachmentWrite |
+                                          vk::AccessFlagBits::eColorAttachmentRead |
+                                          vk::AccessFlagBits::eDepthStencilAttachmentRead |
+                                          vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+                        .setDependencyFlags(vk::DependencyFlagBits::eByRegion);
 
                 dependencies.push_back(dependency);
             }
@@ -175,23 +247,27 @@ RenderGraphExecutor::FramebufferCollection RenderGraphExecutor::processSubgraphF
                 .extent = vk::Extent3D(this->_swapchain->getExtent(), 1),
                 .format = this->processFormat(target.format),
                 .layerCount = 1,
-                .samples = vk::SampleCountFlagBits::e1,
+                .samples = this->processSamples(target.samples),
                 .imageFlags = std::nullopt,
                 .type = vk::ImageViewType::e2D,
                 .aspectMask = std::nullopt
         };
 
-        if (target.type == RenderTargetType::Input) {
+        if (target.type & RenderTargetType::Input) {
             requirements.usage |= vk::ImageUsageFlagBits::eInputAttachment;
         }
 
-        if (target.type == RenderTargetType::Color) {
+        if (target.type & RenderTargetType::Sampled) {
+            requirements.usage |= vk::ImageUsageFlagBits::eSampled;
+        }
+
+        if (target.type & RenderTargetType::Color) {
             requirements.usage |= vk::ImageUsageFlagBits::eColorAttachment;
             requirements.aspectMask = requirements.aspectMask.value_or(vk::ImageAspectFlags()) |
                                       vk::ImageAspectFlagBits::eColor;
         }
 
-        if (target.type == RenderTargetType::DepthStencil) {
+        if (target.type & RenderTargetType::DepthStencil) {
             requirements.usage |= vk::ImageUsageFlagBits::eDepthStencilAttachment;
             requirements.aspectMask = requirements.aspectMask.value_or(vk::ImageAspectFlags()) |
                                       vk::ImageAspectFlagBits::eDepth;
@@ -235,6 +311,14 @@ RenderGraphExecutor::FramebufferCollection RenderGraphExecutor::processSubgraphF
     return framebuffers;
 }
 
+bool RenderGraphExecutor::isSwapchainDependent(const RenderSubgraph &subgraph) {
+    return std::any_of(subgraph.attachments.begin(), subgraph.attachments.end(),
+                       [this](const auto &entry) {
+                           return this->_graph.targets.at(entry.second.targetRef).source ==
+                                  RenderTargetSource::Swapchain;
+                       });
+}
+
 void RenderGraphExecutor::createFramebuffers() {
     for (const auto &[subgraphRef, subgraph]: this->_graph.subgraphs) {
         try {
@@ -246,33 +330,141 @@ void RenderGraphExecutor::createFramebuffers() {
     }
 }
 
-void RenderGraphExecutor::destroyFramebuffers() {
-    for (const auto &[subgraphRef, framebuffers]: this->_framebuffers) {
+void RenderGraphExecutor::retireFramebuffers(const FramebufferCollection &framebuffers) {
+    this->_deletionQueue->push([logicalDevice = this->_logicalDevice, framebuffers]() {
         for (const auto &framebuffer: framebuffers) {
-            this->_logicalDevice->getHandle().destroy(framebuffer);
+            logicalDevice->getHandle().destroy(framebuffer);
         }
+    });
+}
+
+void RenderGraphExecutor::destroyFramebuffers() {
+    for (const auto &[subgraphRef, framebuffers]: this->_framebuffers) {
+        this->retireFramebuffers(framebuffers);
     }
 
     this->_framebuffers.clear();
 }
 
-void RenderGraphExecutor::executeSubgraph(const RenderSubgraphRef &subgraphRef,
-                                          const RenderSubgraph &subgraph,
-                                          uint32_t imageIdx,
-                                          const vk::CommandBuffer &commandBuffer) {
+void RenderGraphExecutor::notifyTargetsUpdate() {
+    RenderTargetViews views;
+
+    for (const auto &[targetRef, image]: this->_images) {
+        views[targetRef] = image->imageView;
+    }
+
+    std::set<RenderStageRef> stageRefs;
+
+    for (const auto &[subgraphRef, subgraph]: this->_graph.subgraphs) {
+        if (stageRefs.insert(subgraph.stageRef).second) {
+            this->getStageFor(subgraph)->onTargetsUpdate(views);
+        }
+    }
+}
+
+void RenderGraphExecutor::freeImages() {
+    for (const auto &[targetRef, image]: this->_images) {
+        this->_gpuAllocator->freeImage(image);
+    }
+
+    this->_images.clear();
+}
+
+std::vector<RenderSubgraphRef> RenderGraphExecutor::getSubgraphQueue() {
+    std::vector<RenderSubgraphRef> subgraphRefs;
+
+    std::queue<RenderSubgraphRef> subgraphQueue;
+    subgraphQueue.push(this->_graph.firstSubgraph);
+
+    while (!subgraphQueue.empty()) {
+        auto subgraphRef = subgraphQueue.front();
+        subgraphQueue.pop();
+
+        subgraphRefs.push_back(subgraphRef);
+
+        for (const auto &nextSubgraphRef: this->_graph.subgraphs[subgraphRef].next) {
+            subgraphQueue.push(nextSubgraphRef);
+        }
+    }
+
+    return subgraphRefs;
+}
+
+std::vector<vk::ClearValue> RenderGraphExecutor::getClearValuesFor(const RenderSubgraph &subgraph) {
     auto clearValues = std::vector<vk::ClearValue>(subgraph.attachments.size());
+
     for (const auto &[attachmentRef, attachment]: subgraph.attachments) {
-        auto clearValue = this->_graph.targets[attachment.targetRef].clearValue;
+        const auto &target = this->_graph.targets[attachment.targetRef];
+
+        // clear value is an union, setting both would overwrite color with depth
+        if (target.type & RenderTargetType::DepthStencil) {
+            clearValues[attachment.idx] = vk::ClearValue()
+                    .setDepthStencil(vk::ClearDepthStencilValue(target.clearValue.depth, target.clearValue.stencil));
+        } else {
+            clearValues[attachment.idx] = vk::ClearValue()
+                    .setColor(vk::ClearColorValue(target.clearValue.rgba));
+        }
+    }
+
+    return clearValues;
+}
+
+vk::Extent2D RenderGraphExecutor::getRenderExtentFor(const RenderSubgraph &subgraph, const RenderFrame &frame) {
+    if (this->isSwapchainDependent(subgraph)) {
+        return this->_swapchain->getExtent();
+    }
+
+    // render area must stay inside of images, which are sized to swapchain extent
+    return vk::Extent2D(std::min(frame.renderExtent.width, this->_imagesExtent.width),
+                        std::min(frame.renderExtent.height, this->_imagesExtent.height));
+}
+
+std::shared_ptr<RenderStage> RenderGraphExecutor::getStageFor(const RenderSubgraph &subgraph) {
+    auto stage = this->_renderer->tryGetRenderStage(subgraph.stageRef);
+
+    if (!stage.has_value()) {
+        throw EngineError(fmt::format("Stage {0} not found", subgraph.stageRef));
+    }
+
+    return stage.value();
+}
+
+void RenderGraphExecutor::beginFrame(const std::vector<RenderSubgraphRef> &subgraphRefs, const RenderFrame &frame) {
+    std::set<RenderStageRef> stageRefs;
+
+    for (const auto &subgraphRef: subgraphRefs) {
+        const auto &subgraph = this->_graph.subgraphs[subgraphRef];
 
-        clearValues[attachment.idx] = vk::ClearValue()
-                .setColor(vk::ClearColorValue(clearValue.rgba))
-                .setDepthStencil(vk::ClearDepthStencilValue(clearValue.depth, clearValue.stencil));
+        if (stageRefs.insert(subgraph.stageRef).second) {
+            this->getStageFor(subgraph)->onFrameBegin(frame);
+        }
+    }
+}
+
+void RenderGraphExecutor::preExecute(const std::vector<RenderSubgraphRef> &subgraphRefs,
+                                     const vk::CommandBuffer &commandBuffer) {
+    std::set<RenderStageRef> stageRefs;
+
+    for (const auto &subgraphRef: subgraphRefs) {
+        const auto &subgraph = this->_graph.subgraphs[subgraphRef];
+
+        if (stageRefs.insert(subgraph.stageRef).second) {
+            this->getStageFor(subgraph)->onPreExecute(commandBuffer);
+        }
     }
+}
+
+void RenderGraphExecutor::executeSubgraph(const RenderSubgraphRef &subgraphRef,
+                                          const RenderSubgraph &subgraph,
+                                          const RenderFrame &frame,
+                                          uint32_t imageIdx,
+                                          const vk::CommandBuffer &commandBuffer) {
+    auto clearValues = this->getClearValuesFor(subgraph);
 
     auto beginInfo = vk::RenderPassBeginInfo()
             .setRenderPass(this->_renderpasses[subgraphRef])
             .setFramebuffer(this->_framebuffers[subgraphRef][imageIdx])
-            .setRenderArea(vk::Rect2D(0, this->_swapchain->getExtent()))
+            .setRenderArea(vk::Rect2D(0, this->getRenderExtentFor(subgraph, frame)))
             .setClearValues(clearValues);
 
     commandBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
@@ -291,13 +483,34 @@ void RenderGraphExecutor::executeSubgraph(const RenderSubgraphRef &subgraphRef,
             throw EngineError(fmt::format("Unknown pass {0}", subgraphRef));
         }
 
-        auto stage = this->_renderer->tryGetRenderStage(subgraph.stageRef);
+        this->getStageFor(subgraph)->onPassExecute(passRef, commandBuffer);
+    }
 
-        if (!stage.has_value()) {
-            throw EngineError(fmt::format("Stage {0} not found", subgraph.stageRef));
+    commandBuffer.endRenderPass();
+}
+
+void RenderGraphExecutor::executeRecordedSubgraph(const RenderSubgraphRef &subgraphRef,
+                                                  const RenderSubgraph &subgraph,
+                                                  const RenderFrame &frame,
+                                                  uint32_t imageIdx,
+                                                  const std::vector<PassRecording> &recordings,
+                                                  const vk::CommandBuffer &commandBuffer) {
+    auto clearValues = this->getClearValuesFor(subgraph);
+
+    auto beginInfo = vk::RenderPassBeginInfo()
+            .setRenderPass(this->_renderpasses[subgraphRef])
+            .setFramebuffer(this->_framebuffers[subgraphRef][imageIdx])
+            .setRenderArea(vk::Rect2D(0, this->getRenderExtentFor(subgraph, frame)))
+            .setClearValues(clearValues);
+
+    commandBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+
+    for (uint32_t passIdx = 0; passIdx < recordings.size(); passIdx++) {
+        if (passIdx != 0) {
+            commandBuffer.nextSubpass(vk::SubpassContents::eSecondaryCommandBuffers);
         }
 
-        stage.value()->onPassExecute(passRef, commandBuffer);
+        commandBuffer.executeCommands(recordings[passIdx]);
     }
 
     commandBuffer.endRenderPass();
@@ -305,14 +518,18 @@ void RenderGraphExecutor::executeSubgraph(const RenderSubgraphRef &subgraphRef,
 
 RenderGraphExecutor::RenderGraphExecutor(Renderer *renderer,
                                          const std::shared_ptr<GpuAllocator> &gpuAllocator,
+                                         const std::shared_ptr<DeletionQueue> &deletionQueue,
                                          const std::shared_ptr<Swapchain> &swapchain,
                                          const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
-                                         const RenderGraph &graph)
+                                         const RenderGraph &graph,
+                                         vk::SampleCountFlagBits sampleCount)
         : _renderer(renderer),
           _gpuAllocator(gpuAllocator),
+          _deletionQueue(deletionQueue),
           _swapchain(swapchain),
           _logicalDevice(logicalDevice),
-          _graph(graph) {
+          _graph(graph),
+          _sampleCount(sampleCount) {
     //
 }
 
@@ -332,13 +549,15 @@ void RenderGraphExecutor::create() {
             throw EngineError(fmt::format("Stage {0} not found", subgraph.stageRef));
         }
 
-        stage.value()->onGraphCreate(this->_swapchain, renderpass);
+        stage.value()->onGraphCreate(this->_swapchain, renderpass, this->_sampleCount);
 
         this->_renderpasses[subgraphRef] = renderpass;
         this->_executionOrders[subgraphRef] = this->processSubgraphExecutionOrder(subgraph);
     }
 
+    this->_imagesExtent = this->_swapchain->getExtent();
     this->createFramebuffers();
+    this->notifyTargetsUpdate();
 }
 
 void RenderGraphExecutor::destroy() {
@@ -354,31 +573,138 @@ void RenderGraphExecutor::destroy() {
 
         stage.value()->onGraphDestroy();
 
-        this->_logicalDevice->getHandle().destroy(renderpass);
+        this->_deletionQueue->push([logicalDevice = this->_logicalDevice, renderpass = renderpass]() {
+            logicalDevice->getHandle().destroy(renderpass);
+        });
     }
 
+    this->freeImages();
+
     this->_renderpasses.clear();
 }
 
 void RenderGraphExecutor::recreateFrameBuffers() {
-    this->destroyFramebuffers();
-    this->createFramebuffers();
+    bool extentChanged = this->_imagesExtent != this->_swapchain->getExtent();
+
+    // images are sized to swapchain extent, so they survive recreation that kept it
+    if (extentChanged) {
+        this->freeImages();
+        this->_imagesExtent = this->_swapchain->getExtent();
+    }
+
+    for (const auto &[subgraphRef, subgraph]: this->_graph.subgraphs) {
+        auto &framebuffers = this->_framebuffers[subgraphRef];
+
+        if (!extentChanged &&
+            !this->isSwapchainDependent(subgraph) &&
+            framebuffers.size() == this->_swapchain->getImageCount()) {
+            continue;
+        }
+
+        this->retireFramebuffers(framebuffers);
+        framebuffers.clear();
+
+        try {
+            framebuffers = this->processSubgraphFramebuffers(this->_renderpasses[subgraphRef], subgraph);
+        } catch (const std::exception &error) {
+            throw EngineError(fmt::format("Failed to create framebuffers for {0}: {1}", subgraphRef, error.what()));
+        }
+    }
+
+    if (extentChanged) {
+        this->notifyTargetsUpdate();
+    }
 }
 
-void RenderGraphExecutor::execute(uint32_t imageIdx, const vk::CommandBuffer &commandBuffer) {
-    std::queue<RenderSubgraphRef> subgraphQueue;
-    subgraphQueue.push(this->_graph.firstSubgraph);
+void RenderGraphExecutor::execute(const RenderFrame &frame,
+                                  uint32_t imageIdx,
+                                  const vk::CommandBuffer &commandBuffer) {
+    auto subgraphRefs = this->getSubgraphQueue();
 
-    while (!subgraphQueue.empty()) {
-        auto subgraphRef = subgraphQueue.front();
-        subgraphQueue.pop();
+    this->beginFrame(subgraphRefs, frame);
+    this->preExecute(subgraphRefs, commandBuffer);
 
-        auto subgraph = this->_graph.subgraphs[subgraphRef];
+    for (const auto &subgraphRef: subgraphRefs) {
+        this->executeSubgraph(subgraphRef, this->_graph.subgraphs[subgraphRef], frame, imageIdx, commandBuffer);
+    }
+}
+
+void RenderGraphExecutor::executeParallel(const RenderFrame &frame,
+                                          uint32_t imageIdx,
+                                          const vk::CommandBuffer &commandBuffer,
+                                          const std::shared_ptr<ThreadPool> &threadPool,
+                                          const SecondaryBufferProvider &secondaryBufferProvider) {
+    auto subgraphRefs = this->getSubgraphQueue();
 
-        this->executeSubgraph(subgraphRef, subgraph, imageIdx, commandBuffer);
+    this->beginFrame(subgraphRefs, frame);
 
-        for (const auto &nextSubgraphRef: subgraph.next) {
-            subgraphQueue.push(nextSubgraphRef);
+    // recordings are sized before any job is submitted, so workers never touch the containers themselves
+    std::map<RenderSubgraphRef, std::vector<PassRecording>> recordings;
+
+    for (const auto &subgraphRef: subgraphRefs) {
+        auto stage = this->getStageFor(this->_graph.subgraphs[subgraphRef]);
+        const auto &executionOrder = this->_executionOrders[subgraphRef];
+
+        auto &subgraphRecordings = recordings[subgraphRef];
+        subgraphRecordings = std::vector<PassRecording>(executionOrder.size());
+
+        for (uint32_t passIdx = 0; passIdx < executionOrder.size(); passIdx++) {
+            uint32_t chunkCount = std::max<uint32_t>(stage->getPassChunkCount(executionOrder[passIdx]), 1);
+            subgraphRecordings[passIdx] = PassRecording(chunkCount);
         }
     }
+
+    std::vector<std::future<void>> jobs;
+
+    for (const auto &subgraphRef: subgraphRefs) {
+        auto stage = this->getStageFor(this->_graph.subgraphs[subgraphRef]);
+        const auto &executionOrder = this->_executionOrders[subgraphRef];
+
+        auto renderpass = this->_renderpasses[subgraphRef];
+        auto framebuffer = this->_framebuffers[subgraphRef][imageIdx];
+
+        for (uint32_t passIdx = 0; passIdx < executionOrder.size(); passIdx++) {
+            auto &recording = recordings[subgraphRef][passIdx];
+            auto chunkCount = static_cast<uint32_t>(recording.size());
+
+            for (uint32_t chunkIdx = 0; chunkIdx < chunkCount; chunkIdx++) {
+                jobs.push_back(threadPool->submit([=, &recording, &executionOrder, &secondaryBufferProvider](
+                        uint32_t threadIdx) {
+                    auto secondaryBuffer = secondaryBufferProvider(threadIdx);
+
+                    auto inheritanceInfo = vk::CommandBufferInheritanceInfo()
+                            .setRenderPass(renderpass)
+                            .setSubpass(passIdx)
+                            .setFramebuffer(framebuffer);
+
+                    auto beginInfo = vk::CommandBufferBeginInfo()
+                            .setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue |
+                                      vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+                            .setPInheritanceInfo(&inheritanceInfo);
+
+                    secondaryBuffer.begin(beginInfo);
+                    stage->onPassChunkExecute(executionOrder[passIdx], chunkIdx, chunkCount, secondaryBuffer);
+                    secondaryBuffer.end();
+
+                    recording[chunkIdx] = secondaryBuffer;
+                }));
+            }
+        }
+    }
+
+    // every job must finish before recordings go out of scope, even if some of them failed
+    for (const auto &job: jobs) {
+        job.wait();
+    }
+
+    for (auto &job: jobs) {
+        job.get();
+    }
+
+    this->preExecute(subgraphRefs, commandBuffer);
+
+    for (const auto &subgraphRef: subgraphRefs) {
+        this->executeRecordedSubgraph(subgraphRef, this->_graph.subgraphs[subgraphRef], frame, imageIdx,
+                                      recordings[subgraphRef], commandBuffer);
+    }
 }
@@ -1,6 +1,7 @@
 #ifndef RENDERING_GRAPH_RENDERGRAPHEXECUTOR_HPP
 #define RENDERING_GRAPH_RENDERGRAPHEXECUTOR_HPP
 
+#include <functional>
 #include <map>
 #include <memory>
 
@@ -9,57 +10,99 @@
 #include "src/Rendering/Graph/RenderGraph.hpp"
 #include "src/Rendering/Types/ImageView.hpp"
 
+class ThreadPool;
+class DeletionQueue;
 class GpuAllocator;
 class Renderer;
 class Swapchain;
 class LogicalDeviceProxy;
+class RenderStage;
+struct RenderFrame;
+
+using SecondaryBufferProvider = std::function<vk::CommandBuffer(uint32_t threadIdx)>;
 
 class RenderGraphExecutor {
 private:
     using FramebufferCollection = std::vector<vk::Framebuffer>;
     using ExecutionOrder = std::vector<RenderPassRef>;
+    using PassRecording = std::vector<vk::CommandBuffer>;
 
     Renderer *_renderer;
     std::shared_ptr<GpuAllocator> _gpuAllocator;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
     std::shared_ptr<Swapchain> _swapchain;
     std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
 
     RenderGraph _graph;
+    vk::SampleCountFlagBits _sampleCount;
 
     std::map<RenderSubgraphRef, vk::RenderPass> _renderpasses;
     std::map<RenderSubgraphRef, ExecutionOrder> _executionOrders;
     std::map<RenderSubgraphRef, FramebufferCollection> _framebuffers;
 
     std::map<RenderTargetRef, std::shared_ptr<ImageView>> _images;
+    vk::Extent2D _imagesExtent;
 
     vk::Format processFormat(const RenderTargetFormat &format);
+    vk::SampleCountFlagBits processSamples(const RenderTargetSamples &samples);
 
     vk::RenderPass processSubgraphRenderpass(const RenderSubgraph &subgraph);
     ExecutionOrder processSubgraphExecutionOrder(const RenderSubgraph &subgraph);
     FramebufferCollection processSubgraphFramebuffers(const vk::RenderPass &renderpass,
                                                       const RenderSubgraph &subgraph);
 
+    bool isSwapchainDependent(const RenderSubgraph &subgraph);
+
     void createFramebuffers();
+    void retireFramebuffers(const FramebufferCollection &framebuffers);
     void destroyFramebuffers();
 
+    void notifyTargetsUpdate();
+    void freeImages();
+
+    std::vector<RenderSubgraphRef> getSubgraphQueue();
+    std::vector<vk::ClearValue> getClearValuesFor(const RenderSubgraph &subgraph);
+    vk::Extent2D getRenderExtentFor(const RenderSubgraph &subgraph, const RenderFrame &frame);
+    std::shared_ptr<RenderStage> getStageFor(const RenderSubgraph &subgraph);
+
+    void beginFrame(const std::vector<RenderSubgraphRef> &subgraphRefs, const RenderFrame &frame);
+    void preExecute(const std::vector<RenderSubgraphRef> &subgraphRefs, const vk::CommandBuffer &commandBuffer);
+
     void executeSubgraph(const RenderSubgraphRef &subgraphRef,
                          const RenderSubgraph &subgraph,
+                         const RenderFrame &frame,
                          uint32_t imageIdx,
                          const vk::CommandBuffer &commandBuffer);
+    void executeRecordedSubgraph(const RenderSubgraphRef &subgraphRef,
+                                 const RenderSubgraph &subgraph,
+                                 const RenderFrame &frame,
+                                 uint32_t imageIdx,
+                                 const std::vector<PassRecording> &recordings,
+                                 const vk::CommandBuffer &commandBuffer);
 
 public:
     RenderGraphExecutor(Renderer *renderer,
                         const std::shared_ptr<GpuAllocator> &gpuAllocator,
+                        const std::shared_ptr<DeletionQueue> &deletionQueue,
                         const std::shared_ptr<Swapchain> &swapchain,
                         const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
-                        const RenderGraph &graph);
+                        const RenderGraph &graph,
+                        vk::SampleCountFlagBits sampleCount);
 
     void create();
     void destroy();
 
+    // rebuilds only framebuffers and images affected by swapchain recreation
     void recreateFrameBuffers();
 
-    void execute(uint32_t imageIdx, const vk::CommandBuffer &commandBuffer);
+    void execute(const RenderFrame &frame,
+                 uint32_t imageIdx,
+                 const vk::CommandBuffer &commandBuffer);
+    void executeParallel(const RenderFrame &frame,
+                         uint32_t imageIdx,
+                         const vk::CommandBuffer &commandBuffer,
+                         const std::shared_ptr<ThreadPool> &threadPool,
+                         const SecondaryBufferProvider &secondaryBufferProvider);
 
     [[nodiscard]] const RenderGraph &getGraph() const { return this->_graph; }
 };
@@ -1,6 +1,7 @@
 #ifndef RENDERING_GRAPH_RENDERSTAGE_HPP
 #define RENDERING_GRAPH_RENDERSTAGE_HPP
 
+#include <map>
 #include <memory>
 
 #include <vulkan/vulkan.hpp>
@@ -8,6 +9,10 @@
 #include "src/Rendering/Graph/RenderGraph.hpp"
 
 class Swapchain;
+struct FramePacket;
+struct RenderFrame;
+
+using RenderTargetViews = std::map<RenderTargetRef, vk::ImageView>;
 
 class RenderStage {
 public:
@@ -16,13 +21,40 @@ public:
     virtual void init() = 0;
     virtual void destroy() = 0;
 
+    // called on render thread, pipelines should be requested from PipelineCompiler instead of being built here;
+    // sample count is the one of multisampled targets
     virtual void onGraphCreate(const std::shared_ptr<Swapchain> swapchain,
-                               const vk::RenderPass &renderPass) = 0;
+                               const vk::RenderPass &renderPass,
+                               vk::SampleCountFlagBits sampleCount) = 0;
     virtual void onGraphDestroy() = 0;
 
+    // called on render thread when images of graph targets were (re)allocated, stages reading targets outside of
+    // input attachments should rewrite their descriptors here
+    virtual void onTargetsUpdate(const RenderTargetViews &views) {}
+
+    // called on render thread for every packet in order, including packets that are not rendered, so stages could keep
+    // state that packets update by their changes
+    virtual void onPacket(const FramePacket &packet) {}
+
+    // called on render thread before any pass of the frame is recorded
+    virtual void onFrameBegin(const RenderFrame &frame) {}
+
+    // called on render thread after onFrameBegin, commands are recorded to primary buffer outside of any renderpass
+    virtual void onPreExecute(const vk::CommandBuffer &commandBuffer) {}
+
     virtual void onPassExecute(const RenderPassRef &passRef,
                                const vk::CommandBuffer &commandBuffer) = 0;
 
+    // number of secondary command buffers pass can be split into, chunks are recorded concurrently
+    [[nodiscard]] virtual uint32_t getPassChunkCount(const RenderPassRef &passRef) { return 1; }
+
+    virtual void onPassChunkExecute(const RenderPassRef &passRef,
+                                    uint32_t chunkIdx,
+                                    uint32_t chunkCount,
+                                    const vk::CommandBuffer &commandBuffer) {
+        this->onPassExecute(passRef, commandBuffer);
+    }
+
     virtual RenderSubgraph asSubgraph() = 0;
 };
 
@@ -0,0 +1,144 @@
+#include "PipelineCache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+#include <fmt/core.h>
+
+#include "src/Engine/EngineError.hpp"
+#include "src/Engine/Log.hpp"
+#include "src/Engine/VarCollection.hpp"
+#include "src/Engine/Vars.hpp"
+#include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
+#include "src/Rendering/Proxies/PhysicalDeviceProxy.hpp"
+
+static constexpr const std::string_view PIPELINE_CACHE_TAG = "PipelineCache";
+
+static constexpr const uint32_t PIPELINE_CACHE_MAGIC = 0x48435056; // "VPCH"
+static constexpr const uint32_t PIPELINE_CACHE_VERSION = 1;
+
+PipelineCache::FileHeader PipelineCache::makeHeader(uint64_t dataSize) {
+    const auto &properties = this->_physicalDevice->getProperties();
+
+    FileHeader header = {
+            .magic = PIPELINE_CACHE_MAGIC,
+            .version = PIPELINE_CACHE_VERSION,
+            .vendorId = properties.vendorID,
+            .deviceId = properties.deviceID,
+            .driverVersion = properties.driverVersion,
+            .dataSize = dataSize
+    };
+
+    std::memcpy(header.uuid, properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+
+    return header;
+}
+
+bool PipelineCache::isHeaderValid(const FileHeader &header) {
+    auto expected = this->makeHeader(header.dataSize);
+
+    return header.magic == expected.magic &&
+           header.version == expected.version &&
+           header.vendorId == expected.vendorId &&
+           header.deviceId == expected.deviceId &&
+           header.driverVersion == expected.driverVersion &&
+           std::memcmp(header.uuid, expected.uuid, VK_UUID_SIZE) == 0;
+}
+
+std::optional<std::vector<char>> PipelineCache::tryLoad(const std::string &path) {
+    std::ifstream stream = std::ifstream(path, std::ios::ate | std::ios::binary);
+
+    if (!stream.is_open()) {
+        this->_log->info(PIPELINE_CACHE_TAG, fmt::format("Pipeline cache {0} is not available", path));
+        return std::nullopt;
+    }
+
+    size_t size = stream.tellg();
+
+    if (size < sizeof(FileHeader)) {
+        this->_log->warning(PIPELINE_CACHE_TAG, fmt::format("Pipeline cache {0} is malformed, ignoring", path));
+        return std::nullopt;
+    }
+
+    FileHeader header;
+
+    stream.seekg(0);
+    stream.read(reinterpret_cast<char *>(&header), sizeof(FileHeader));
+
+    if (!this->isHeaderValid(header) || header.dataSize != size - sizeof(FileHeader)) {
+        this->_log->warning(PIPELINE_CACHE_TAG, fmt::format("Pipeline cache {0} was created for another device "
+                                                            "or driver, ignoring", path));
+        return std::nullopt;
+    }
+
+    std::vector<char> data(header.dataSize);
+    stream.read(data.data(), static_cast<std::streamsize>(data.size()));
+
+    if (!stream) {
+        this->_log->warning(PIPELINE_CACHE_TAG, fmt::format("Failed to read pipeline cache {0}, ignoring", path));
+        return std::nullopt;
+    }
+
+    return data;
+}
+
+void PipelineCache::trySave(const std::string &path) {
+    std::vector<uint8_t> data;
+
+    try {
+        data = this->_logicalDevice->getHandle().getPipelineCacheData(this->_pipelineCache);
+    } catch (const std::exception &error) {
+        this->_log->warning(PIPELINE_CACHE_TAG, error);
+        return;
+    }
+
+    auto header = this->makeHeader(data.size());
+
+    std::ofstream stream = std::ofstream(path, std::ios::binary | std::ios::trunc);
+
+    if (!stream.is_open()) {
+        this->_log->warning(PIPELINE_CACHE_TAG, fmt::format("Failed to write pipeline cache {0}", path));
+        return;
+    }
+
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(FileHeader));
+    stream.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+PipelineCache::PipelineCache(const std::shared_ptr<Log> &log,
+                             const std::shared_ptr<VarCollection> &varCollection,
+                             const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
+                             const std::shared_ptr<LogicalDeviceProxy> &logicalDevice)
+        : _log(log),
+          _varCollection(varCollection),
+          _physicalDevice(physicalDevice),
+          _logicalDevice(logicalDevice) {
+    //
+}
+
+void PipelineCache::init() {
+    auto path = this->_varCollection->getStringOrDefault(RENDERING_PIPELINE_CACHE_PATH, "pipeline.cache");
+    auto data = this->tryLoad(path);
+
+    auto createInfo = vk::PipelineCacheCreateInfo();
+
+    if (data.has_value()) {
+        createInfo.setInitialDataSize(data->size());
+        createInfo.setPInitialData(data->data());
+    }
+
+    try {
+        this->_pipelineCache = this->_logicalDevice->getHandle().createPipelineCache(createInfo);
+    } catch (const std::exception &error) {
+        this->_log->error(PIPELINE_CACHE_TAG, error);
+        throw EngineError("Failed to initialize pipeline cache");
+    }
+}
+
+void PipelineCache::destroy() {
+    auto path = this->_varCollection->getStringOrDefault(RENDERING_PIPELINE_CACHE_PATH, "pipeline.cache");
+    this->trySave(path);
+
+    this->_logicalDevice->getHandle().destroy(this->_pipelineCache);
+}
@@ -0,0 +1,55 @@
+#ifndef RENDERING_PIPELINECACHE_HPP
+#define RENDERING_PIPELINECACHE_HPP
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+class Log;
+class VarCollection;
+class LogicalDeviceProxy;
+class PhysicalDeviceProxy;
+
+// Pipeline cache shared by every pipeline creation. Cache data is persisted between runs, file is prefixed with
+// header that binds it to exact device and driver, mismatching file is ignored.
+class PipelineCache {
+private:
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vendorId;
+        uint32_t deviceId;
+        uint32_t driverVersion;
+        uint8_t uuid[VK_UUID_SIZE];
+        uint64_t dataSize;
+    };
+
+    std::shared_ptr<Log> _log;
+    std::shared_ptr<VarCollection> _varCollection;
+    std::shared_ptr<PhysicalDeviceProxy> _physicalDevice;
+    std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+
+    vk::PipelineCache _pipelineCache;
+
+    FileHeader makeHeader(uint64_t dataSize);
+    bool isHeaderValid(const FileHeader &header);
+
+    std::optional<std::vector<char>> tryLoad(const std::string &path);
+    void trySave(const std::string &path);
+
+public:
+    PipelineCache(const std::shared_ptr<Log> &log,
+                  const std::shared_ptr<VarCollection> &varCollection,
+                  const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
+                  const std::shared_ptr<LogicalDeviceProxy> &logicalDevice);
+
+    void init();
+    void destroy();
+
+    [[nodiscard]] const vk::PipelineCache &getHandle() const { return this->_pipelineCache; }
+};
+
+#endif // RENDERING_PIPELINECACHE_HPP
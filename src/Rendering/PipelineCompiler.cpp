@@ -0,0 +1,176 @@
+#include "PipelineCompiler.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <thread>
+
+#include <fmt/core.h>
+
+#include "src/Engine/EngineError.hpp"
+#include "src/Engine/Log.hpp"
+#include "src/Engine/ThreadPool.hpp"
+#include "src/Engine/VarCollection.hpp"
+#include "src/Engine/Vars.hpp"
+#include "src/Rendering/DeletionQueue.hpp"
+#include "src/Rendering/PipelineCache.hpp"
+#include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
+
+static constexpr const std::string_view PIPELINE_COMPILER_TAG = "PipelineCompiler";
+
+void PipelineCompiler::compile(PipelineKey key, const PipelineFactory &factory) {
+    auto generation = this->_nextGeneration++;
+
+    auto job = this->_threadPool->submit([this, key, factory, generation](uint32_t threadIdx) {
+        vk::Pipeline pipeline;
+
+        try {
+            pipeline = factory(this->_logicalDevice->getHandle(), this->_pipelineCache->getHandle());
+        } catch (const std::exception &error) {
+            this->_log->error(PIPELINE_COMPILER_TAG, error);
+
+            std::lock_guard lock(this->_mutex);
+
+            auto it = this->_entries.find(key);
+
+            if (it != this->_entries.end() && it->second.generation == generation) {
+                it->second.state = PipelineState::Failed;
+            }
+
+            return;
+        }
+
+        std::lock_guard lock(this->_mutex);
+
+        auto it = this->_entries.find(key);
+
+        // pipeline was released while it was compiled, GPU never saw it
+        if (it == this->_entries.end() || it->second.generation != generation) {
+            this->_logicalDevice->getHandle().destroy(pipeline);
+            return;
+        }
+
+        it->second.state = PipelineState::Ready;
+        it->second.pipeline = pipeline;
+    });
+
+    this->_entries[key] = Entry{
+            .state = PipelineState::Pending,
+            .pipeline = nullptr,
+            .job = job.share(),
+            .generation = generation
+    };
+}
+
+PipelineCompiler::PipelineCompiler(const std::shared_ptr<Log> &log,
+                                   const std::shared_ptr<VarCollection> &varCollection,
+                                   const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                                   const std::shared_ptr<PipelineCache> &pipelineCache,
+                                   const std::shared_ptr<DeletionQueue> &deletionQueue)
+        : _log(log),
+          _varCollection(varCollection),
+          _logicalDevice(logicalDevice),
+          _pipelineCache(pipelineCache),
+          _deletionQueue(deletionQueue) {
+    //
+}
+
+void PipelineCompiler::init() {
+    auto threadCount = this->_varCollection->getIntOrDefault(RENDERING_PIPELINE_COMPILER_THREAD_COUNT, 0);
+
+    if (threadCount <= 0) {
+        threadCount = static_cast<int32_t>(std::max(std::thread::hardware_concurrency() / 2, 1u));
+    }
+
+    this->_threadPool = std::make_shared<ThreadPool>(threadCount);
+    this->_threadPool->init();
+}
+
+void PipelineCompiler::destroy() {
+    // joins workers, so no job touches entries after this point
+    this->_threadPool->destroy();
+    this->_threadPool = nullptr;
+
+    for (const auto &[key, entry]: this->_entries) {
+        if (entry.state == PipelineState::Ready) {
+            this->_logicalDevice->getHandle().destroy(entry.pipeline);
+        }
+    }
+
+    this->_entries.clear();
+}
+
+std::optional<vk::Pipeline> PipelineCompiler::tryGetPipeline(PipelineKey key, const PipelineFactory &factory) {
+    std::lock_guard lock(this->_mutex);
+
+    auto it = this->_entries.find(key);
+
+    if (it == this->_entries.end()) {
+        this->compile(key, factory);
+        return std::nullopt;
+    }
+
+    if (it->second.state != PipelineState::Ready) {
+        return std::nullopt;
+    }
+
+    return it->second.pipeline;
+}
+
+vk::Pipeline PipelineCompiler::getPipeline(PipelineKey key, const PipelineFactory &factory) {
+    std::shared_future<void> job;
+
+    {
+        std::lock_guard lock(this->_mutex);
+
+        auto it = this->_entries.find(key);
+
+        if (it == this->_entries.end()) {
+            this->compile(key, factory);
+            it = this->_entries.find(key);
+        }
+
+        job = it->second.job;
+    }
+
+    job.wait();
+
+    std::lock_guard lock(this->_mutex);
+
+    auto it = this->_entries.find(key);
+
+    if (it == this->_entries.end() || it->second.state != PipelineState::Ready) {
+        throw EngineError(fmt::format("Pipeline {0} is not available", key));
+    }
+
+    return it->second.pipeline;
+}
+
+std::optional<PipelineState> PipelineCompiler::tryGetState(PipelineKey key) {
+    std::lock_guard lock(this->_mutex);
+
+    auto it = this->_entries.find(key);
+
+    if (it == this->_entries.end()) {
+        return std::nullopt;
+    }
+
+    return it->second.state;
+}
+
+void PipelineCompiler::release(PipelineKey key) {
+    std::lock_guard lock(this->_mutex);
+
+    auto it = this->_entries.find(key);
+
+    if (it == this->_entries.end()) {
+        return;
+    }
+
+    if (it->second.state == PipelineState::Ready) {
+        this->_deletionQueue->push([logicalDevice = this->_logicalDevice, pipeline = it->second.pipeline]() {
+            logicalDevice->getHandle().destroy(pipeline);
+        });
+    }
+
+    this->_entries.erase(it);
+}
@@ -0,0 +1,92 @@
+#ifndef RENDERING_PIPELINECOMPILER_HPP
+#define RENDERING_PIPELINECOMPILER_HPP
+
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include <vulkan/vulkan.hpp>
+
+class Log;
+class VarCollection;
+class ThreadPool;
+class DeletionQueue;
+class LogicalDeviceProxy;
+class PipelineCache;
+
+using PipelineKey = std::size_t;
+
+// executed on worker thread, so it should own everything referenced by create info
+using PipelineFactory = std::function<vk::Pipeline(const vk::Device &device, const vk::PipelineCache &pipelineCache)>;
+
+template<typename T>
+void hashCombine(PipelineKey &key, const T &value) {
+    key ^= std::hash<T>()(value) + 0x9e3779b9 + (key << 6) + (key >> 2);
+}
+
+template<typename... Args>
+PipelineKey makePipelineKey(const Args &... args) {
+    PipelineKey key = 0;
+    (hashCombine(key, args), ...);
+
+    return key;
+}
+
+enum class PipelineState {
+    Pending,
+    Ready,
+    Failed
+};
+
+// Compiles pipelines on worker threads. Stages request pipelines by key of their state and skip draws that
+// depend on pipeline that is still pending.
+class PipelineCompiler {
+private:
+    struct Entry {
+        PipelineState state;
+        vk::Pipeline pipeline;
+        std::shared_future<void> job;
+
+        // entry could be released and requested again while previous job is running, job publishes only to its own
+        uint64_t generation;
+    };
+
+    std::shared_ptr<Log> _log;
+    std::shared_ptr<VarCollection> _varCollection;
+    std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+    std::shared_ptr<PipelineCache> _pipelineCache;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
+
+    std::shared_ptr<ThreadPool> _threadPool;
+
+    std::mutex _mutex;
+    std::map<PipelineKey, Entry> _entries;
+    uint64_t _nextGeneration = 0;
+
+    void compile(PipelineKey key, const PipelineFactory &factory);
+
+public:
+    PipelineCompiler(const std::shared_ptr<Log> &log,
+                     const std::shared_ptr<VarCollection> &varCollection,
+                     const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                     const std::shared_ptr<PipelineCache> &pipelineCache,
+                     const std::shared_ptr<DeletionQueue> &deletionQueue);
+
+    void init();
+    void destroy();
+
+    // returns pipeline if it is compiled, otherwise schedules compilation and returns nothing
+    [[nodiscard]] std::optional<vk::Pipeline> tryGetPipeline(PipelineKey key, const PipelineFactory &factory);
+
+    // blocks until pipeline is compiled, for pipelines frame could not be drawn without
+    [[nodiscard]] vk::Pipeline getPipeline(PipelineKey key, const PipelineFactory &factory);
+
+    [[nodiscard]] std::optional<PipelineState> tryGetState(PipelineKey key);
+
+    void release(PipelineKey key);
+};
+
+#endif // RENDERING_PIPELINECOMPILER_HPP
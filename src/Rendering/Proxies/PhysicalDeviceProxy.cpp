@@ -4,14 +4,55 @@
 
 PhysicalDeviceProxy::PhysicalDeviceProxy(const vk::PhysicalDevice &handle,
                                          const vk::PhysicalDeviceProperties &properties,
+                                         const vk::PhysicalDeviceFeatures &supportedFeatures,
+                                         const vk::PhysicalDeviceVulkan12Features &supportedVulkan12Features,
                                          const PhysicalDeviceSupportInfo &supportInfo)
         : _handle(handle),
           _properties(properties),
+          _supportedFeatures(supportedFeatures),
+          _supportedVulkan12Features(supportedVulkan12Features),
           _graphicsQueueFamilyIdx(supportInfo.graphicsQueueFamilyIdx),
           _presentQueueFamilyIdx(supportInfo.presentQueueFamilyIdx) {
     //
 }
 
+vk::SampleCountFlagBits PhysicalDeviceProxy::getSampleCount(uint32_t requestedCount) const {
+    auto supportedCounts = this->_properties.limits.framebufferColorSampleCounts &
+                           this->_properties.limits.framebufferDepthSampleCounts;
+
+    auto counts = {
+            vk::SampleCountFlagBits::e64,
+            vk::SampleCountFlagBits::e32,
+            vk::SampleCountFlagBits::e16,
+            vk::SampleCountFlagBits::e8,
+            vk::SampleCountFlagBits::e4,
+            vk::SampleCountFlagBits::e2
+    };
+
+    for (const auto &count: counts) {
+        if (static_cast<uint32_t>(count) <= requestedCount && (supportedCounts & count)) {
+            return count;
+        }
+    }
+
+    return vk::SampleCountFlagBits::e1;
+}
+
+vk::PhysicalDeviceVulkan12Features PhysicalDeviceProxy::getSupportedVulkan12FeaturesFor(
+        const vk::PhysicalDevice &physicalDevice,
+        const vk::PhysicalDeviceProperties &properties) {
+    if (properties.apiVersion < VK_API_VERSION_1_2) {
+        return vk::PhysicalDeviceVulkan12Features();
+    }
+
+    auto features = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+
+    auto supportedFeatures = features.get<vk::PhysicalDeviceVulkan12Features>();
+    supportedFeatures.setPNext(nullptr);
+
+    return supportedFeatures;
+}
+
 std::optional<PhysicalDeviceSupportInfo> PhysicalDeviceProxy::getSupportInfoFor(
         const vk::PhysicalDevice &physicalDevice,
         const vk::SurfaceKHR &surface) {
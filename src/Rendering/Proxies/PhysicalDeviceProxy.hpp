@@ -14,22 +14,39 @@ class PhysicalDeviceProxy {
 private:
     vk::PhysicalDevice _handle;
     vk::PhysicalDeviceProperties _properties;
+    vk::PhysicalDeviceFeatures _supportedFeatures;
+    vk::PhysicalDeviceVulkan12Features _supportedVulkan12Features;
     uint32_t _graphicsQueueFamilyIdx;
     uint32_t _presentQueueFamilyIdx;
 
 public:
     PhysicalDeviceProxy(const vk::PhysicalDevice &handle,
                         const vk::PhysicalDeviceProperties &properties,
+                        const vk::PhysicalDeviceFeatures &supportedFeatures,
+                        const vk::PhysicalDeviceVulkan12Features &supportedVulkan12Features,
                         const PhysicalDeviceSupportInfo &supportInfo);
 
     [[nodiscard]] const vk::PhysicalDevice &getHandle() const { return this->_handle; }
 
     [[nodiscard]] const vk::PhysicalDeviceProperties &getProperties() const { return this->_properties; }
 
+    [[nodiscard]] const vk::PhysicalDeviceFeatures &getSupportedFeatures() const { return this->_supportedFeatures; }
+
+    [[nodiscard]] const vk::PhysicalDeviceVulkan12Features &getSupportedVulkan12Features() const {
+        return this->_supportedVulkan12Features;
+    }
+
     [[nodiscard]] const uint32_t &getGraphicsQueueFamilyIdx() const { return this->_graphicsQueueFamilyIdx; }
 
     [[nodiscard]] const uint32_t &getPresentQueueFamilyIdx() const { return this->_presentQueueFamilyIdx; }
 
+    // highest sample count usable by both color and depth attachments that does not exceed requested one
+    [[nodiscard]] vk::SampleCountFlagBits getSampleCount(uint32_t requestedCount) const;
+
+    [[nodiscard]] static vk::PhysicalDeviceVulkan12Features getSupportedVulkan12FeaturesFor(
+            const vk::PhysicalDevice &physicalDevice,
+            const vk::PhysicalDeviceProperties &properties);
+
     [[nodiscard]] static std::optional<PhysicalDeviceSupportInfo> getSupportInfoFor(
             const vk::PhysicalDevice &physicalDevice,
             const vk::SurfaceKHR &surface);
@@ -1,34 +1,189 @@
 #include "RenderThread.hpp"
 
-#include <limits>
+#include <algorithm>
 #include <string_view>
+#include <thread>
 
 #include "src/Engine/EngineError.hpp"
 #include "src/Engine/Log.hpp"
+#include "src/Engine/ThreadPool.hpp"
 #include "src/Engine/VarCollection.hpp"
 #include "src/Engine/Vars.hpp"
 #include "src/Rendering/CommandManager.hpp"
+#include "src/Rendering/DeletionQueue.hpp"
+#include "src/Rendering/DescriptorAllocator.hpp"
+#include "src/Rendering/FramePipeline.hpp"
+#include "src/Rendering/GpuTimeline.hpp"
 #include "src/Rendering/Renderer.hpp"
 #include "src/Rendering/Swapchain.hpp"
 #include "src/Rendering/Graph/RenderGraphExecutor.hpp"
-#include "src/Rendering/Proxies/CommandBufferProxy.hpp"
 #include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
+#include "src/Rendering/Proxies/PhysicalDeviceProxy.hpp"
+#include "src/Rendering/Types/RenderFrame.hpp"
 
 static constexpr const std::string_view RENDER_THREAD_TAG = "RenderThread";
 
-void RenderThread::render() {
+void RenderThread::initParallelRecording() {
+    if (!this->_varCollection->getBoolOrDefault(RENDERING_PARALLEL_RECORDING, false)) {
+        return;
+    }
+
+    auto threadCount = this->_varCollection->getIntOrDefault(RENDERING_RECORDING_THREAD_COUNT, 0);
+
+    if (threadCount <= 0) {
+        threadCount = static_cast<int32_t>(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    }
+
+    auto recordingPool = std::make_shared<ThreadPool>(threadCount);
+    recordingPool->init();
+
+    this->_recordingPool = recordingPool;
+}
+
+void RenderThread::destroyParallelRecording() {
+    if (!this->_recordingPool.has_value()) {
+        return;
+    }
+
+    this->_recordingPool.value()->destroy();
+    this->_recordingPool = std::nullopt;
+}
+
+void RenderThread::initFrameSyncs() {
+    this->_currentFrameIdx = 0;
+    this->_nextFrameTimelineValue = 0;
+
+    this->_frameSyncs = std::vector<FrameSync>(this->_inflightFrameCount);
+
+    auto semaphoreCreateInfo = vk::SemaphoreCreateInfo();
+
+    for (uint32_t frameIdx = 0; frameIdx < this->_inflightFrameCount; frameIdx++) {
+        this->_frameSyncs[frameIdx] = {
+                .imageAvailableSemaphore = this->_logicalDevice->getHandle().createSemaphore(semaphoreCreateInfo),
+                .renderFinishedSemaphore = this->_logicalDevice->getHandle().createSemaphore(semaphoreCreateInfo),
+                .timelineValue = 0,
+                .timestampsWritten = false
+        };
+    }
+
+    if (this->_dynamicResolution) {
+        auto queryPoolCreateInfo = vk::QueryPoolCreateInfo()
+                .setQueryType(vk::QueryType::eTimestamp)
+                .setQueryCount(2 * this->_inflightFrameCount);
+
+        this->_timestampQueryPool = this->_logicalDevice->getHandle().createQueryPool(queryPoolCreateInfo);
+    }
+
+    auto recordingThreadCount = this->_recordingPool.has_value()
+                                ? this->_recordingPool.value()->getThreadCount()
+                                : 0;
+
+    this->_commandManager->initFramePools(this->_inflightFrameCount, 1 + recordingThreadCount);
+    this->_descriptorAllocator->initFramePools(this->_inflightFrameCount);
+}
+
+void RenderThread::destroyFrameSyncs() {
+    this->_commandManager->destroyFramePools();
+    this->_descriptorAllocator->destroyFramePools();
+
+    for (const auto &frameSync: this->_frameSyncs) {
+        this->_logicalDevice->getHandle().destroy(frameSync.imageAvailableSemaphore);
+        this->_logicalDevice->getHandle().destroy(frameSync.renderFinishedSemaphore);
+    }
+
+    this->_frameSyncs.clear();
+
+    if (this->_timestampQueryPool) {
+        this->_logicalDevice->getHandle().destroy(this->_timestampQueryPool);
+        this->_timestampQueryPool = nullptr;
+    }
+}
+
+void RenderThread::applyPendingSettings() {
+    std::optional<RenderThreadSettings> settings;
+
+    {
+        std::lock_guard lock(this->_settingsMutex);
+        std::swap(settings, this->_pendingSettings);
+    }
+
+    if (!settings.has_value()) {
+        return;
+    }
+
+    this->_swapchain->setPresentMode(settings->presentMode);
+
+    auto inflightFrameCount = std::max<uint32_t>(settings->inflightFrameCount, 1);
+
+    if (inflightFrameCount == this->_inflightFrameCount) {
+        return;
+    }
+
+    // semaphores could still be waited by presentation engine, so both queues have to be drained
+    this->_timeline->waitIdle();
+
+    this->destroyFrameSyncs();
+    this->_inflightFrameCount = inflightFrameCount;
+    this->initFrameSyncs();
+}
+
+void RenderThread::initDynamicResolution() {
+    this->_dynamicResolution = this->_varCollection->getBoolOrDefault(RENDERING_DYNAMIC_RESOLUTION, true);
+
+    if (this->_dynamicResolution && !this->_physicalDevice->getProperties().limits.timestampComputeAndGraphics) {
+        this->_log->warning(RENDER_THREAD_TAG, "Timestamp queries are not supported, dynamic resolution disabled");
+        this->_dynamicResolution = false;
+    }
+
+    auto targetFrameTime = this->_varCollection->getIntOrDefault(RENDERING_DYNAMIC_RESOLUTION_FRAME_TIME, 16000);
+    auto minScale = this->_varCollection->getIntOrDefault(RENDERING_DYNAMIC_RESOLUTION_MIN_SCALE, 50);
+
+    this->_resolutionScaler.reset(static_cast<float>(targetFrameTime), static_cast<float>(minScale) / 100.0f);
+}
+
+void RenderThread::updateResolutionScale(uint32_t frameIdx) {
+    uint64_t timestamps[2];
+
+    auto result = this->_logicalDevice->getHandle().getQueryPoolResults(this->_timestampQueryPool, 2 * frameIdx, 2,
+                                                                        sizeof(timestamps), timestamps,
+                                                                        sizeof(uint64_t),
+                                                                        vk::QueryResultFlagBits::e64);
+
+    if (result != vk::Result::eSuccess || timestamps[1] < timestamps[0]) {
+        return;
+    }
+
+    // timestamp period is in nanoseconds
+    auto frameTime = static_cast<float>(timestamps[1] - timestamps[0]) *
+                     this->_physicalDevice->getProperties().limits.timestampPeriod / 1000.0f;
+
+    this->_resolutionScaler.update(frameTime);
+}
+
+void RenderThread::render(const std::shared_ptr<const FramePacket> &packet) {
     if (!this->_renderGraphExecutor.has_value()) {
+        // nothing is recorded, so anything released so far is only used by already submitted work
+        this->_deletionQueue->stamp(this->_timeline->getLastSubmittedValue());
+        this->_deletionQueue->collect();
+
         return;
     }
 
-    auto frameSync = this->_frameSyncs[this->_currentFrameIdx];
+    auto &frameSync = this->_frameSyncs[this->_currentFrameIdx];
+
+    // the only CPU wait of the frame: GPU finished with frame submitted inflight count frames ago
+    this->_timeline->wait(frameSync.timelineValue);
 
-    if (this->_logicalDevice->getHandle().waitForFences(frameSync.fence, true, std::numeric_limits<uint64_t>::max()) ==
-        vk::Result::eTimeout) {
-        throw EngineError("Frame fence timeout");
+    this->_deletionQueue->collect();
+
+    if (frameSync.timestampsWritten) {
+        this->updateResolutionScale(this->_currentFrameIdx);
+        frameSync.timestampsWritten = false;
     }
 
-    this->_logicalDevice->getHandle().resetFences(frameSync.fence);
+    // frame is retired, all of its command buffers and descriptor sets could be reused
+    this->_commandManager->resetFramePools(this->_currentFrameIdx);
+    this->_descriptorAllocator->resetFramePools(this->_currentFrameIdx);
 
     auto imageIdx = this->_swapchain->acquireNextImage(frameSync.imageAvailableSemaphore);
 
@@ -37,48 +192,90 @@ void RenderThread::render() {
         return;
     }
 
-    auto commandBuffer = this->_commandBuffers[this->_currentFrameIdx];
+    RenderFrame frame = {
+            .frameIdx = this->_currentFrameIdx,
+            .packet = packet,
+            .renderExtent = this->_resolutionScaler.getRenderExtent(this->_swapchain->getExtent())
+    };
+
+    auto commandBuffer = this->_commandManager->acquirePrimaryBuffer(this->_currentFrameIdx, 0);
+
+    commandBuffer.begin(vk::CommandBufferBeginInfo()
+                                .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
 
-    commandBuffer->reset();
-    commandBuffer->getHandle().begin(vk::CommandBufferBeginInfo());
+    // first timestamp waits for swapchain image, so time spent waiting for presentation is not measured
+    if (this->_dynamicResolution) {
+        commandBuffer.resetQueryPool(this->_timestampQueryPool, 2 * this->_currentFrameIdx, 2);
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eColorAttachmentOutput, this->_timestampQueryPool,
+                                     2 * this->_currentFrameIdx);
+    }
+
+    if (this->_recordingPool.has_value()) {
+        auto frameIdx = this->_currentFrameIdx;
+
+        // pool 0 belongs to render thread, workers use pools next to it
+        this->_renderGraphExecutor.value()->executeParallel(frame, imageIdx.value(), commandBuffer,
+                                                            this->_recordingPool.value(),
+                                                            [this, frameIdx](uint32_t threadIdx) {
+                                                                return this->_commandManager->acquireSecondaryBuffer(
+                                                                        frameIdx, threadIdx + 1);
+                                                            });
+    } else {
+        this->_renderGraphExecutor.value()->execute(frame, imageIdx.value(), commandBuffer);
+    }
 
-    this->_renderGraphExecutor.value()->execute(imageIdx.value(), commandBuffer->getHandle());
+    if (this->_dynamicResolution) {
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, this->_timestampQueryPool,
+                                     2 * this->_currentFrameIdx + 1);
+        frameSync.timestampsWritten = true;
+    }
 
-    commandBuffer->getHandle().end();
+    commandBuffer.end();
 
     auto waitDstStageMask = {
             static_cast<vk::PipelineStageFlags>(vk::PipelineStageFlagBits::eColorAttachmentOutput)
     };
 
-    auto submitInfo = vk::SubmitInfo()
-            .setCommandBuffers(commandBuffer->getHandle())
-            .setWaitSemaphores(frameSync.imageAvailableSemaphore)
-            .setSignalSemaphores(frameSync.renderFinishedSemaphore)
-            .setWaitDstStageMask(waitDstStageMask);
+    frameSync.timelineValue = this->_timeline->submit(GpuSubmission{
+            .commandBuffers = {commandBuffer},
+            .waitSemaphores = {frameSync.imageAvailableSemaphore},
+            .waitStages = waitDstStageMask,
+            .signalSemaphores = {frameSync.renderFinishedSemaphore}
+    });
 
-    this->_logicalDevice->getGraphicsQueue().submit(submitInfo, frameSync.fence);
+    this->_deletionQueue->stamp(frameSync.timelineValue);
 
     auto presentInfo = vk::PresentInfoKHR()
             .setWaitSemaphores(frameSync.renderFinishedSemaphore)
             .setSwapchains(this->_swapchain->getHandle())
             .setImageIndices(imageIdx.value());
 
-    if (this->_logicalDevice->getPresentQueue().presentKHR(presentInfo) != vk::Result::eSuccess) {
+    if (this->_timeline->present(presentInfo) != vk::Result::eSuccess) {
         this->_swapchain->invalidate();
     }
 
     this->_currentFrameIdx = (this->_currentFrameIdx + 1) % this->_inflightFrameCount;
+    this->_nextFrameTimelineValue = this->_frameSyncs[this->_currentFrameIdx].timelineValue;
 }
 
 void RenderThread::threadFunc(const std::stop_token &stopToken) {
     auto exception = []() { return EngineError("Render thread failure"); };
 
     while (!stopToken.stop_requested()) {
+        this->applyPendingSettings();
         this->handleSwapchainInvalidation();
         this->handleRenderGraphInvalidation();
 
+        // packet is consumed even if there is nothing to render, otherwise main thread would stall
+        auto packet = this->_framePipeline->pop(stopToken);
+
+        if (packet == nullptr) {
+            continue;
+        }
+
         try {
-            this->render();
+            this->_renderer->applyPacket(*packet);
+            this->render(packet);
         } catch (const vk::OutOfDateKHRError &error) {
             this->_swapchain->invalidate();
         } catch (const std::exception &error) {
@@ -95,10 +292,8 @@ void RenderThread::handleSwapchainInvalidation() {
         return;
     }
 
-    this->_logicalDevice->getHandle().waitIdle();
-
     try {
-        this->_swapchain->create();
+        this->_swapchain->create(this->_inflightFrameCount);
     } catch (const std::exception &error) {
         this->_log->error(RENDER_THREAD_TAG, error);
         throw exception();
@@ -118,10 +313,7 @@ void RenderThread::handleRenderGraphInvalidation() {
     auto exception = []() { return EngineError("Failed to handle render graph invalidation"); };
 
     if (!this->_renderer->getRenderGraph().has_value()) {
-        if (this->_renderGraphExecutor.has_value()) {
-            this->_renderGraphExecutor.value()->destroy();
-            this->_renderGraphExecutor = std::nullopt;
-        }
+        this->destroyRenderGraphExecutor();
 
         return;
     }
@@ -130,15 +322,20 @@ void RenderThread::handleRenderGraphInvalidation() {
         if (this->_renderGraphExecutor.value()->getGraph() == this->_renderer->getRenderGraph().value()) {
             return;
         } else {
-            this->_renderGraphExecutor.value()->destroy();
+            this->destroyRenderGraphExecutor();
         }
     }
 
+    auto sampleCount = this->_physicalDevice->getSampleCount(
+            std::max(this->_varCollection->getIntOrDefault(RENDERING_SAMPLE_COUNT, 4), 1));
+
     this->_renderGraphExecutor = std::make_shared<RenderGraphExecutor>(this->_renderer,
                                                                        this->_gpuAllocator,
+                                                                       this->_deletionQueue,
                                                                        this->_swapchain,
                                                                        this->_logicalDevice,
-                                                                       this->_renderer->getRenderGraph().value());
+                                                                       this->_renderer->getRenderGraph().value(),
+                                                                       sampleCount);
 
     try {
         this->_renderGraphExecutor.value()->create();
@@ -148,42 +345,51 @@ void RenderThread::handleRenderGraphInvalidation() {
     }
 }
 
+void RenderThread::destroyRenderGraphExecutor() {
+    if (!this->_renderGraphExecutor.has_value()) {
+        return;
+    }
+
+    // stages release their pipelines right away, so frames that used them have to retire first
+    this->_timeline->wait(this->_timeline->getLastSubmittedValue());
+
+    this->_renderGraphExecutor.value()->destroy();
+    this->_renderGraphExecutor = std::nullopt;
+}
+
 RenderThread::RenderThread(Renderer *renderer,
                            const std::shared_ptr<Log> &log,
                            const std::shared_ptr<VarCollection> &varCollection,
                            const std::shared_ptr<CommandManager> &commandManager,
+                           const std::shared_ptr<DescriptorAllocator> &descriptorAllocator,
                            const std::shared_ptr<GpuAllocator> &gpuAllocator,
+                           const std::shared_ptr<GpuTimeline> &timeline,
+                           const std::shared_ptr<DeletionQueue> &deletionQueue,
                            const std::shared_ptr<Swapchain> &swapchain,
+                           const std::shared_ptr<FramePipeline> &framePipeline,
+                           const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
                            const std::shared_ptr<LogicalDeviceProxy> &logicalDevice)
         : _renderer(renderer),
           _log(log),
           _varCollection(varCollection),
           _commandManager(commandManager),
+          _descriptorAllocator(descriptorAllocator),
           _gpuAllocator(gpuAllocator),
+          _timeline(timeline),
+          _deletionQueue(deletionQueue),
           _swapchain(swapchain),
+          _framePipeline(framePipeline),
+          _physicalDevice(physicalDevice),
           _logicalDevice(logicalDevice) {
     //
 }
 
 void RenderThread::run() {
-    this->_inflightFrameCount = this->_varCollection->getIntOrDefault(RENDERING_INFLIGHT_FRAME_COUNT, 2);
-
-    this->_frameSyncs = std::vector<FrameSync>(this->_inflightFrameCount);
-    this->_commandBuffers = std::vector<std::shared_ptr<CommandBufferProxy >>(this->_inflightFrameCount);
-
-    auto fenceCreateInfo = vk::FenceCreateInfo()
-            .setFlags(vk::FenceCreateFlagBits::eSignaled);
-    auto semaphoreCreateInfo = vk::SemaphoreCreateInfo();
-
-    for (uint32_t frameIdx = 0; frameIdx < this->_inflightFrameCount; frameIdx++) {
-        this->_frameSyncs[frameIdx] = {
-                .fence = this->_logicalDevice->getHandle().createFence(fenceCreateInfo),
-                .imageAvailableSemaphore = this->_logicalDevice->getHandle().createSemaphore(semaphoreCreateInfo),
-                .renderFinishedSemaphore = this->_logicalDevice->getHandle().createSemaphore(semaphoreCreateInfo)
-        };
+    this->_inflightFrameCount = std::max(this->_varCollection->getIntOrDefault(RENDERING_INFLIGHT_FRAME_COUNT, 2), 1);
 
-        this->_commandBuffers[frameIdx] = this->_commandManager->createPrimaryBuffer();
-    }
+    this->initParallelRecording();
+    this->initDynamicResolution();
+    this->initFrameSyncs();
 
     this->_thread = std::jthread([this](std::stop_token stopToken) {
         this->threadFunc(stopToken);
@@ -195,23 +401,22 @@ void RenderThread::stop() {
         this->_thread.join();
     }
 
-    this->_logicalDevice->getHandle().waitIdle();
+    this->_timeline->waitIdle();
 
-    if (this->_renderGraphExecutor.has_value()) {
-        this->_renderGraphExecutor.value()->destroy();
-    }
+    this->destroyRenderGraphExecutor();
+    this->_deletionQueue->flush();
 
-    for (const auto &commandBuffer: this->_commandBuffers) {
-        commandBuffer->destroy();
-    }
+    this->destroyFrameSyncs();
+    this->destroyParallelRecording();
+}
 
-    this->_commandBuffers.clear();
+void RenderThread::configure(const RenderThreadSettings &settings) {
+    std::lock_guard lock(this->_settingsMutex);
 
-    for (const auto &frameSync: this->_frameSyncs) {
-        this->_logicalDevice->getHandle().destroy(frameSync.fence);
-        this->_logicalDevice->getHandle().destroy(frameSync.imageAvailableSemaphore);
-        this->_logicalDevice->getHandle().destroy(frameSync.renderFinishedSemaphore);
-    }
+    this->_pendingSettings = settings;
+}
 
-    this->_frameSyncs.clear();
+void RenderThread::waitForFrameSlot() {
+    this->_framePipeline->waitEmpty();
+    this->_timeline->wait(this->_nextFrameTimelineValue);
 }
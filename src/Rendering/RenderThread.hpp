@@ -1,37 +1,60 @@
 #ifndef RENDERING_RENDERTHREAD_HPP
 #define RENDERING_RENDERTHREAD_HPP
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <thread>
 #include <vector>
 
 #include <vulkan/vulkan.hpp>
 
+#include "src/Rendering/ResolutionScaler.hpp"
+
 class Log;
 class VarCollection;
+class ThreadPool;
+class FramePipeline;
 class CommandManager;
+class DeletionQueue;
+class DescriptorAllocator;
 class GpuAllocator;
+class GpuTimeline;
 class Renderer;
 class Swapchain;
 class RenderGraphExecutor;
-class CommandBufferProxy;
 class LogicalDeviceProxy;
+class PhysicalDeviceProxy;
+struct FramePacket;
+
+struct RenderThreadSettings {
+    uint32_t inflightFrameCount;
+    vk::PresentModeKHR presentMode;
+};
 
 class RenderThread {
 private:
     struct FrameSync {
-        vk::Fence fence;
         vk::Semaphore imageAvailableSemaphore;
         vk::Semaphore renderFinishedSemaphore;
+        uint64_t timelineValue;
+
+        // frame wrote both of its timestamp queries
+        bool timestampsWritten;
     };
 
     Renderer *_renderer;
     std::shared_ptr<Log> _log;
     std::shared_ptr<VarCollection> _varCollection;
     std::shared_ptr<CommandManager> _commandManager;
+    std::shared_ptr<DescriptorAllocator> _descriptorAllocator;
     std::shared_ptr<GpuAllocator> _gpuAllocator;
+    std::shared_ptr<GpuTimeline> _timeline;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
     std::shared_ptr<Swapchain> _swapchain;
+    std::shared_ptr<FramePipeline> _framePipeline;
+    std::shared_ptr<PhysicalDeviceProxy> _physicalDevice;
     std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
 
     std::optional<std::shared_ptr<RenderGraphExecutor>> _renderGraphExecutor;
@@ -39,27 +62,60 @@ private:
     uint32_t _inflightFrameCount;
     uint32_t _currentFrameIdx;
     std::vector<FrameSync> _frameSyncs;
-    std::vector<std::shared_ptr<CommandBufferProxy>> _commandBuffers;
+    std::atomic<uint64_t> _nextFrameTimelineValue = 0;
+
+    // two timestamps per inflight frame, render extent is scaled by GPU time between them
+    bool _dynamicResolution;
+    vk::QueryPool _timestampQueryPool;
+    ResolutionScaler _resolutionScaler;
+
+    std::mutex _settingsMutex;
+    std::optional<RenderThreadSettings> _pendingSettings;
+
+    std::optional<std::shared_ptr<ThreadPool>> _recordingPool;
 
     std::jthread _thread;
 
-    void render();
+    void initParallelRecording();
+    void destroyParallelRecording();
+
+    void initFrameSyncs();
+    void destroyFrameSyncs();
+
+    void applyPendingSettings();
+
+    void initDynamicResolution();
+    void updateResolutionScale(uint32_t frameIdx);
+
+    void render(const std::shared_ptr<const FramePacket> &packet);
     void threadFunc(const std::stop_token &stopToken);
 
     void handleSwapchainInvalidation();
     void handleRenderGraphInvalidation();
+    void destroyRenderGraphExecutor();
 
 public:
     RenderThread(Renderer *renderer,
                  const std::shared_ptr<Log> &log,
                  const std::shared_ptr<VarCollection> &varCollection,
                  const std::shared_ptr<CommandManager> &commandManager,
+                 const std::shared_ptr<DescriptorAllocator> &descriptorAllocator,
                  const std::shared_ptr<GpuAllocator> &gpuAllocator,
+                 const std::shared_ptr<GpuTimeline> &timeline,
+                 const std::shared_ptr<DeletionQueue> &deletionQueue,
                  const std::shared_ptr<Swapchain> &swapchain,
+                 const std::shared_ptr<FramePipeline> &framePipeline,
+                 const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
                  const std::shared_ptr<LogicalDeviceProxy> &logicalDevice);
 
     void run();
     void stop();
+
+    // settings are applied by render thread before next frame
+    void configure(const RenderThreadSettings &settings);
+
+    // blocks caller until next frame could be recorded without waiting for GPU
+    void waitForFrameSlot();
 };
 
 #endif // RENDERING_RENDERTHREAD_HPP
@@ -1,12 +1,30 @@
 #include "Renderer.hpp"
 
+#include <algorithm>
+#include <thread>
+
 #include "src/Engine/EngineError.hpp"
+#include "src/Engine/VarCollection.hpp"
+#include "src/Engine/Vars.hpp"
+#include "src/Rendering/FramePipeline.hpp"
 #include "src/Rendering/GpuManager.hpp"
 #include "src/Rendering/RenderThread.hpp"
 #include "src/Rendering/Swapchain.hpp"
 #include "src/Rendering/SwapchainManager.hpp"
 #include "src/Rendering/Graph/RenderStage.hpp"
 
+static vk::PresentModeKHR parsePresentMode(const std::string &value) {
+    if (value == "mailbox") {
+        return vk::PresentModeKHR::eMailbox;
+    }
+
+    if (value == "immediate") {
+        return vk::PresentModeKHR::eImmediate;
+    }
+
+    return vk::PresentModeKHR::eFifo;
+}
+
 Renderer::Renderer(const std::shared_ptr<Log> &log,
                    const std::shared_ptr<VarCollection> &varCollection,
                    const std::shared_ptr<GpuManager> &gpuManager,
@@ -19,9 +37,13 @@ Renderer::Renderer(const std::shared_ptr<Log> &log,
 }
 
 void Renderer::init() {
-    if (this->_gpuManager->getLogicalDeviceProxy().expired() ||
+    if (this->_gpuManager->getPhysicalDeviceProxy().expired() ||
+        this->_gpuManager->getLogicalDeviceProxy().expired() ||
         this->_gpuManager->getAllocator().expired() ||
+        this->_gpuManager->getTimeline().expired() ||
+        this->_gpuManager->getDeletionQueue().expired() ||
         this->_gpuManager->getCommandManager().expired() ||
+        this->_gpuManager->getDescriptorAllocator().expired() ||
         this->_gpuManager->getSwapchainManager().expired()) {
         throw EngineError("GPU manager is not initialized");
     }
@@ -33,17 +55,28 @@ void Renderer::init() {
         stage->init();
     }
 
+    this->_framePipeline = std::make_shared<FramePipeline>(
+            this->_varCollection->getIntOrDefault(RENDERING_FRAME_PIPELINE_DEPTH, 2));
+
     this->_renderThread = std::make_shared<RenderThread>(this,
                                                          this->_log,
                                                          this->_varCollection,
                                                          this->_gpuManager->getCommandManager().lock(),
+                                                         this->_gpuManager->getDescriptorAllocator().lock(),
                                                          this->_gpuManager->getAllocator().lock(),
+                                                         this->_gpuManager->getTimeline().lock(),
+                                                         this->_gpuManager->getDeletionQueue().lock(),
                                                          this->_swapchain,
+                                                         this->_framePipeline,
+                                                         this->_gpuManager->getPhysicalDeviceProxy().lock(),
                                                          this->_gpuManager->getLogicalDeviceProxy().lock());
     this->_renderThread->run();
+
+    this->_nextFrameTime = std::chrono::steady_clock::now();
 }
 
 void Renderer::destroy() {
+    this->_framePipeline->close();
     this->_renderThread->stop();
 
     for (const auto &[stageRef, stage]: this->_renderStages) {
@@ -53,6 +86,42 @@ void Renderer::destroy() {
     this->_swapchain->destroy();
 }
 
+void Renderer::waitForNextFrame() {
+    auto presentMode = this->_varCollection->getStringOrDefault(RENDERING_PRESENT_MODE, "fifo");
+
+    this->_renderThread->configure(RenderThreadSettings{
+            .inflightFrameCount = static_cast<uint32_t>(
+                    std::max(this->_varCollection->getIntOrDefault(RENDERING_INFLIGHT_FRAME_COUNT, 2), 1)),
+            .presentMode = parsePresentMode(presentMode)
+    });
+
+    auto frameLimit = this->_varCollection->getIntOrDefault(RENDERING_FRAME_LIMIT, 0);
+
+    if (frameLimit > 0) {
+        auto frameTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / frameLimit));
+
+        std::this_thread::sleep_until(this->_nextFrameTime);
+
+        // limiter does not try to catch up after frame that took longer than its budget
+        this->_nextFrameTime = std::max(this->_nextFrameTime, std::chrono::steady_clock::now()) + frameTime;
+    }
+
+    if (this->_varCollection->getBoolOrDefault(RENDERING_LOW_LATENCY, false)) {
+        this->_renderThread->waitForFrameSlot();
+    }
+}
+
+bool Renderer::submitFrame(const std::shared_ptr<const FramePacket> &packet) {
+    return this->_framePipeline->push(packet);
+}
+
+void Renderer::applyPacket(const FramePacket &packet) {
+    for (const auto &[stageRef, stage]: this->_renderStages) {
+        stage->onPacket(packet);
+    }
+}
+
 void Renderer::removeRenderGraph() {
     this->_renderGraph = std::nullopt;
 }
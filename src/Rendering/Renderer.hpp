@@ -1,6 +1,7 @@
 #ifndef RENDERING_RENDERER_HPP
 #define RENDERING_RENDERER_HPP
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <optional>
@@ -11,9 +12,11 @@ class Log;
 class VarCollection;
 class GpuManager;
 class RenderThread;
+class FramePipeline;
 class Swapchain;
 class RenderStage;
 class Window;
+struct FramePacket;
 
 class Renderer {
 private:
@@ -23,7 +26,9 @@ private:
     std::shared_ptr<Window> _window;
 
     std::shared_ptr<Swapchain> _swapchain;
+    std::shared_ptr<FramePipeline> _framePipeline;
     std::shared_ptr<RenderThread> _renderThread;
+    std::chrono::steady_clock::time_point _nextFrameTime;
 
     std::optional<RenderGraph> _renderGraph;
     std::map<RenderStageRef, std::shared_ptr<RenderStage>> _renderStages;
@@ -37,6 +42,15 @@ public:
     void init();
     void destroy();
 
+    // applies frame limiter and latency mode, should be called before input is sampled
+    void waitForNextFrame();
+
+    // blocks while render thread is behind by pipeline depth, returns false once renderer is destroyed
+    bool submitFrame(const std::shared_ptr<const FramePacket> &packet);
+
+    // called by render thread for every packet taken from frame pipeline
+    void applyPacket(const FramePacket &packet);
+
     void removeRenderGraph();
     void setRenderGraph(const RenderGraph &graph);
 
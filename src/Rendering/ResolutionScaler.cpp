@@ -0,0 +1,52 @@
+#include "ResolutionScaler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// deviations of scale below threshold are treated as noise
+static constexpr const float RESOLUTION_SCALE_THRESHOLD = 0.02f;
+
+// part of deviation applied per frame
+static constexpr const float RESOLUTION_SCALE_DAMPING = 0.25f;
+
+// render extent changes in steps of this size, so images are not resized by a pixel every frame
+static constexpr const uint32_t RESOLUTION_STEP = 8;
+
+ResolutionScaler::ResolutionScaler()
+        : _targetFrameTime(0),
+          _minScale(1),
+          _scale(1) {
+    //
+}
+
+void ResolutionScaler::reset(float targetFrameTime, float minScale) {
+    this->_targetFrameTime = targetFrameTime;
+    this->_minScale = std::clamp(minScale, 0.1f, 1.0f);
+    this->_scale = 1;
+}
+
+void ResolutionScaler::update(float frameTime) {
+    if (this->_targetFrameTime <= 0 || frameTime <= 0) {
+        return;
+    }
+
+    auto desiredScale = std::clamp(this->_scale * std::sqrt(this->_targetFrameTime / frameTime),
+                                   this->_minScale, 1.0f);
+
+    if (std::abs(desiredScale - this->_scale) < RESOLUTION_SCALE_THRESHOLD) {
+        return;
+    }
+
+    this->_scale += (desiredScale - this->_scale) * RESOLUTION_SCALE_DAMPING;
+}
+
+vk::Extent2D ResolutionScaler::getRenderExtent(const vk::Extent2D &extent) const {
+    auto scaleDimension = [this](uint32_t size) {
+        auto scaled = static_cast<uint32_t>(std::lround(static_cast<float>(size) * this->_scale));
+        scaled = (scaled + RESOLUTION_STEP / 2) / RESOLUTION_STEP * RESOLUTION_STEP;
+
+        return std::clamp(scaled, std::min(size, RESOLUTION_STEP), size);
+    };
+
+    return vk::Extent2D(scaleDimension(extent.width), scaleDimension(extent.height));
+}
@@ -0,0 +1,30 @@
+#ifndef RENDERING_RESOLUTIONSCALER_HPP
+#define RENDERING_RESOLUTIONSCALER_HPP
+
+#include <vulkan/vulkan.hpp>
+
+// Picks scale of render extent that keeps GPU frame time at target. GPU time follows pixel count, so scale is
+// adjusted by square root of time ratio. Adjustments are damped and small deviations are ignored, otherwise noise of
+// measurements would make resolution flicker.
+class ResolutionScaler {
+private:
+    float _targetFrameTime;
+    float _minScale;
+    float _scale;
+
+public:
+    ResolutionScaler();
+
+    // frame time in microseconds, scale is reset to 1
+    void reset(float targetFrameTime, float minScale);
+
+    // measured GPU time of frame in microseconds
+    void update(float frameTime);
+
+    // scaled extent, never exceeds given one
+    [[nodiscard]] vk::Extent2D getRenderExtent(const vk::Extent2D &extent) const;
+
+    [[nodiscard]] float getScale() const { return this->_scale; }
+};
+
+#endif // RENDERING_RESOLUTIONSCALER_HPP
@@ -0,0 +1,170 @@
+#include "SceneDrawList.hpp"
+
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+
+#include "src/Rendering/Types/FramePacket.hpp"
+
+void SceneDrawList::markDirty(uint32_t slot) {
+    if (this->_dirtyFlags[slot]) {
+        return;
+    }
+
+    this->_dirtyFlags[slot] = true;
+    this->_dirtySlots.push_back(slot);
+}
+
+void SceneDrawList::addToBatch(uint32_t slot, const std::shared_ptr<Mesh> &mesh) {
+    auto it = this->_meshBatches.find(mesh.get());
+
+    if (it == this->_meshBatches.end()) {
+        uint32_t batchIdx;
+
+        if (this->_freeBatches.empty()) {
+            batchIdx = static_cast<uint32_t>(this->_batches.size());
+            this->_batches.emplace_back();
+        } else {
+            batchIdx = this->_freeBatches.back();
+            this->_freeBatches.pop_back();
+        }
+
+        this->_batches[batchIdx].mesh = mesh;
+        it = this->_meshBatches.emplace(mesh.get(), batchIdx).first;
+    }
+
+    auto &batch = this->_batches[it->second];
+
+    this->_slots[slot].batchPosition = static_cast<uint32_t>(batch.slots.size());
+    this->_instances[slot].batchIdx = it->second;
+
+    batch.slots.push_back(slot);
+}
+
+void SceneDrawList::removeFromBatch(uint32_t slot) {
+    auto batchIdx = this->_instances[slot].batchIdx;
+
+    if (batchIdx == SCENE_NO_BATCH) {
+        return;
+    }
+
+    auto &batch = this->_batches[batchIdx];
+    auto position = this->_slots[slot].batchPosition;
+
+    // order of instances inside of batch does not matter, so the last one takes place of removed one
+    batch.slots[position] = batch.slots.back();
+    this->_slots[batch.slots[position]].batchPosition = position;
+    batch.slots.pop_back();
+
+    this->_instances[slot].batchIdx = SCENE_NO_BATCH;
+
+    if (batch.slots.empty()) {
+        this->_meshBatches.erase(batch.mesh.get());
+        this->_freeBatches.push_back(batchIdx);
+
+        batch.mesh = nullptr;
+    }
+}
+
+void SceneDrawList::apply(const FramePacket &packet) {
+    for (uint32_t slot: packet.removedSlots) {
+        this->removeFromBatch(slot);
+        this->markDirty(slot);
+
+        this->_slots[slot] = Slot{
+                .objectId = 0,
+                .mesh = nullptr,
+                .albedoTexture = nullptr,
+                .specularTexture = nullptr,
+                .bounds = glm::vec4(0),
+                .batchPosition = 0
+        };
+
+        this->_layoutChanged = true;
+    }
+
+    for (const auto &draw: packet.draws) {
+        if (this->_slots.size() <= draw.slot) {
+            this->_slots.resize(draw.slot + 1);
+            this->_instances.resize(draw.slot + 1, SceneInstance{
+                    .model = glm::mat4(1),
+                    .modelRotation = glm::mat4(1),
+                    .albedoTextureIdx = 0,
+                    .specularTextureIdx = 0,
+                    .batchIdx = SCENE_NO_BATCH,
+                    .padding = 0
+            });
+            this->_dirtyFlags.resize(draw.slot + 1, false);
+        }
+
+        auto &slot = this->_slots[draw.slot];
+        auto &instance = this->_instances[draw.slot];
+
+        if (slot.mesh != draw.mesh) {
+            this->removeFromBatch(draw.slot);
+            this->addToBatch(draw.slot, draw.mesh);
+
+            this->_layoutChanged = true;
+        }
+
+        // bounding sphere is scaled by largest axis of model transform
+        auto scale = std::max({glm::length(glm::vec3(draw.model[0])),
+                               glm::length(glm::vec3(draw.model[1])),
+                               glm::length(glm::vec3(draw.model[2]))});
+
+        slot.objectId = draw.objectId;
+        slot.mesh = draw.mesh;
+        slot.albedoTexture = draw.albedoTexture;
+        slot.specularTexture = draw.specularTexture;
+        slot.bounds = glm::vec4(glm::vec3(draw.model * glm::vec4(draw.mesh->boundsCenter, 1)),
+                                draw.mesh->boundsRadius * scale);
+
+        instance.model = draw.model;
+        instance.modelRotation = draw.modelRotation;
+        instance.albedoTextureIdx = draw.albedoTexture->tableIdx;
+        instance.specularTextureIdx = draw.specularTexture->tableIdx;
+
+        this->markDirty(draw.slot);
+
+        this->_changedObjectIds.push_back(draw.objectId);
+        this->_changedBounds.push_back(slot.bounds);
+    }
+
+    if (this->_layoutChanged) {
+        this->_layoutVersion++;
+    }
+}
+
+void SceneDrawList::clear() {
+    this->_slots.clear();
+    this->_instances.clear();
+    this->_batches.clear();
+    this->_freeBatches.clear();
+    this->_meshBatches.clear();
+    this->_dirtySlots.clear();
+    this->_dirtyFlags.clear();
+    this->_changedObjectIds.clear();
+    this->_changedBounds.clear();
+    this->_layoutChanged = true;
+    this->_layoutVersion++;
+}
+
+void SceneDrawList::markAllDirty() {
+    for (uint32_t slot = 0; slot < this->_slots.size(); slot++) {
+        this->markDirty(slot);
+    }
+}
+
+void SceneDrawList::clearDirty() {
+    for (uint32_t slot: this->_dirtySlots) {
+        this->_dirtyFlags[slot] = false;
+    }
+
+    this->_dirtySlots.clear();
+}
+
+void SceneDrawList::clearChanges() {
+    this->_changedObjectIds.clear();
+    this->_changedBounds.clear();
+    this->_layoutChanged = false;
+}
@@ -0,0 +1,108 @@
+#ifndef RENDERING_STAGES_SCENEDRAWLIST_HPP
+#define RENDERING_STAGES_SCENEDRAWLIST_HPP
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include "src/Rendering/Types/Mesh.hpp"
+#include "src/Rendering/Types/Texture.hpp"
+
+struct FramePacket;
+
+// batch index of free slots, such instances are skipped by culling
+static constexpr const uint32_t SCENE_NO_BATCH = std::numeric_limits<uint32_t>::max();
+
+// matches InstanceData of scene shaders
+struct SceneInstance {
+    glm::mat4 model;
+    glm::mat4 modelRotation;
+    uint32_t albedoTextureIdx;
+    uint32_t specularTextureIdx;
+    uint32_t batchIdx;
+    uint32_t padding;
+};
+
+// instances drawn with the same mesh, empty batches are free and reused by next mesh
+struct SceneBatch {
+    std::shared_ptr<Mesh> mesh;
+    std::vector<uint32_t> slots;
+};
+
+// Instances of props kept across frames. Packets deliver changed props only, every prop keeps its slot until it is
+// removed, so changes are written into slots of persistent instance buffer and the rest of it stays untouched.
+// Instances are grouped into batches by mesh, batches also keep their indices while they have instances.
+class SceneDrawList {
+private:
+    struct Slot {
+        uint64_t objectId;
+        std::shared_ptr<Mesh> mesh;
+        std::shared_ptr<Texture> albedoTexture;
+        std::shared_ptr<Texture> specularTexture;
+
+        // world bounding sphere, computed once per change
+        glm::vec4 bounds;
+
+        // index of slot in instance list of its batch
+        uint32_t batchPosition;
+    };
+
+    std::vector<Slot> _slots;
+    std::vector<SceneInstance> _instances;
+    std::vector<SceneBatch> _batches;
+    std::vector<uint32_t> _freeBatches;
+    std::unordered_map<const Mesh *, uint32_t> _meshBatches;
+
+    // slots to upload, flags deduplicate slots changed by several packets
+    std::vector<uint32_t> _dirtySlots;
+    std::vector<bool> _dirtyFlags;
+
+    // changes since they were last cleared
+    std::vector<uint64_t> _changedObjectIds;
+    std::vector<glm::vec4> _changedBounds;
+    bool _layoutChanged = false;
+    uint64_t _layoutVersion = 0;
+
+    void markDirty(uint32_t slot);
+    void addToBatch(uint32_t slot, const std::shared_ptr<Mesh> &mesh);
+    void removeFromBatch(uint32_t slot);
+
+public:
+    void apply(const FramePacket &packet);
+    void clear();
+
+    // every used slot is uploaded again, e.g. into reallocated buffer
+    void markAllDirty();
+    void clearDirty();
+    void clearChanges();
+
+    [[nodiscard]] uint32_t getSlotCount() const { return static_cast<uint32_t>(this->_slots.size()); }
+
+    [[nodiscard]] const std::vector<SceneInstance> &getInstances() const { return this->_instances; }
+
+    [[nodiscard]] const std::vector<SceneBatch> &getBatches() const { return this->_batches; }
+
+    [[nodiscard]] uint64_t getObjectId(uint32_t slot) const { return this->_slots[slot].objectId; }
+
+    [[nodiscard]] const glm::vec4 &getBounds(uint32_t slot) const { return this->_slots[slot].bounds; }
+
+    [[nodiscard]] const std::vector<uint32_t> &getDirtySlots() const { return this->_dirtySlots; }
+
+    // object ids and new bounds of props that moved or changed their resources
+    [[nodiscard]] const std::vector<uint64_t> &getChangedObjectIds() const { return this->_changedObjectIds; }
+
+    [[nodiscard]] const std::vector<glm::vec4> &getChangedBounds() const { return this->_changedBounds; }
+
+    // props were added, removed or moved between batches
+    [[nodiscard]] bool isLayoutChanged() const { return this->_layoutChanged; }
+
+    // changes along with layout, so lists derived from batches are rebuilt only when it differs
+    [[nodiscard]] uint64_t getLayoutVersion() const { return this->_layoutVersion; }
+};
+
+#endif // RENDERING_STAGES_SCENEDRAWLIST_HPP
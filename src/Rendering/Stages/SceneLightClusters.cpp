@@ -0,0 +1,147 @@
+#include "SceneLightClusters.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+SceneLightClusters::SceneLightClusters()
+        : _clusters(LIGHT_CLUSTER_COUNT),
+          _sliceScale(0),
+          _sliceBias(0) {
+    //
+}
+
+void SceneLightClusters::build(const glm::mat4 &view, const glm::mat4 &projection, float near, float far,
+                               const std::vector<SceneClusterLight> &lights) {
+    this->_lightIndices.clear();
+    this->_assignments.clear();
+
+    std::fill(this->_clusters.begin(), this->_clusters.end(), SceneLightCluster{.offset = 0, .count = 0});
+
+    auto logDepthRatio = std::log(far / near);
+
+    this->_sliceScale = static_cast<float>(LIGHT_CLUSTER_Z) / logDepthRatio;
+    this->_sliceBias = static_cast<float>(LIGHT_CLUSTER_Z) * std::log(near) / logDepthRatio;
+
+    auto getSlice = [this](float depth) {
+        auto slice = static_cast<int>(std::floor(std::log(depth) * this->_sliceScale - this->_sliceBias));
+
+        return static_cast<uint32_t>(std::clamp(slice, 0, static_cast<int>(LIGHT_CLUSTER_Z) - 1));
+    };
+
+    auto getSliceDepth = [near, far](uint32_t slice) {
+        return near * std::pow(far / near, static_cast<float>(slice) / static_cast<float>(LIGHT_CLUSTER_Z));
+    };
+
+    auto getTile = [](float ndc, uint32_t tileCount) {
+        auto tile = static_cast<int>(std::floor((ndc + 1.0f) * 0.5f * static_cast<float>(tileCount)));
+
+        return static_cast<uint32_t>(std::clamp(tile, 0, static_cast<int>(tileCount) - 1));
+    };
+
+    // view space coordinate at given depth is ndc * depth / scale of projection
+    auto scale = glm::vec2(projection[0][0], projection[1][1]);
+    auto tileSize = glm::vec2(2.0f / static_cast<float>(LIGHT_CLUSTER_X), 2.0f / static_cast<float>(LIGHT_CLUSTER_Y));
+
+    for (uint32_t lightIdx = 0; lightIdx < lights.size(); lightIdx++) {
+        const auto &light = lights[lightIdx];
+
+        auto center = glm::vec3(view * glm::vec4(light.position, 1));
+        auto depth = -center.z;
+
+        if (depth + light.radius < near || depth - light.radius > far) {
+            continue;
+        }
+
+        auto firstSlice = getSlice(std::max(depth - light.radius, near));
+        auto lastSlice = getSlice(std::min(depth + light.radius, far));
+
+        // sphere crossing near plane could cover any tile
+        auto firstTile = glm::uvec2(0, 0);
+        auto lastTile = glm::uvec2(LIGHT_CLUSTER_X - 1, LIGHT_CLUSTER_Y - 1);
+
+        if (depth - light.radius > near) {
+            auto ndcMin = glm::vec2(std::numeric_limits<float>::max());
+            auto ndcMax = glm::vec2(std::numeric_limits<float>::lowest());
+
+            for (auto cornerDepth: {depth - light.radius, depth + light.radius}) {
+                for (auto dx: {-light.radius, light.radius}) {
+                    for (auto dy: {-light.radius, light.radius}) {
+                        auto ndc = scale * glm::vec2(center.x + dx, center.y + dy) / cornerDepth;
+
+                        ndcMin = glm::min(ndcMin, ndc);
+                        ndcMax = glm::max(ndcMax, ndc);
+                    }
+                }
+            }
+
+            firstTile = glm::uvec2(getTile(ndcMin.x, LIGHT_CLUSTER_X), getTile(ndcMin.y, LIGHT_CLUSTER_Y));
+            lastTile = glm::uvec2(getTile(ndcMax.x, LIGHT_CLUSTER_X), getTile(ndcMax.y, LIGHT_CLUSTER_Y));
+        }
+
+        for (uint32_t slice = firstSlice; slice <= lastSlice; slice++) {
+            auto nearDepth = getSliceDepth(slice);
+            auto farDepth = getSliceDepth(slice + 1);
+
+            for (uint32_t y = firstTile.y; y <= lastTile.y; y++) {
+                for (uint32_t x = firstTile.x; x <= lastTile.x; x++) {
+                    auto ndcMin = glm::vec2(-1.0f) + tileSize * glm::vec2(x, y);
+                    auto ndcMax = ndcMin + tileSize;
+
+                    // bounding box of cluster, which is a frustum slice in view space
+                    auto corners = {
+                            ndcMin * nearDepth / scale,
+                            ndcMax * nearDepth / scale,
+                            ndcMin * farDepth / scale,
+                            ndcMax * farDepth / scale
+                    };
+
+                    auto boxMin = glm::vec3(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                                            -farDepth);
+                    auto boxMax = glm::vec3(std::numeric_limits<float>::lowest(),
+                                            std::numeric_limits<float>::lowest(),
+                                            -nearDepth);
+
+                    for (const auto &corner: corners) {
+                        boxMin = glm::min(boxMin, glm::vec3(corner, boxMin.z));
+                        boxMax = glm::max(boxMax, glm::vec3(corner, boxMax.z));
+                    }
+
+                    auto offset = center - glm::clamp(center, boxMin, boxMax);
+
+                    if (glm::dot(offset, offset) > light.radius * light.radius) {
+                        continue;
+                    }
+
+                    auto clusterIdx = (slice * LIGHT_CLUSTER_Y + y) * LIGHT_CLUSTER_X + x;
+
+                    this->_assignments.emplace_back(clusterIdx, lightIdx);
+                    this->_clusters[clusterIdx].count++;
+                }
+            }
+        }
+    }
+
+    uint32_t offset = 0;
+
+    for (auto &cluster: this->_clusters) {
+        cluster.offset = offset;
+        offset += cluster.count;
+
+        // count is restored while indices are scattered
+        cluster.count = 0;
+    }
+
+    this->_lightIndices.resize(this->_assignments.size());
+
+    for (const auto &[clusterIdx, lightIdx]: this->_assignments) {
+        auto &cluster = this->_clusters[clusterIdx];
+
+        this->_lightIndices[cluster.offset + cluster.count++] = lightIdx;
+    }
+}
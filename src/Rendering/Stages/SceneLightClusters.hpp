@@ -0,0 +1,58 @@
+#ifndef RENDERING_STAGES_SCENELIGHTCLUSTERS_HPP
+#define RENDERING_STAGES_SCENELIGHTCLUSTERS_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+// cluster grid, matches constants of scene-composition.frag
+static constexpr const uint32_t LIGHT_CLUSTER_X = 16;
+static constexpr const uint32_t LIGHT_CLUSTER_Y = 9;
+static constexpr const uint32_t LIGHT_CLUSTER_Z = 24;
+static constexpr const uint32_t LIGHT_CLUSTER_COUNT = LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y * LIGHT_CLUSTER_Z;
+
+// matches LightCluster of scene-composition.frag
+struct SceneLightCluster {
+    uint32_t offset;
+    uint32_t count;
+};
+
+struct SceneClusterLight {
+    glm::vec3 position;
+    float radius;
+};
+
+// Bins lights into view space clusters: screen is split into tiles and depth into exponential slices, every
+// cluster lists indices of lights whose sphere of influence intersects it. Composition evaluates only lights of
+// cluster of the pixel.
+class SceneLightClusters {
+private:
+    std::vector<SceneLightCluster> _clusters;
+    std::vector<uint32_t> _lightIndices;
+
+    // pairs of cluster and light index, counting sorted into light indices
+    std::vector<std::pair<uint32_t, uint32_t>> _assignments;
+
+    float _sliceScale;
+    float _sliceBias;
+
+public:
+    SceneLightClusters();
+
+    void build(const glm::mat4 &view, const glm::mat4 &projection, float near, float far,
+               const std::vector<SceneClusterLight> &lights);
+
+    // slice of view depth is log(depth) * scale - bias
+    [[nodiscard]] float getSliceScale() const { return this->_sliceScale; }
+
+    [[nodiscard]] float getSliceBias() const { return this->_sliceBias; }
+
+    [[nodiscard]] const std::vector<SceneLightCluster> &getClusters() const { return this->_clusters; }
+
+    [[nodiscard]] const std::vector<uint32_t> &getLightIndices() const { return this->_lightIndices; }
+};
+
+#endif // RENDERING_STAGES_SCENELIGHTCLUSTERS_HPP
@@ -0,0 +1,2242 @@
+#include "SceneRenderStage.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+#include <fmt/core.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "src/Engine/EngineError.hpp"
+#include "src/Engine/Log.hpp"
+#include "src/Engine/VarCollection.hpp"
+#include "src/Engine/Vars.hpp"
+#include "src/Rendering/CommandManager.hpp"
+#include "src/Rendering/DeletionQueue.hpp"
+#include "src/Rendering/DescriptorAllocator.hpp"
+#include "src/Rendering/GeometryPool.hpp"
+#include "src/Rendering/GpuAllocator.hpp"
+#include "src/Rendering/GpuManager.hpp"
+#include "src/Rendering/GpuTimeline.hpp"
+#include "src/Rendering/Swapchain.hpp"
+#include "src/Rendering/TextureTable.hpp"
+#include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
+#include "src/Rendering/Proxies/PhysicalDeviceProxy.hpp"
+#include "src/Rendering/Types/FramePacket.hpp"
+#include "src/Rendering/Types/RenderFrame.hpp"
+#include "src/Resources/Resource.hpp"
+#include "src/Resources/ResourceData.hpp"
+#include "src/Resources/ResourceDatabase.hpp"
+#include "src/Resources/ResourceLoader.hpp"
+#include "src/Types/Vertex.hpp"
+
+static constexpr const char *SCENE_RENDER_STAGE_TAG = "SceneRenderStage";
+
+static constexpr const uint32_t INITIAL_INSTANCE_CAPACITY = 1024;
+static constexpr const uint32_t INITIAL_BATCH_CAPACITY = 256;
+static constexpr const uint32_t INITIAL_LIGHT_INDEX_CAPACITY = 4096;
+
+// matches local_size_x of scene-cull.comp
+static constexpr const uint32_t CULL_GROUP_SIZE = 64;
+
+// batches per secondary command buffer of model pass
+static constexpr const uint32_t MODEL_PASS_CHUNK_SIZE = 64;
+static constexpr const uint32_t MODEL_PASS_MAX_CHUNK_COUNT = 8;
+
+static constexpr const float SCENE_AMBIENT = 0.1f;
+
+// attenuation of light never reaches zero, so contribution below 8-bit precision is cut off to bound its reach
+static constexpr const float LIGHT_ATTENUATION_CUTOFF = 1.0f / 256.0f;
+
+// smallest tile of shadow atlas, shadows of distant lights get no less texels than that
+static constexpr const uint32_t SHADOW_TILE_MIN_SIZE = 128;
+
+// matches constants of scene-composition.frag
+static constexpr const uint32_t DIRECTIONAL_LIGHT_COUNT = 4;
+static constexpr const uint32_t SHADOW_CASCADE_MAX_COUNT = 4;
+
+// weight of logarithmic splits of cascades against uniform ones
+static constexpr const float SHADOW_CASCADE_SPLIT_LAMBDA = 0.75f;
+
+// following structures match std140 layout of scene-composition.frag uniforms
+
+struct ShadowData {
+    glm::mat4 matrix;
+    glm::vec3 position;
+    float range;
+    glm::vec4 rect;
+};
+
+struct LightData {
+    glm::vec3 position;
+    float padding;
+    glm::vec3 color;
+    float range;
+};
+
+struct DirectionalLightData {
+    glm::vec3 direction;
+    uint32_t cascadeCount;
+    glm::vec3 color;
+    float padding;
+    glm::vec4 splits;
+    std::array<glm::mat4, SHADOW_CASCADE_MAX_COUNT> matrices;
+    std::array<glm::vec4, SHADOW_CASCADE_MAX_COUNT> rects;
+};
+
+struct CameraData {
+    glm::mat4 view;
+    glm::vec3 position;
+    float near;
+    glm::vec2 tileSize;
+    float sliceScale;
+    float sliceBias;
+    glm::mat4 inverseViewProjection;
+    glm::vec2 extent;
+};
+
+struct SceneData {
+    float ambient;
+    uint32_t shadowCount;
+    uint32_t lightCount;
+    uint32_t directionalCount;
+};
+
+// following structures match std430 layout of scene-cull.comp inputs
+
+struct CullBatchData {
+    glm::vec4 bounds;
+    uint32_t indexCount;
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+    uint32_t padding;
+};
+
+struct CullConstants {
+    std::array<glm::vec4, 6> planes;
+    uint32_t slotCount;
+};
+
+// planes point inside of frustum, depth range is [0; 1]
+static std::array<glm::vec4, 6> extractFrustumPlanes(const glm::mat4 &matrix) {
+    auto row = [&matrix](int idx) {
+        return glm::vec4(matrix[0][idx], matrix[1][idx], matrix[2][idx], matrix[3][idx]);
+    };
+
+    std::array<glm::vec4, 6> planes = {
+            row(3) + row(0),
+            row(3) - row(0),
+            row(3) + row(1),
+            row(3) - row(1),
+            row(2),
+            row(3) - row(2)
+    };
+
+    for (auto &plane: planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    return planes;
+}
+
+static bool intersectsFrustum(const std::array<glm::vec4, 6> &planes, const glm::vec4 &sphere) {
+    return std::all_of(planes.begin(), planes.end(), [&sphere](const glm::vec4 &plane) {
+        return glm::dot(glm::vec3(plane), glm::vec3(sphere)) + plane.w >= -sphere.w;
+    });
+}
+
+// conservative, volume is culled only when all of its corners are behind the same plane
+static bool intersectsFrustum(const std::array<glm::vec4, 6> &planes, const std::array<glm::vec3, 8> &corners) {
+    return std::all_of(planes.begin(), planes.end(), [&corners](const glm::vec4 &plane) {
+        return std::any_of(corners.begin(), corners.end(), [&plane](const glm::vec3 &corner) {
+            return glm::dot(glm::vec3(plane), corner) + plane.w >= 0;
+        });
+    });
+}
+
+// corners of volume that is projected by matrix into clip space, depth range is [0; 1]
+static std::array<glm::vec3, 8> getFrustumCorners(const glm::mat4 &matrix) {
+    auto inverse = glm::inverse(matrix);
+
+    std::array<glm::vec3, 8> corners;
+
+    for (uint32_t cornerIdx = 0; cornerIdx < corners.size(); cornerIdx++) {
+        auto corner = inverse * glm::vec4((cornerIdx & 1) ? 1 : -1, (cornerIdx & 2) ? 1 : -1, (cornerIdx & 4) ? 1 : 0,
+                                          1);
+
+        corners[cornerIdx] = glm::vec3(corner) / corner.w;
+    }
+
+    return corners;
+}
+
+// distance at which attenuation of light drops to cutoff
+static float getLightRadius(float range) {
+    return std::sqrt(std::max(range / LIGHT_ATTENUATION_CUTOFF - 1.0f, 0.0f));
+}
+
+static vk::PipelineShaderStageCreateInfo shaderStage(vk::ShaderStageFlagBits stage,
+                                                     const vk::ShaderModule &shaderModule) {
+    return vk::PipelineShaderStageCreateInfo()
+            .setStage(stage)
+            .setModule(shaderModule)
+            .setPName("main");
+}
+
+static vk::Pipeline createModelPipeline(const vk::Device &device, const vk::PipelineCache &pipelineCache,
+                                        const vk::ShaderModule &vertexShader,
+                                        const vk::ShaderModule &fragmentShader,
+                                        const vk::PipelineLayout &layout,
+                                        const vk::RenderPass &renderPass,
+                                        vk::SampleCountFlagBits sampleCount,
+                                        bool depthPrepass,
+                                        bool compactGBuffer) {
+    auto stages = {
+            shaderStage(vk::ShaderStageFlagBits::eVertex, vertexShader),
+            shaderStage(vk::ShaderStageFlagBits::eFragment, fragmentShader)
+    };
+
+    auto bindings = {
+            vk::VertexInputBindingDescription(0, sizeof(Vertex), vk::VertexInputRate::eVertex)
+    };
+
+    auto attributes = {
+            vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, pos)),
+            vk::VertexInputAttributeDescription(1, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, normal)),
+            vk::VertexInputAttributeDescription(2, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, color)),
+            vk::VertexInputAttributeDescription(3, 0, vk::Format::eR32G32Sfloat, offsetof(Vertex, uv))
+    };
+
+    auto vertexInputState = vk::PipelineVertexInputStateCreateInfo()
+            .setVertexBindingDescriptions(bindings)
+            .setVertexAttributeDescriptions(attributes);
+
+    auto inputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo()
+            .setTopology(vk::PrimitiveTopology::eTriangleList);
+
+    auto viewportState = vk::PipelineViewportStateCreateInfo()
+            .setViewportCount(1)
+            .setScissorCount(1);
+
+    auto rasterizationState = vk::PipelineRasterizationStateCreateInfo()
+            .setPolygonMode(vk::PolygonMode::eFill)
+            .setCullMode(vk::CullModeFlagBits::eBack)
+            .setFrontFace(vk::FrontFace::eCounterClockwise)
+            .setLineWidth(1.0f);
+
+    auto multisampleState = vk::PipelineMultisampleStateCreateInfo()
+            .setRasterizationSamples(sampleCount);
+
+    // with prepass depth is already final, so only visible fragments are shaded and written to G-buffer
+    auto depthStencilState = vk::PipelineDepthStencilStateCreateInfo()
+            .setDepthTestEnable(true)
+            .setDepthWriteEnable(!depthPrepass)
+            .setDepthCompareOp(depthPrepass ? vk::CompareOp::eEqual : vk::CompareOp::eLess);
+
+    auto colorBlendAttachment = vk::PipelineColorBlendAttachmentState()
+            .setColorWriteMask(vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                               vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+
+    // albedo, position, normal and specular, compact G-buffer has no position
+    auto colorBlendAttachments = std::vector<vk::PipelineColorBlendAttachmentState>(compactGBuffer ? 3 : 4,
+                                                                                    colorBlendAttachment);
+
+    auto colorBlendState = vk::PipelineColorBlendStateCreateInfo()
+            .setAttachments(colorBlendAttachments);
+
+    auto dynamicStates = {
+            vk::DynamicState::eViewport,
+            vk::DynamicState::eScissor
+    };
+
+    auto dynamicState = vk::PipelineDynamicStateCreateInfo()
+            .setDynamicStates(dynamicStates);
+
+    auto createInfo = vk::GraphicsPipelineCreateInfo()
+            .setStages(stages)
+            .setPVertexInputState(&vertexInputState)
+            .setPInputAssemblyState(&inputAssemblyState)
+            .setPViewportState(&viewportState)
+            .setPRasterizationState(&rasterizationState)
+            .setPMultisampleState(&multisampleState)
+            .setPDepthStencilState(&depthStencilState)
+            .setPColorBlendState(&colorBlendState)
+            .setPDynamicState(&dynamicState)
+            .setLayout(layout)
+            .setRenderPass(renderPass)
+            .setSubpass(1);
+
+    return device.createGraphicsPipeline(pipelineCache, createInfo).value;
+}
+
+static vk::Pipeline createDepthPipeline(const vk::Device &device, const vk::PipelineCache &pipelineCache,
+                                        const vk::ShaderModule &vertexShader,
+                                        const vk::PipelineLayout &layout,
+                                        const vk::RenderPass &renderPass,
+                                        vk::SampleCountFlagBits sampleCount) {
+    auto stages = {
+            shaderStage(vk::ShaderStageFlagBits::eVertex, vertexShader)
+    };
+
+    // shares vertex buffer with model pipeline, but fetches only positions
+    auto bindings = {
+            vk::VertexInputBindingDescription(0, sizeof(Vertex), vk::VertexInputRate::eVertex)
+    };
+
+    auto attributes = {
+            vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, pos))
+    };
+
+    auto vertexInputState = vk::PipelineVertexInputStateCreateInfo()
+            .setVertexBindingDescriptions(bindings)
+            .setVertexAttributeDescriptions(attributes);
+
+    auto inputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo()
+            .setTopology(vk::PrimitiveTopology::eTriangleList);
+
+    auto viewportState = vk::PipelineViewportStateCreateInfo()
+            .setViewportCount(1)
+            .setScissorCount(1);
+
+    auto rasterizationState = vk::PipelineRasterizationStateCreateInfo()
+            .setPolygonMode(vk::PolygonMode::eFill)
+            .setCullMode(vk::CullModeFlagBits::eBack)
+            .setFrontFace(vk::FrontFace::eCounterClockwise)
+            .setLineWidth(1.0f);
+
+    auto multisampleState = vk::PipelineMultisampleStateCreateInfo()
+            .setRasterizationSamples(sampleCount);
+
+    auto depthStencilState = vk::PipelineDepthStencilStateCreateInfo()
+            .setDepthTestEnable(true)
+            .setDepthWriteEnable(true)
+            .setDepthCompareOp(vk::CompareOp::eLess);
+
+    auto colorBlendState = vk::PipelineColorBlendStateCreateInfo();
+
+    auto dynamicStates = {
+            vk::DynamicState::eViewport,
+            vk::DynamicState::eScissor
+    };
+
+    auto dynamicState = vk::PipelineDynamicStateCreateInfo()
+            .setDynamicStates(dynamicStates);
+
+    auto createInfo = vk::GraphicsPipelineCreateInfo()
+            .setStages(stages)
+            .setPVertexInputState(&vertexInputState)
+            .setPInputAssemblyState(&inputAssemblyState)
+            .setPViewportState(&viewportState)
+            .setPRasterizationState(&rasterizationState)
+            .setPMultisampleState(&multisampleState)
+            .setPDepthStencilState(&depthStencilState)
+            .setPColorBlendState(&colorBlendState)
+            .setPDynamicState(&dynamicState)
+            .setLayout(layout)
+            .setRenderPass(renderPass)
+            .setSubpass(0);
+
+    return device.createGraphicsPipeline(pipelineCache, createInfo).value;
+}
+
+static vk::Pipeline createCompositionPipeline(const vk::Device &device, const vk::PipelineCache &pipelineCache,
+                                              const vk::ShaderModule &vertexShader,
+                                              const vk::ShaderModule &fragmentShader,
+                                              const vk::PipelineLayout &layout,
+                                              const vk::RenderPass &renderPass,
+                                              uint32_t shadowCount,
+                                              uint32_t lightCount,
+                                              vk::SampleCountFlagBits sampleCount) {
+    auto specializationEntries = {
+            vk::SpecializationMapEntry(0, 0, sizeof(uint32_t)),
+            vk::SpecializationMapEntry(1, sizeof(uint32_t), sizeof(uint32_t)),
+            vk::SpecializationMapEntry(2, 2 * sizeof(uint32_t), sizeof(uint32_t))
+    };
+
+    uint32_t specializationData[] = {shadowCount, lightCount, static_cast<uint32_t>(sampleCount)};
+
+    auto specializationInfo = vk::SpecializationInfo()
+            .setMapEntries(specializationEntries)
+            .setDataSize(sizeof(specializationData))
+            .setPData(specializationData);
+
+    auto stages = {
+            shaderStage(vk::ShaderStageFlagBits::eVertex, vertexShader),
+            shaderStage(vk::ShaderStageFlagBits::eFragment, fragmentShader)
+                    .setPSpecializationInfo(&specializationInfo)
+    };
+
+    auto vertexInputState = vk::PipelineVertexInputStateCreateInfo();
+
+    auto inputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo()
+            .setTopology(vk::PrimitiveTopology::eTriangleList);
+
+    auto viewportState = vk::PipelineViewportStateCreateInfo()
+            .setViewportCount(1)
+            .setScissorCount(1);
+
+    auto rasterizationState = vk::PipelineRasterizationStateCreateInfo()
+            .setPolygonMode(vk::PolygonMode::eFill)
+            .setCullMode(vk::CullModeFlagBits::eNone)
+            .setLineWidth(1.0f);
+
+    auto multisampleState = vk::PipelineMultisampleStateCreateInfo()
+            .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+
+    auto depthStencilState = vk::PipelineDepthStencilStateCreateInfo()
+            .setDepthTestEnable(false)
+            .setDepthWriteEnable(false);
+
+    auto colorBlendAttachment = vk::PipelineColorBlendAttachmentState()
+            .setColorWriteMask(vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                               vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+
+    auto colorBlendState = vk::PipelineColorBlendStateCreateInfo()
+            .setAttachments(colorBlendAttachment);
+
+    auto dynamicStates = {
+            vk::DynamicState::eViewport,
+            vk::DynamicState::eScissor
+    };
+
+    auto dynamicState = vk::PipelineDynamicStateCreateInfo()
+            .setDynamicStates(dynamicStates);
+
+    auto createInfo = vk::GraphicsPipelineCreateInfo()
+            .setStages(stages)
+            .setPVertexInputState(&vertexInputState)
+            .setPInputAssemblyState(&inputAssemblyState)
+            .setPViewportState(&viewportState)
+            .setPRasterizationState(&rasterizationState)
+            .setPMultisampleState(&multisampleState)
+            .setPDepthStencilState(&depthStencilState)
+            .setPColorBlendState(&colorBlendState)
+            .setPDynamicState(&dynamicState)
+            .setLayout(layout)
+            .setRenderPass(renderPass)
+            .setSubpass(2);
+
+    return device.createGraphicsPipeline(pipelineCache, createInfo).value;
+}
+
+static vk::Pipeline createShadowPipeline(const vk::Device &device, const vk::PipelineCache &pipelineCache,
+                                         const vk::ShaderModule &vertexShader,
+                                         const vk::PipelineLayout &layout,
+                                         const vk::RenderPass &renderPass) {
+    auto stages = {
+            shaderStage(vk::ShaderStageFlagBits::eVertex, vertexShader)
+    };
+
+    auto bindings = {
+            vk::VertexInputBindingDescription(0, sizeof(Vertex), vk::VertexInputRate::eVertex)
+    };
+
+    auto attributes = {
+            vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, pos))
+    };
+
+    auto vertexInputState = vk::PipelineVertexInputStateCreateInfo()
+            .setVertexBindingDescriptions(bindings)
+            .setVertexAttributeDescriptions(attributes);
+
+    auto inputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo()
+            .setTopology(vk::PrimitiveTopology::eTriangleList);
+
+    auto viewportState = vk::PipelineViewportStateCreateInfo()
+            .setViewportCount(1)
+            .setScissorCount(1);
+
+    // bias prevents surfaces from shadowing themselves
+    auto rasterizationState = vk::PipelineRasterizationStateCreateInfo()
+            .setPolygonMode(vk::PolygonMode::eFill)
+            .setCullMode(vk::CullModeFlagBits::eBack)
+            .setFrontFace(vk::FrontFace::eCounterClockwise)
+            .setDepthBiasEnable(true)
+            .setDepthBiasConstantFactor(1.25f)
+            .setDepthBiasSlopeFactor(1.75f)
+            .setLineWidth(1.0f);
+
+    auto multisampleState = vk::PipelineMultisampleStateCreateInfo()
+            .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+
+    auto depthStencilState = vk::PipelineDepthStencilStateCreateInfo()
+            .setDepthTestEnable(true)
+            .setDepthWriteEnable(true)
+            .setDepthCompareOp(vk::CompareOp::eLess);
+
+    auto colorBlendState = vk::PipelineColorBlendStateCreateInfo();
+
+    auto dynamicStates = {
+            vk::DynamicState::eViewport,
+            vk::DynamicState::eScissor
+    };
+
+    auto dynamicState = vk::PipelineDynamicStateCreateInfo()
+            .setDynamicStates(dynamicStates);
+
+    auto createInfo = vk::GraphicsPipelineCreateInfo()
+            .setStages(stages)
+            .setPVertexInputState(&vertexInputState)
+            .setPInputAssemblyState(&inputAssemblyState)
+            .setPViewportState(&viewportState)
+            .setPRasterizationState(&rasterizationState)
+            .setPMultisampleState(&multisampleState)
+            .setPDepthStencilState(&depthStencilState)
+            .setPColorBlendState(&colorBlendState)
+            .setPDynamicState(&dynamicState)
+            .setLayout(layout)
+            .setRenderPass(renderPass)
+            .setSubpass(0);
+
+    return device.createGraphicsPipeline(pipelineCache, createInfo).value;
+}
+
+static vk::Pipeline createCullPipeline(const vk::Device &device, const vk::PipelineCache &pipelineCache,
+                                       const vk::ShaderModule &computeShader,
+                                       const vk::PipelineLayout &layout) {
+    auto createInfo = vk::ComputePipelineCreateInfo()
+            .setStage(shaderStage(vk::ShaderStageFlagBits::eCompute, computeShader))
+            .setLayout(layout);
+
+    return device.createComputePipeline(pipelineCache, createInfo).value;
+}
+
+vk::ShaderModule SceneRenderStage::loadShader(const ResourceId &resourceId) {
+    auto resource = this->_resourceDatabase->tryGetResource(resourceId);
+
+    if (!resource.has_value()) {
+        throw EngineError(fmt::format("Shader {0} not found", resourceId));
+    }
+
+    auto lockedResource = resource.value().lock();
+
+    if (lockedResource->type() != SHADER_BINARY_RESOURCE) {
+        throw EngineError(fmt::format("Resource {0} is not a shader binary", resourceId));
+    }
+
+    auto resourceData = this->_resourceLoader->tryLoad(lockedResource);
+
+    if (!resourceData.has_value()) {
+        throw EngineError(fmt::format("Failed to load shader {0}", resourceId));
+    }
+
+    const auto &code = resourceData.value().lock()->data();
+
+    auto createInfo = vk::ShaderModuleCreateInfo()
+            .setCodeSize(code.size())
+            .setPCode(reinterpret_cast<const uint32_t *>(code.data()));
+
+    auto shaderModule = this->_logicalDevice->getHandle().createShaderModule(createInfo);
+
+    this->_resourceLoader->freeResource(resourceId);
+
+    return shaderModule;
+}
+
+void SceneRenderStage::initLayouts() {
+    auto device = this->_logicalDevice->getHandle();
+
+    // depth formats are not guaranteed to support linear filtering
+    auto shadowMapSamplerCreateInfo = vk::SamplerCreateInfo()
+            .setMagFilter(vk::Filter::eNearest)
+            .setMinFilter(vk::Filter::eNearest)
+            .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+            .setAddressModeU(vk::SamplerAddressMode::eClampToBorder)
+            .setAddressModeV(vk::SamplerAddressMode::eClampToBorder)
+            .setAddressModeW(vk::SamplerAddressMode::eClampToBorder)
+            .setBorderColor(vk::BorderColor::eFloatOpaqueWhite);
+
+    this->_shadowMapSampler = device.createSampler(shadowMapSamplerCreateInfo);
+
+    std::vector<vk::DescriptorSetLayoutBinding> instanceBindings = {
+            vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBuffer, 1,
+                                           vk::ShaderStageFlagBits::eVertex),
+            vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1,
+                                           vk::ShaderStageFlagBits::eVertex),
+            vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBuffer, 1,
+                                           vk::ShaderStageFlagBits::eVertex)
+    };
+
+    this->_instanceSetLayout = this->_descriptorAllocator->getLayout(instanceBindings);
+
+    // instances, batches, draw commands, draw count and visible instances
+    std::vector<vk::DescriptorSetLayoutBinding> cullBindings;
+
+    for (uint32_t binding = 0; binding < 5; binding++) {
+        cullBindings.emplace_back(binding, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute);
+    }
+
+    this->_cullSetLayout = this->_descriptorAllocator->getLayout(cullBindings);
+
+    std::vector<vk::DescriptorSetLayoutBinding> compositionBindings = {
+            vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eInputAttachment, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eInputAttachment, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eInputAttachment, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(3, vk::DescriptorType::eInputAttachment, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(4, vk::DescriptorType::eCombinedImageSampler, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(5, vk::DescriptorType::eUniformBuffer, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(6, vk::DescriptorType::eUniformBuffer, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(7, vk::DescriptorType::eUniformBuffer, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(8, vk::DescriptorType::eUniformBuffer, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(9, vk::DescriptorType::eStorageBuffer, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(10, vk::DescriptorType::eStorageBuffer, 1,
+                                           vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(11, vk::DescriptorType::eUniformBuffer, 1,
+                                           vk::ShaderStageFlagBits::eFragment)
+    };
+
+    this->_compositionSetLayout = this->_descriptorAllocator->getLayout(compositionBindings);
+
+    auto matrixPushConstant = vk::PushConstantRange(vk::ShaderStageFlagBits::eVertex, 0, sizeof(glm::mat4));
+
+    auto modelSetLayouts = {this->_textureTable->getSetLayout(), this->_instanceSetLayout};
+    this->_modelPipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo()
+                                                                     .setSetLayouts(modelSetLayouts)
+                                                                     .setPushConstantRanges(matrixPushConstant));
+
+    this->_compositionPipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo()
+                                                                           .setSetLayouts(
+                                                                                   this->_compositionSetLayout));
+
+    this->_shadowPipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo()
+                                                                      .setSetLayouts(this->_instanceSetLayout)
+                                                                      .setPushConstantRanges(matrixPushConstant));
+
+    auto cullPushConstant = vk::PushConstantRange(vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullConstants));
+
+    this->_cullPipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo()
+                                                                    .setSetLayouts(this->_cullSetLayout)
+                                                                    .setPushConstantRanges(cullPushConstant));
+}
+
+void SceneRenderStage::initShadowMap() {
+    auto device = this->_logicalDevice->getHandle();
+    auto atlasSize = this->_shadowAtlas.getAtlasSize();
+
+    ImageRequirements requirements = {
+            .usage = vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled |
+                     vk::ImageUsageFlagBits::eTransferDst,
+            .memoryProperties = vk::MemoryPropertyFlagBits::eDeviceLocal,
+            .extent = vk::Extent3D(atlasSize, atlasSize, 1),
+            .format = vk::Format::eD32Sfloat,
+            .layerCount = 1,
+            .samples = vk::SampleCountFlagBits::e1,
+            .imageFlags = std::nullopt,
+            .type = vk::ImageViewType::e2D,
+            .aspectMask = vk::ImageAspectFlagBits::eDepth
+    };
+
+    this->_shadowMap = this->_allocator->allocateImage(requirements).lock();
+
+    // atlas keeps tiles of previous frames, rendered tiles are cleared by shadow pass itself
+    auto attachment = vk::AttachmentDescription()
+            .setFormat(vk::Format::eD32Sfloat)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setLoadOp(vk::AttachmentLoadOp::eLoad)
+            .setStoreOp(vk::AttachmentStoreOp::eStore)
+            .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+            .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+            .setInitialLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+            .setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+
+    auto depthReference = vk::AttachmentReference(0, vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+    auto subpass = vk::SubpassDescription()
+            .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
+            .setPDepthStencilAttachment(&depthReference);
+
+    // atlas is sampled by composition of previous frame and by composition of current one
+    auto dependencies = {
+            vk::SubpassDependency()
+                    .setSrcSubpass(VK_SUBPASS_EXTERNAL)
+                    .setDstSubpass(0)
+                    .setSrcStageMask(vk::PipelineStageFlagBits::eFragmentShader)
+                    .setDstStageMask(vk::PipelineStageFlagBits::eEarlyFragmentTests |
+                                     vk::PipelineStageFlagBits::eLateFragmentTests)
+                    .setSrcAccessMask(vk::AccessFlags())
+                    .setDstAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentRead |
+                                      vk::AccessFlagBits::eDepthStencilAttachmentWrite),
+            vk::SubpassDependency()
+                    .setSrcSubpass(0)
+                    .setDstSubpass(VK_SUBPASS_EXTERNAL)
+                    .setSrcStageMask(vk::PipelineStageFlagBits::eLateFragmentTests)
+                    .setDstStageMask(vk::PipelineStageFlagBits::eFragmentShader)
+                    .setSrcAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+                    .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+    };
+
+    this->_shadowRenderPass = device.createRenderPass(vk::RenderPassCreateInfo()
+                                                              .setAttachments(attachment)
+                                                              .setSubpasses(subpass)
+                                                              .setDependencies(dependencies));
+
+    auto framebufferCreateInfo = vk::FramebufferCreateInfo()
+            .setRenderPass(this->_shadowRenderPass)
+            .setAttachments(this->_shadowMap->imageView)
+            .setWidth(atlasSize)
+            .setHeight(atlasSize)
+            .setLayers(1);
+
+    this->_shadowFramebuffer = device.createFramebuffer(framebufferCreateInfo);
+
+    // area of atlas without tiles is never rendered, but composition still expects it to be readable
+    auto oneShotBuffer = this->_commandManager->acquireOneShotBuffer();
+    auto commandBuffer = oneShotBuffer.commandBuffer;
+
+    commandBuffer.begin(vk::CommandBufferBeginInfo());
+
+    auto subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eDepth, 0, 1, 0, 1);
+
+    auto clearBarrier = vk::ImageMemoryBarrier()
+            .setOldLayout(vk::ImageLayout::eUndefined)
+            .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+            .setSrcAccessMask(vk::AccessFlags())
+            .setDstAccessMask(vk::AccessFlagBits::eTransferWrite)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(this->_shadowMap->image)
+            .setSubresourceRange(subresourceRange);
+
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+                                  vk::DependencyFlags(), nullptr, nullptr, clearBarrier);
+
+    commandBuffer.clearDepthStencilImage(this->_shadowMap->image, vk::ImageLayout::eTransferDstOptimal,
+                                         vk::ClearDepthStencilValue(1, 0), subresourceRange);
+
+    auto readBarrier = vk::ImageMemoryBarrier()
+            .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+            .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+            .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(this->_shadowMap->image)
+            .setSubresourceRange(subresourceRange);
+
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
+                                  vk::DependencyFlags(), nullptr, nullptr, readBarrier);
+
+    commandBuffer.end();
+
+    auto value = this->_timeline->submit(GpuSubmission{
+            .commandBuffers = {commandBuffer}
+    });
+    this->_timeline->wait(value);
+
+    this->_commandManager->releaseOneShotBuffer(oneShotBuffer);
+}
+
+void SceneRenderStage::destroyShadowMap() {
+    auto device = this->_logicalDevice->getHandle();
+
+    device.destroy(this->_shadowFramebuffer);
+    device.destroy(this->_shadowRenderPass);
+
+    this->_allocator->freeImage(this->_shadowMap);
+
+    this->_shadowMap = nullptr;
+}
+
+void SceneRenderStage::clearShadowCache() {
+    this->_shadowAtlas.reset(this->_shadowAtlasSize, this->_shadowMapSize, SHADOW_TILE_MIN_SIZE);
+    this->_shadowCache.clear();
+}
+
+SceneRenderStage::FrameResources &SceneRenderStage::getFrameResources(uint32_t frameIdx) {
+    auto allocateUniformBuffer = [this](vk::DeviceSize size) {
+        return this->reallocateBuffer(nullptr, size, vk::BufferUsageFlagBits::eUniformBuffer, true);
+    };
+
+    // resources are created lazily, as number of inflight frames could change at runtime
+    while (this->_frames.size() <= frameIdx) {
+        FrameResources frameResources = {
+                .instanceUploadBuffer = nullptr,
+                .instanceUploadCapacity = 0,
+                .visibleInstanceBuffer = nullptr,
+                .visibleInstanceCapacity = 0,
+                .visibleLayoutVersion = std::nullopt,
+                .batchBuffer = nullptr,
+                .drawCommandBuffer = nullptr,
+                .drawCountBuffer = nullptr,
+                .batchCapacity = 0,
+                .shadowBuffer = allocateUniformBuffer(sizeof(ShadowData) * this->_shadowMapCount),
+                .lightBuffer = allocateUniformBuffer(sizeof(LightData) * this->_lightCount),
+                .directionalLightBuffer = allocateUniformBuffer(sizeof(DirectionalLightData) *
+                                                                DIRECTIONAL_LIGHT_COUNT),
+                .cameraBuffer = allocateUniformBuffer(sizeof(CameraData)),
+                .sceneBuffer = allocateUniformBuffer(sizeof(SceneData)),
+                .clusterBuffer = this->reallocateBuffer(nullptr, sizeof(SceneLightCluster) * LIGHT_CLUSTER_COUNT,
+                                                        vk::BufferUsageFlagBits::eStorageBuffer, true),
+                .lightIndexBuffer = nullptr,
+                .lightIndexCapacity = 0,
+                .shadowInstanceBuffer = nullptr,
+                .shadowInstanceCapacity = 0,
+                .instanceSet = this->_descriptorAllocator->allocate(this->_instanceSetLayout),
+                .cullSet = this->_descriptorAllocator->allocate(this->_cullSetLayout),
+                .setsDirty = true
+        };
+
+        this->reserveInstanceUploads(frameResources, INITIAL_INSTANCE_CAPACITY);
+        this->reserveVisibleInstances(frameResources, INITIAL_INSTANCE_CAPACITY);
+        this->reserveBatches(frameResources, INITIAL_BATCH_CAPACITY);
+        this->reserveLightIndices(frameResources, INITIAL_LIGHT_INDEX_CAPACITY);
+        this->reserveShadowInstances(frameResources, INITIAL_INSTANCE_CAPACITY);
+
+        this->_frames.push_back(frameResources);
+    }
+
+    return this->_frames[frameIdx];
+}
+
+void SceneRenderStage::destroyFrameResources(const FrameResources &frameResources) {
+    this->_allocator->freeBuffer(frameResources.instanceUploadBuffer);
+    this->_allocator->freeBuffer(frameResources.visibleInstanceBuffer);
+    this->_allocator->freeBuffer(frameResources.batchBuffer);
+    this->_allocator->freeBuffer(frameResources.drawCommandBuffer);
+    this->_allocator->freeBuffer(frameResources.drawCountBuffer);
+    this->_allocator->freeBuffer(frameResources.shadowBuffer);
+    this->_allocator->freeBuffer(frameResources.lightBuffer);
+    this->_allocator->freeBuffer(frameResources.directionalLightBuffer);
+    this->_allocator->freeBuffer(frameResources.cameraBuffer);
+    this->_allocator->freeBuffer(frameResources.sceneBuffer);
+    this->_allocator->freeBuffer(frameResources.clusterBuffer);
+    this->_allocator->freeBuffer(frameResources.lightIndexBuffer);
+    this->_allocator->freeBuffer(frameResources.shadowInstanceBuffer);
+
+    this->_descriptorAllocator->free(this->_instanceSetLayout, frameResources.instanceSet);
+    this->_descriptorAllocator->free(this->_cullSetLayout, frameResources.cullSet);
+}
+
+std::shared_ptr<BufferView> SceneRenderStage::reallocateBuffer(const std::shared_ptr<BufferView> &buffer,
+                                                               vk::DeviceSize size,
+                                                               vk::BufferUsageFlags usage,
+                                                               bool hostVisible) {
+    // frame is retired at this point, so its buffer could be replaced; memory is released after that as well
+    if (buffer != nullptr) {
+        this->_allocator->freeBuffer(buffer);
+    }
+
+    auto memoryProperties = hostVisible
+                            ? vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+                            : vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    return this->_allocator->allocateBuffer(BufferRequirements{
+            .size = size,
+            .usage = usage,
+            .memoryProperties = memoryProperties
+    }, hostVisible).lock();
+}
+
+void SceneRenderStage::reserveInstanceSlots(uint32_t slotCount) {
+    if (this->_instanceBuffer != nullptr && this->_instanceCapacity >= slotCount) {
+        return;
+    }
+
+    auto capacity = std::max({slotCount, this->_instanceCapacity * 2, INITIAL_INSTANCE_CAPACITY});
+
+    this->_instanceBuffer = this->reallocateBuffer(this->_instanceBuffer, sizeof(SceneInstance) * capacity,
+                                                   vk::BufferUsageFlagBits::eStorageBuffer |
+                                                   vk::BufferUsageFlagBits::eTransferDst, false);
+    this->_instanceCapacity = capacity;
+
+    // new buffer has no instances yet, and sets of every frame still refer to previous one
+    this->_drawList.markAllDirty();
+
+    for (auto &frameResources: this->_frames) {
+        frameResources.setsDirty = true;
+    }
+}
+
+void SceneRenderStage::reserveInstanceUploads(FrameResources &frameResources, uint32_t instanceCount) {
+    if (frameResources.instanceUploadBuffer != nullptr && frameResources.instanceUploadCapacity >= instanceCount) {
+        return;
+    }
+
+    auto capacity = std::max({instanceCount, frameResources.instanceUploadCapacity * 2, INITIAL_INSTANCE_CAPACITY});
+
+    frameResources.instanceUploadBuffer = this->reallocateBuffer(frameResources.instanceUploadBuffer,
+                                                                 sizeof(SceneInstance) * capacity,
+                                                                 vk::BufferUsageFlagBits::eTransferSrc, true);
+    frameResources.instanceUploadCapacity = capacity;
+}
+
+void SceneRenderStage::reserveVisibleInstances(FrameResources &frameResources, uint32_t instanceCount) {
+    if (frameResources.visibleInstanceBuffer != nullptr && frameResources.visibleInstanceCapacity >= instanceCount) {
+        return;
+    }
+
+    auto capacity = std::max({instanceCount, frameResources.visibleInstanceCapacity * 2, INITIAL_INSTANCE_CAPACITY});
+
+    // list is written by cull shader, or by CPU when culling is disabled
+    frameResources.visibleInstanceBuffer = this->reallocateBuffer(frameResources.visibleInstanceBuffer,
+                                                                  sizeof(uint32_t) * capacity,
+                                                                  vk::BufferUsageFlagBits::eStorageBuffer,
+                                                                  !this->_gpuCulling);
+    frameResources.visibleInstanceCapacity = capacity;
+    frameResources.visibleLayoutVersion = std::nullopt;
+    frameResources.setsDirty = true;
+}
+
+void SceneRenderStage::reserveBatches(FrameResources &frameResources, uint32_t batchCount) {
+    if (frameResources.batchBuffer != nullptr && frameResources.batchCapacity >= batchCount) {
+        return;
+    }
+
+    auto capacity = std::max({batchCount, frameResources.batchCapacity * 2, INITIAL_BATCH_CAPACITY});
+    auto indirectUsage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer;
+
+    frameResources.batchBuffer = this->reallocateBuffer(frameResources.batchBuffer,
+                                                        sizeof(CullBatchData) * capacity,
+                                                        vk::BufferUsageFlagBits::eStorageBuffer, true);
+    frameResources.drawCommandBuffer = this->reallocateBuffer(frameResources.drawCommandBuffer,
+                                                              sizeof(vk::DrawIndexedIndirectCommand) * capacity,
+                                                              indirectUsage, true);
+    frameResources.drawCountBuffer = this->reallocateBuffer(frameResources.drawCountBuffer, sizeof(uint32_t),
+                                                            indirectUsage, true);
+    frameResources.batchCapacity = capacity;
+    frameResources.setsDirty = true;
+}
+
+void SceneRenderStage::reserveLightIndices(FrameResources &frameResources, uint32_t lightIndexCount) {
+    if (frameResources.lightIndexBuffer != nullptr && frameResources.lightIndexCapacity >= lightIndexCount) {
+        return;
+    }
+
+    auto capacity = std::max({lightIndexCount, frameResources.lightIndexCapacity * 2, INITIAL_LIGHT_INDEX_CAPACITY});
+
+    frameResources.lightIndexBuffer = this->reallocateBuffer(frameResources.lightIndexBuffer,
+                                                             sizeof(uint32_t) * capacity,
+                                                             vk::BufferUsageFlagBits::eStorageBuffer, true);
+    frameResources.lightIndexCapacity = capacity;
+}
+
+void SceneRenderStage::reserveShadowInstances(FrameResources &frameResources, uint32_t shadowInstanceCount) {
+    if (frameResources.shadowInstanceBuffer != nullptr &&
+        frameResources.shadowInstanceCapacity >= shadowInstanceCount) {
+        return;
+    }
+
+    auto capacity = std::max({shadowInstanceCount, frameResources.shadowInstanceCapacity * 2,
+                              INITIAL_INSTANCE_CAPACITY});
+
+    frameResources.shadowInstanceBuffer = this->reallocateBuffer(frameResources.shadowInstanceBuffer,
+                                                                 sizeof(uint32_t) * capacity,
+                                                                 vk::BufferUsageFlagBits::eStorageBuffer, true);
+    frameResources.shadowInstanceCapacity = capacity;
+    frameResources.setsDirty = true;
+}
+
+void SceneRenderStage::allocateFrameSets(FrameResources &frameResources) {
+    auto bufferInfo = [](const std::shared_ptr<BufferView> &buffer) {
+        return vk::DescriptorBufferInfo(buffer->buffer, buffer->offset, buffer->size);
+    };
+
+    // sets of frame resources are used only by their frame, which is retired at this point, so rewrite is safe
+    this->_instanceSet = frameResources.instanceSet;
+    this->_cullSet = frameResources.cullSet;
+
+    auto instanceInfos = {
+            bufferInfo(this->_instanceBuffer),
+            bufferInfo(frameResources.visibleInstanceBuffer),
+            bufferInfo(frameResources.shadowInstanceBuffer)
+    };
+
+    auto cullInfos = {
+            bufferInfo(this->_instanceBuffer),
+            bufferInfo(frameResources.batchBuffer),
+            bufferInfo(frameResources.drawCommandBuffer),
+            bufferInfo(frameResources.drawCountBuffer),
+            bufferInfo(frameResources.visibleInstanceBuffer)
+    };
+
+    std::vector<vk::WriteDescriptorSet> writes;
+
+    // consecutive bindings of same type are written at once
+    if (frameResources.setsDirty) {
+        writes.push_back(vk::WriteDescriptorSet()
+                                 .setDstSet(frameResources.instanceSet)
+                                 .setDstBinding(0)
+                                 .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                                 .setBufferInfo(instanceInfos));
+        writes.push_back(vk::WriteDescriptorSet()
+                                 .setDstSet(frameResources.cullSet)
+                                 .setDstBinding(0)
+                                 .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                                 .setBufferInfo(cullInfos));
+
+        frameResources.setsDirty = false;
+    }
+
+    // order of composition bindings, compact G-buffer gives depth in place of position
+    auto targetRefs = this->_compactGBuffer
+                      ? std::array{"SceneAlbedo", "SceneDepth", "ScenePackedNormal", "SceneSpecular"}
+                      : std::array{"SceneAlbedo", "ScenePosition", "SceneNormal", "SceneSpecular"};
+
+    std::vector<vk::DescriptorImageInfo> targetInfos;
+
+    for (const auto &targetRef: targetRefs) {
+        auto it = this->_targetViews.find(targetRef);
+
+        if (it != this->_targetViews.end()) {
+            targetInfos.emplace_back(nullptr, it->second, vk::ImageLayout::eShaderReadOnlyOptimal);
+        }
+    }
+
+    auto shadowMapInfo = vk::DescriptorImageInfo(this->_shadowMapSampler, this->_shadowMap->imageView,
+                                                 vk::ImageLayout::eShaderReadOnlyOptimal);
+
+    auto uniformInfos = {
+            bufferInfo(frameResources.shadowBuffer),
+            bufferInfo(frameResources.lightBuffer),
+            bufferInfo(frameResources.cameraBuffer),
+            bufferInfo(frameResources.sceneBuffer)
+    };
+
+    auto clusterInfos = {
+            bufferInfo(frameResources.clusterBuffer),
+            bufferInfo(frameResources.lightIndexBuffer)
+    };
+
+    auto directionalLightInfo = bufferInfo(frameResources.directionalLightBuffer);
+
+    // composition is skipped until targets of graph are available
+    if (targetInfos.size() == targetRefs.size()) {
+        auto compositionSet = this->_descriptorAllocator->allocateFrameSet(this->_frameIdx,
+                                                                           this->_compositionSetLayout);
+
+        writes.push_back(vk::WriteDescriptorSet()
+                                 .setDstSet(compositionSet)
+                                 .setDstBinding(0)
+                                 .setDescriptorType(vk::DescriptorType::eInputAttachment)
+                                 .setImageInfo(targetInfos));
+        writes.push_back(vk::WriteDescriptorSet()
+                                 .setDstSet(compositionSet)
+                                 .setDstBinding(4)
+                                 .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+                                 .setImageInfo(shadowMapInfo));
+        writes.push_back(vk::WriteDescriptorSet()
+                                 .setDstSet(compositionSet)
+                                 .setDstBinding(5)
+                                 .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+                                 .setBufferInfo(uniformInfos));
+        writes.push_back(vk::WriteDescriptorSet()
+                                 .setDstSet(compositionSet)
+                                 .setDstBinding(9)
+                                 .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                                 .setBufferInfo(clusterInfos));
+        writes.push_back(vk::WriteDescriptorSet()
+                                 .setDstSet(compositionSet)
+                                 .setDstBinding(11)
+                                 .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+                                 .setBufferInfo(directionalLightInfo));
+
+        this->_compositionSet = compositionSet;
+    }
+
+    this->_logicalDevice->getHandle().updateDescriptorSets(writes, nullptr);
+}
+
+void SceneRenderStage::prepareBatches(FrameResources &frameResources) {
+    const auto &instances = this->_drawList.getInstances();
+    const auto &batches = this->_drawList.getBatches();
+
+    this->reserveInstanceSlots(this->_drawList.getSlotCount());
+    this->reserveBatches(frameResources, static_cast<uint32_t>(batches.size()));
+
+    // only slots changed since previous frame are uploaded, adjacent ones are copied by single region
+    this->_uploadSlots = this->_drawList.getDirtySlots();
+    this->_drawList.clearDirty();
+
+    std::sort(this->_uploadSlots.begin(), this->_uploadSlots.end());
+
+    this->reserveInstanceUploads(frameResources, static_cast<uint32_t>(this->_uploadSlots.size()));
+
+    auto uploads = static_cast<SceneInstance *>(frameResources.instanceUploadBuffer->ptr.value());
+
+    for (uint32_t uploadIdx = 0; uploadIdx < this->_uploadSlots.size(); uploadIdx++) {
+        auto slot = this->_uploadSlots[uploadIdx];
+
+        uploads[uploadIdx] = instances[slot];
+
+        if (uploadIdx > 0 && this->_uploadSlots[uploadIdx - 1] + 1 == slot) {
+            this->_instanceCopies.back().size += sizeof(SceneInstance);
+            continue;
+        }
+
+        this->_instanceCopies.push_back(vk::BufferCopy()
+                                                .setSrcOffset(frameResources.instanceUploadBuffer->offset +
+                                                              sizeof(SceneInstance) * uploadIdx)
+                                                .setDstOffset(this->_instanceBuffer->offset +
+                                                              sizeof(SceneInstance) * slot)
+                                                .setSize(sizeof(SceneInstance)));
+    }
+
+    auto cullBatches = reinterpret_cast<CullBatchData *>(frameResources.batchBuffer->ptr.value());
+    auto drawCommands = reinterpret_cast<vk::DrawIndexedIndirectCommand *>(
+            frameResources.drawCommandBuffer->ptr.value());
+
+    // instance and draw counts are accumulated by cull shader
+    *reinterpret_cast<uint32_t *>(frameResources.drawCountBuffer->ptr.value()) = 0;
+
+    // batches keep their indices, so cost of the frame depends on number of meshes instead of props
+    uint32_t instanceCount = 0;
+
+    for (uint32_t batchIdx = 0; batchIdx < batches.size(); batchIdx++) {
+        const auto &batch = batches[batchIdx];
+        auto batchInstanceCount = static_cast<uint32_t>(batch.slots.size());
+
+        // free batch has no instances, so its command draws nothing
+        if (batchInstanceCount == 0) {
+            cullBatches[batchIdx] = CullBatchData{
+                    .bounds = glm::vec4(0),
+                    .indexCount = 0,
+                    .firstInstance = instanceCount,
+                    .instanceCount = 0
+            };
+
+            drawCommands[batchIdx] = vk::DrawIndexedIndirectCommand(0, 0, 0, 0, instanceCount);
+
+            continue;
+        }
+
+        // meshes are kept alive by draw list while they have instances
+        const auto &mesh = batch.mesh;
+
+        cullBatches[batchIdx] = CullBatchData{
+                .bounds = glm::vec4(mesh->boundsCenter, mesh->boundsRadius),
+                .indexCount = mesh->indexCount,
+                .firstInstance = instanceCount,
+                .instanceCount = batchInstanceCount
+        };
+
+        drawCommands[batchIdx] = vk::DrawIndexedIndirectCommand(mesh->indexCount, 0,
+                                                                mesh->firstIndex, mesh->vertexOffset,
+                                                                instanceCount);
+
+        this->_batches.push_back(DrawBatch{
+                .batchIdx = batchIdx,
+                .vertexOffset = mesh->vertexOffset,
+                .firstIndex = mesh->firstIndex,
+                .indexCount = mesh->indexCount,
+                .firstInstance = instanceCount,
+                .instanceCount = batchInstanceCount
+        });
+
+        instanceCount += batchInstanceCount;
+    }
+
+    this->reserveVisibleInstances(frameResources, instanceCount);
+
+    // without culling every instance is visible, so list changes only along with batches
+    if (!this->_gpuCulling && frameResources.visibleLayoutVersion != this->_drawList.getLayoutVersion()) {
+        auto visibleInstances = static_cast<uint32_t *>(frameResources.visibleInstanceBuffer->ptr.value());
+
+        for (const auto &batch: this->_batches) {
+            const auto &slots = batches[batch.batchIdx].slots;
+
+            std::memcpy(visibleInstances + batch.firstInstance, slots.data(), sizeof(uint32_t) * slots.size());
+        }
+
+        frameResources.visibleLayoutVersion = this->_drawList.getLayoutVersion();
+    }
+
+    // main thread could grow the pool while loading meshes, buffers are taken once per frame and old ones are
+    // released with deferral
+    this->_vertexBuffer = this->_geometryPool->getVertexBuffer();
+    this->_indexBuffer = this->_geometryPool->getIndexBuffer();
+}
+
+void SceneRenderStage::prepareUniforms(FrameResources &frameResources, const FramePacket &packet) {
+    const auto &camera = packet.camera.value();
+
+    auto aspect = static_cast<float>(this->_extent.width) / static_cast<float>(std::max(this->_extent.height, 1u));
+    auto projection = glm::perspective(camera.fov, aspect, camera.near, camera.far);
+
+    // glm follows OpenGL convention where Y axis of clip space points up
+    projection[1][1] *= -1;
+
+    this->_viewProjection = projection * camera.view;
+    this->_frustumPlanes = extractFrustumPlanes(this->_viewProjection);
+
+    // directional lights reach every pixel, so they are neither clustered nor indexed along with local ones
+    this->_localLights.clear();
+    this->_directionalLights.clear();
+
+    // local lights are uploaded only if their reach is visible, first of them get shadows and cluster slots
+    for (const auto &light: packet.lights) {
+        if (light.type == DIRECTIONAL_LIGHT_SOURCE) {
+            this->_directionalLights.push_back(&light);
+        } else if (intersectsFrustum(this->_frustumPlanes, glm::vec4(light.position, getLightRadius(light.range)))) {
+            this->_localLights.push_back(&light);
+        }
+    }
+
+    // shadows are not sampled until shadow pipeline is compiled, as shadow maps are not rendered before
+    auto shadowCount = this->_shadowPipeline.has_value()
+                       ? std::min(static_cast<uint32_t>(this->_localLights.size()), this->_shadowMapCount)
+                       : 0;
+    auto lightCount = std::min(static_cast<uint32_t>(this->_localLights.size()), this->_lightCount);
+    auto directionalCount = std::min(static_cast<uint32_t>(this->_directionalLights.size()),
+                                     DIRECTIONAL_LIGHT_COUNT);
+
+    auto lights = static_cast<LightData *>(frameResources.lightBuffer->ptr.value());
+
+    this->prepareShadowCache();
+
+    // cascades are fitted first, so directional shadows keep largest tiles when atlas is full
+    this->prepareCascades(frameResources, packet, aspect, directionalCount);
+    this->prepareShadows(frameResources, packet, projection, shadowCount);
+
+    // tiles of lights that no longer cast shadows are released
+    for (auto it = this->_shadowCache.begin(); it != this->_shadowCache.end();) {
+        if (it->second.packetIdx == packet.idx) {
+            it++;
+            continue;
+        }
+
+        this->_shadowAtlas.free(it->second.tile);
+        it = this->_shadowCache.erase(it);
+    }
+
+    for (uint32_t lightIdx = 0; lightIdx < lightCount; lightIdx++) {
+        const auto &light = *this->_localLights[lightIdx];
+
+        lights[lightIdx] = LightData{
+                .position = light.position,
+                .padding = 0,
+                .color = light.color,
+                .range = light.range
+        };
+    }
+
+    // shadows are cast by first lights, so clustered lights cover both
+    this->prepareLightClusters(frameResources, packet, projection, std::max(shadowCount, lightCount));
+
+    this->reserveShadowInstances(frameResources, static_cast<uint32_t>(this->_shadowInstances.size()));
+
+    if (!this->_shadowInstances.empty()) {
+        std::memcpy(frameResources.shadowInstanceBuffer->ptr.value(), this->_shadowInstances.data(),
+                    sizeof(uint32_t) * this->_shadowInstances.size());
+    }
+
+    auto tileSize = glm::vec2(static_cast<float>(this->_extent.width) / static_cast<float>(LIGHT_CLUSTER_X),
+                              static_cast<float>(this->_extent.height) / static_cast<float>(LIGHT_CLUSTER_Y));
+
+    *static_cast<CameraData *>(frameResources.cameraBuffer->ptr.value()) = CameraData{
+            .view = camera.view,
+            .position = camera.position,
+            .near = camera.near,
+            .tileSize = tileSize,
+            .sliceScale = this->_lightClusters.getSliceScale(),
+            .sliceBias = this->_lightClusters.getSliceBias(),
+            .inverseViewProjection = glm::inverse(this->_viewProjection),
+            .extent = glm::vec2(static_cast<float>(this->_extent.width), static_cast<float>(this->_extent.height))
+    };
+
+    *static_cast<SceneData *>(frameResources.sceneBuffer->ptr.value()) = SceneData{
+            .ambient = SCENE_AMBIENT,
+            .shadowCount = shadowCount,
+            .lightCount = lightCount,
+            .directionalCount = directionalCount
+    };
+}
+
+void SceneRenderStage::prepareShadowCache() {
+    // added, removed or reloaded props could be casters of any light
+    if (this->_drawList.isLayoutChanged()) {
+        this->clearShadowCache();
+    }
+
+    // depth ranges of cascades are fitted to casters again once any of them changes
+    if (this->_drawList.isLayoutChanged() || !this->_drawList.getChangedObjectIds().empty()) {
+        this->_castersTops.clear();
+    }
+}
+
+void SceneRenderStage::prepareShadows(FrameResources &frameResources, const FramePacket &packet,
+                                      const glm::mat4 &projection, uint32_t shadowCount) {
+    const auto &camera = packet.camera.value();
+
+    auto shadows = static_cast<ShadowData *>(frameResources.shadowBuffer->ptr.value());
+
+    for (uint32_t shadowIdx = 0; shadowIdx < shadowCount; shadowIdx++) {
+        const auto &light = *this->_localLights[shadowIdx];
+        auto matrix = light.projection * light.view;
+
+        // tile covers as many texels as light covers pixels on screen, camera inside of light gets largest tile
+        auto radius = getLightRadius(light.range);
+        auto distance = glm::length(light.position - camera.position);
+        auto coverage = distance > radius
+                        ? radius * std::abs(projection[1][1]) / distance * static_cast<float>(this->_extent.height)
+                        : std::numeric_limits<float>::max();
+        auto tileSize = static_cast<uint32_t>(std::min(coverage,
+                                                       static_cast<float>(this->_shadowAtlas.getMaxTileSize())));
+
+        // light volume could be off screen even if its reach is not, such shadow would not be sampled
+        ShadowCacheEntry *entry = nullptr;
+
+        if (intersectsFrustum(this->_frustumPlanes, getFrustumCorners(matrix))) {
+            entry = this->acquireShadowTile(ShadowKey(light.objectId, 0), tileSize, packet.idx);
+        }
+
+        if (entry != nullptr) {
+            this->updateShadowTile(*entry, matrix, light.dirty);
+        }
+
+        shadows[shadowIdx] = ShadowData{
+                .matrix = matrix,
+                .position = light.position,
+                .range = light.range,
+                .rect = entry != nullptr ? this->getShadowRect(entry->tile) : glm::vec4(0)
+        };
+    }
+}
+
+void SceneRenderStage::prepareCascades(FrameResources &frameResources, const FramePacket &packet,
+                                       float aspect, uint32_t directionalCount) {
+    const auto &camera = packet.camera.value();
+    auto inverseView = glm::inverse(camera.view);
+    auto tanHalfFov = std::tan(camera.fov / 2);
+
+    auto directionalLights = static_cast<DirectionalLightData *>(frameResources.directionalLightBuffer->ptr.value());
+
+    // practical split scheme: blend of logarithmic splits, which match perspective aliasing, and uniform ones
+    std::array<float, SHADOW_CASCADE_MAX_COUNT + 1> splits = {camera.near};
+
+    for (uint32_t cascadeIdx = 1; cascadeIdx <= this->_cascadeCount; cascadeIdx++) {
+        auto fraction = static_cast<float>(cascadeIdx) / static_cast<float>(this->_cascadeCount);
+        auto logSplit = camera.near * std::pow(camera.far / camera.near, fraction);
+        auto uniformSplit = camera.near + (camera.far - camera.near) * fraction;
+
+        splits[cascadeIdx] = SHADOW_CASCADE_SPLIT_LAMBDA * logSplit + (1 - SHADOW_CASCADE_SPLIT_LAMBDA) * uniformSplit;
+    }
+
+    for (uint32_t directionalIdx = 0; directionalIdx < directionalCount; directionalIdx++) {
+        const auto &light = *this->_directionalLights[directionalIdx];
+        auto direction = glm::normalize(light.forward);
+
+        auto data = DirectionalLightData{
+                .direction = direction,
+                .cascadeCount = this->_cascadeCount,
+                .color = light.color,
+                .padding = 0,
+                .splits = glm::vec4(std::numeric_limits<float>::max()),
+                .matrices = {},
+                .rects = {}
+        };
+
+        // light space keeps orientation of light only, so cascades move in whole texels along with camera
+        auto up = std::abs(direction.y) < 0.99f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
+        auto lightRotation = glm::lookAt(glm::vec3(0), direction, up);
+
+        // casters outside of slice still shadow it, so depth range reaches the farthest prop towards light; it is
+        // kept until light turns or casters change
+        auto &[castersDirection, castersTop] = this->_castersTops[light.objectId];
+
+        if (castersDirection != direction) {
+            castersDirection = direction;
+            castersTop = std::numeric_limits<float>::lowest();
+
+            for (const auto &batch: this->_drawList.getBatches()) {
+                for (uint32_t slot: batch.slots) {
+                    const auto &bounds = this->_drawList.getBounds(slot);
+
+                    castersTop = std::max(castersTop,
+                                          (lightRotation * glm::vec4(glm::vec3(bounds), 1)).z + bounds.w);
+                }
+            }
+        }
+
+        for (uint32_t cascadeIdx = 0; cascadeIdx < this->_cascadeCount; cascadeIdx++) {
+            auto sliceNear = splits[cascadeIdx];
+            auto sliceFar = splits[cascadeIdx + 1];
+
+            data.splits[static_cast<int>(cascadeIdx)] = sliceFar;
+
+            if (!this->_shadowPipeline.has_value()) {
+                continue;
+            }
+
+            auto entry = this->acquireShadowTile(ShadowKey(light.objectId, cascadeIdx),
+                                                 this->_shadowAtlas.getMaxTileSize(), packet.idx);
+
+            if (entry == nullptr) {
+                continue;
+            }
+
+            // bounding sphere of slice does not change with camera rotation, unlike its bounding box
+            std::array<glm::vec3, 8> corners;
+
+            for (uint32_t cornerIdx = 0; cornerIdx < corners.size(); cornerIdx++) {
+                auto depth = cornerIdx < 4 ? sliceNear : sliceFar;
+                auto halfHeight = depth * tanHalfFov;
+                auto halfWidth = halfHeight * aspect;
+
+                auto corner = glm::vec4((cornerIdx & 1) ? halfWidth : -halfWidth,
+                                        (cornerIdx & 2) ? halfHeight : -halfHeight,
+                                        -depth, 1);
+
+                corners[cornerIdx] = glm::vec3(inverseView * corner);
+            }
+
+            auto center = glm::vec3(0);
+
+            for (const auto &corner: corners) {
+                center += corner / static_cast<float>(corners.size());
+            }
+
+            auto radius = 0.0f;
+
+            for (const auto &corner: corners) {
+                radius = std::max(radius, glm::length(corner - center));
+            }
+
+            // radius is rounded, so size of texel stays the same while camera moves
+            radius = std::ceil(radius * 16.0f) / 16.0f;
+
+            auto texelSize = 2 * radius / static_cast<float>(entry->tile.size);
+            auto lightCenter = glm::vec3(lightRotation * glm::vec4(center, 1));
+
+            lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+            lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+            auto top = std::max(lightCenter.z + radius, castersTop);
+            auto view = glm::translate(glm::mat4(1), -glm::vec3(lightCenter.x, lightCenter.y, top)) * lightRotation;
+            auto projection = glm::ortho(-radius, radius, -radius, radius, 0.0f, top - (lightCenter.z - radius));
+            auto matrix = projection * view;
+
+            this->updateShadowTile(*entry, matrix, light.dirty);
+
+            data.matrices[cascadeIdx] = matrix;
+            data.rects[cascadeIdx] = this->getShadowRect(entry->tile);
+        }
+
+        directionalLights[directionalIdx] = data;
+    }
+}
+
+SceneRenderStage::ShadowCacheEntry *SceneRenderStage::acquireShadowTile(const ShadowKey &key, uint32_t size,
+                                                                        uint64_t packetIdx) {
+    auto tileSize = this->_shadowAtlas.getTileSize(size);
+    auto it = this->_shadowCache.find(key);
+
+    if (it == this->_shadowCache.end()) {
+        auto tile = this->_shadowAtlas.allocate(tileSize);
+
+        // atlas is full, so smaller tiles are tried before light is left without shadow
+        while (!tile.has_value() && tileSize > this->_shadowAtlas.getMinTileSize()) {
+            tileSize /= 2;
+            tile = this->_shadowAtlas.allocate(tileSize);
+        }
+
+        if (!tile.has_value()) {
+            return nullptr;
+        }
+
+        it = this->_shadowCache.emplace(key, ShadowCacheEntry{
+                .tile = tile.value(),
+                .matrix = glm::mat4(0),
+                .casterIds = {},
+                .valid = false,
+                .packetIdx = packetIdx
+        }).first;
+
+        return &it->second;
+    }
+
+    auto &entry = it->second;
+    entry.packetIdx = packetIdx;
+
+    // tile shrinks only when it is four times larger than needed, so camera motion does not re-render it
+    if (tileSize > entry.tile.size || tileSize * 4 <= entry.tile.size) {
+        auto tile = this->_shadowAtlas.allocate(tileSize);
+
+        if (tile.has_value()) {
+            this->_shadowAtlas.free(entry.tile);
+            entry.tile = tile.value();
+            entry.valid = false;
+        }
+    }
+
+    return &entry;
+}
+
+void SceneRenderStage::updateShadowTile(ShadowCacheEntry &entry, const glm::mat4 &matrix, bool dirty) {
+    const auto &changedObjectIds = this->_drawList.getChangedObjectIds();
+    const auto &changedBounds = this->_drawList.getChangedBounds();
+    auto planes = extractFrustumPlanes(matrix);
+
+    // matrix also changes with range, angle or type of light
+    if (entry.valid && !dirty && entry.matrix == matrix) {
+        // caster moved out of frustum, or anywhere inside of it
+        auto casterMoved = std::any_of(changedObjectIds.begin(), changedObjectIds.end(),
+                                       [&entry](uint64_t objectId) {
+                                           return std::binary_search(entry.casterIds.begin(), entry.casterIds.end(),
+                                                                     objectId);
+                                       });
+
+        auto boundsMoved = std::any_of(changedBounds.begin(), changedBounds.end(),
+                                       [&planes](const glm::vec4 &bounds) {
+                                           return intersectsFrustum(planes, bounds);
+                                       });
+
+        if (!casterMoved && !boundsMoved) {
+            return;
+        }
+    }
+
+    entry.matrix = matrix;
+    entry.casterIds.clear();
+    entry.valid = true;
+
+    auto firstDraw = static_cast<uint32_t>(this->_shadowDraws.size());
+    const auto &batches = this->_drawList.getBatches();
+
+    // instances of batch stay adjacent in caster list, so every batch is still a single draw
+    for (const auto &batch: this->_batches) {
+        auto firstShadowInstance = static_cast<uint32_t>(this->_shadowInstances.size());
+
+        for (uint32_t slot: batches[batch.batchIdx].slots) {
+            if (!intersectsFrustum(planes, this->_drawList.getBounds(slot))) {
+                continue;
+            }
+
+            this->_shadowInstances.push_back(slot);
+            entry.casterIds.push_back(this->_drawList.getObjectId(slot));
+        }
+
+        auto instanceCount = static_cast<uint32_t>(this->_shadowInstances.size()) - firstShadowInstance;
+
+        if (instanceCount == 0) {
+            continue;
+        }
+
+        this->_shadowDraws.push_back(ShadowDraw{
+                .vertexOffset = batch.vertexOffset,
+                .firstIndex = batch.firstIndex,
+                .indexCount = batch.indexCount,
+                .firstShadowInstance = firstShadowInstance,
+                .instanceCount = instanceCount
+        });
+    }
+
+    std::sort(entry.casterIds.begin(), entry.casterIds.end());
+
+    this->_shadowRenders.push_back(ShadowRender{
+            .matrix = matrix,
+            .tile = entry.tile,
+            .firstDraw = firstDraw,
+            .drawCount = static_cast<uint32_t>(this->_shadowDraws.size()) - firstDraw
+    });
+}
+
+glm::vec4 SceneRenderStage::getShadowRect(const SceneShadowTile &tile) {
+    auto atlasSize = static_cast<float>(this->_shadowAtlas.getAtlasSize());
+
+    return glm::vec4(static_cast<float>(tile.x), static_cast<float>(tile.y),
+                     static_cast<float>(tile.size), static_cast<float>(tile.size)) / atlasSize;
+}
+
+void SceneRenderStage::prepareLightClusters(FrameResources &frameResources, const FramePacket &packet,
+                                            const glm::mat4 &projection, uint32_t lightCount) {
+    const auto &camera = packet.camera.value();
+
+    this->_clusterLights.clear();
+
+    for (uint32_t lightIdx = 0; lightIdx < lightCount; lightIdx++) {
+        const auto &light = *this->_localLights[lightIdx];
+
+        this->_clusterLights.push_back(SceneClusterLight{
+                .position = light.position,
+                .radius = getLightRadius(light.range)
+        });
+    }
+
+    this->_lightClusters.build(camera.view, projection, camera.near, camera.far, this->_clusterLights);
+
+    const auto &clusters = this->_lightClusters.getClusters();
+    const auto &lightIndices = this->_lightClusters.getLightIndices();
+
+    this->reserveLightIndices(frameResources, static_cast<uint32_t>(lightIndices.size()));
+
+    std::memcpy(frameResources.clusterBuffer->ptr.value(), clusters.data(),
+                sizeof(SceneLightCluster) * clusters.size());
+
+    if (!lightIndices.empty()) {
+        std::memcpy(frameResources.lightIndexBuffer->ptr.value(), lightIndices.data(),
+                    sizeof(uint32_t) * lightIndices.size());
+    }
+}
+
+void SceneRenderStage::recordInstanceUpload(const vk::CommandBuffer &commandBuffer) {
+    if (this->_instanceCopies.empty()) {
+        return;
+    }
+
+    const auto &frameResources = this->_frames[this->_frameIdx];
+
+    // previous frames could still read slots that are overwritten
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eVertexShader,
+                                  vk::PipelineStageFlagBits::eTransfer,
+                                  vk::DependencyFlags(), nullptr, nullptr, nullptr);
+
+    commandBuffer.copyBuffer(frameResources.instanceUploadBuffer->buffer, this->_instanceBuffer->buffer,
+                             this->_instanceCopies);
+
+    auto barrier = vk::MemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                  vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eVertexShader,
+                                  vk::DependencyFlags(), barrier, nullptr, nullptr);
+}
+
+void SceneRenderStage::recordCulling(const vk::CommandBuffer &commandBuffer) {
+    auto slotCount = this->_drawList.getSlotCount();
+
+    if (slotCount == 0) {
+        return;
+    }
+
+    // free slots are skipped by shader, bounds of used ones are computed there from mesh bounds and model matrix
+    auto constants = CullConstants{
+            .planes = this->_frustumPlanes,
+            .slotCount = slotCount
+    };
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, this->_cullPipeline.value());
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, this->_cullPipelineLayout, 0,
+                                     this->_cullSet, nullptr);
+    commandBuffer.pushConstants(this->_cullPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0,
+                                sizeof(CullConstants), &constants);
+    commandBuffer.dispatch((slotCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    // draw commands and visible instances are consumed by model pass
+    auto barrier = vk::MemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead);
+
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                                  vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexShader,
+                                  vk::DependencyFlags(), barrier, nullptr, nullptr);
+}
+
+void SceneRenderStage::recordShadows(const vk::CommandBuffer &commandBuffer) {
+    if (!this->_shadowPipeline.has_value() || this->_shadowRenders.empty()) {
+        return;
+    }
+
+    auto atlasSize = this->_shadowAtlas.getAtlasSize();
+    auto clearValue = vk::ClearValue().setDepthStencil(vk::ClearDepthStencilValue(1, 0));
+
+    auto beginInfo = vk::RenderPassBeginInfo()
+            .setRenderPass(this->_shadowRenderPass)
+            .setFramebuffer(this->_shadowFramebuffer)
+            .setRenderArea(vk::Rect2D(vk::Offset2D(0, 0), vk::Extent2D(atlasSize, atlasSize)));
+
+    commandBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, this->_shadowPipeline.value());
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->_shadowPipelineLayout, 0,
+                                     this->_instanceSet, nullptr);
+    commandBuffer.bindVertexBuffers(0, this->_vertexBuffer, vk::DeviceSize(0));
+    commandBuffer.bindIndexBuffer(this->_indexBuffer, 0, vk::IndexType::eUint32);
+
+    for (const auto &shadowRender: this->_shadowRenders) {
+        const auto &tile = shadowRender.tile;
+        auto rect = vk::Rect2D(vk::Offset2D(static_cast<int32_t>(tile.x), static_cast<int32_t>(tile.y)),
+                               vk::Extent2D(tile.size, tile.size));
+
+        commandBuffer.setViewport(0, vk::Viewport(static_cast<float>(tile.x), static_cast<float>(tile.y),
+                                                  static_cast<float>(tile.size), static_cast<float>(tile.size),
+                                                  0, 1));
+        commandBuffer.setScissor(0, rect);
+
+        // only tile itself is cleared, rest of atlas keeps tiles of previous frames
+        commandBuffer.clearAttachments(vk::ClearAttachment(vk::ImageAspectFlagBits::eDepth, 0, clearValue),
+                                       vk::ClearRect(rect, 0, 1));
+
+        commandBuffer.pushConstants(this->_shadowPipelineLayout, vk::ShaderStageFlagBits::eVertex, 0,
+                                    sizeof(glm::mat4), &shadowRender.matrix);
+
+        // materials do not matter for depth, so there is no state to change between batches
+        for (uint32_t drawIdx = shadowRender.firstDraw;
+             drawIdx < shadowRender.firstDraw + shadowRender.drawCount;
+             drawIdx++) {
+            const auto &draw = this->_shadowDraws[drawIdx];
+
+            commandBuffer.drawIndexed(draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset,
+                                      draw.firstShadowInstance);
+        }
+    }
+
+    commandBuffer.endRenderPass();
+}
+
+void SceneRenderStage::recordModelBatches(const std::optional<vk::Pipeline> &pipeline, uint32_t fromIdx,
+                                          uint32_t toIdx, const vk::CommandBuffer &commandBuffer) {
+    if (!pipeline.has_value() || fromIdx >= toIdx) {
+        return;
+    }
+
+    // pipeline with culling reads instances only through visible list, which is not written without cull pass
+    if (this->_gpuCulling && !this->_cullingActive) {
+        return;
+    }
+
+    const auto &frameResources = this->_frames[this->_frameIdx];
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.value());
+    commandBuffer.setViewport(0, vk::Viewport(0, 0,
+                                              static_cast<float>(this->_extent.width),
+                                              static_cast<float>(this->_extent.height),
+                                              0, 1));
+    commandBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), this->_extent));
+    commandBuffer.pushConstants(this->_modelPipelineLayout, vk::ShaderStageFlagBits::eVertex, 0,
+                                sizeof(glm::mat4), &this->_viewProjection);
+    auto sets = {this->_textureTable->getSet(), this->_instanceSet};
+
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->_modelPipelineLayout, 0,
+                                     sets, nullptr);
+    commandBuffer.bindVertexBuffers(0, this->_vertexBuffer, vk::DeviceSize(0));
+    commandBuffer.bindIndexBuffer(this->_indexBuffer, 0, vk::IndexType::eUint32);
+
+    if (this->_gpuCulling) {
+        auto firstBatchIdx = this->_batches[fromIdx].batchIdx;
+        auto lastBatchIdx = this->_batches[toIdx - 1].batchIdx;
+
+        // count is one past the last visible batch of whole frame, so it never cuts off visible batches of range
+        commandBuffer.drawIndexedIndirectCount(
+                frameResources.drawCommandBuffer->buffer,
+                frameResources.drawCommandBuffer->offset + firstBatchIdx * sizeof(vk::DrawIndexedIndirectCommand),
+                frameResources.drawCountBuffer->buffer,
+                frameResources.drawCountBuffer->offset,
+                lastBatchIdx - firstBatchIdx + 1,
+                sizeof(vk::DrawIndexedIndirectCommand));
+
+        return;
+    }
+
+    // all batches share bound state, instances are read through visible list that holds all of them
+    for (uint32_t batchIdx = fromIdx; batchIdx < toIdx; batchIdx++) {
+        const auto &batch = this->_batches[batchIdx];
+
+        commandBuffer.drawIndexed(batch.indexCount, batch.instanceCount, batch.firstIndex, batch.vertexOffset,
+                                  batch.firstInstance);
+    }
+}
+
+void SceneRenderStage::recordComposition(const vk::CommandBuffer &commandBuffer) {
+    if (!this->_hasCamera ||
+        !this->_compositionPipeline.has_value() ||
+        !this->_compositionSet.has_value()) {
+        return;
+    }
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, this->_compositionPipeline.value());
+    commandBuffer.setViewport(0, vk::Viewport(0, 0,
+                                              static_cast<float>(this->_extent.width),
+                                              static_cast<float>(this->_extent.height),
+                                              0, 1));
+    commandBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), this->_extent));
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->_compositionPipelineLayout, 0,
+                                     this->_compositionSet.value(), nullptr);
+    commandBuffer.draw(3, 1, 0, 0);
+}
+
+SceneRenderStage::SceneRenderStage(const std::shared_ptr<Log> &log,
+                                   const std::shared_ptr<VarCollection> &varCollection,
+                                   const std::shared_ptr<ResourceDatabase> &resourceDatabase,
+                                   const std::shared_ptr<ResourceLoader> &resourceLoader,
+                                   const std::shared_ptr<GpuManager> &gpuManager)
+        : _log(log),
+          _varCollection(varCollection),
+          _resourceDatabase(resourceDatabase),
+          _resourceLoader(resourceLoader),
+          _gpuManager(gpuManager) {
+    //
+}
+
+void SceneRenderStage::init() {
+    if (this->_gpuManager->getPhysicalDeviceProxy().expired() ||
+        this->_gpuManager->getLogicalDeviceProxy().expired() ||
+        this->_gpuManager->getCommandManager().expired() ||
+        this->_gpuManager->getDescriptorAllocator().expired() ||
+        this->_gpuManager->getAllocator().expired() ||
+        this->_gpuManager->getGeometryPool().expired() ||
+        this->_gpuManager->getTextureTable().expired() ||
+        this->_gpuManager->getResourceManager().expired() ||
+        this->_gpuManager->getTimeline().expired() ||
+        this->_gpuManager->getDeletionQueue().expired() ||
+        this->_gpuManager->getPipelineCompiler().expired()) {
+        throw EngineError("GPU manager is not initialized");
+    }
+
+    this->_logicalDevice = this->_gpuManager->getLogicalDeviceProxy().lock();
+    this->_commandManager = this->_gpuManager->getCommandManager().lock();
+    this->_descriptorAllocator = this->_gpuManager->getDescriptorAllocator().lock();
+    this->_allocator = this->_gpuManager->getAllocator().lock();
+    this->_geometryPool = this->_gpuManager->getGeometryPool().lock();
+    this->_textureTable = this->_gpuManager->getTextureTable().lock();
+    this->_timeline = this->_gpuManager->getTimeline().lock();
+    this->_deletionQueue = this->_gpuManager->getDeletionQueue().lock();
+    this->_pipelineCompiler = this->_gpuManager->getPipelineCompiler().lock();
+
+    this->_shadowMapSize = std::max(
+            this->_varCollection->getIntOrDefault(RENDERING_SCENE_STAGE_SHADOW_MAP_SIZE, 1024), 1);
+    this->_shadowMapCount = std::max(
+            this->_varCollection->getIntOrDefault(RENDERING_SCENE_STAGE_SHADOW_MAP_COUNT, 32), 1);
+    this->_shadowAtlasSize = std::max(
+            this->_varCollection->getIntOrDefault(RENDERING_SCENE_STAGE_SHADOW_ATLAS_SIZE, 4096), 1);
+    this->_cascadeCount = std::clamp<int32_t>(
+            this->_varCollection->getIntOrDefault(RENDERING_SCENE_STAGE_SHADOW_CASCADE_COUNT, 4),
+            1, SHADOW_CASCADE_MAX_COUNT);
+    this->_lightCount = std::max(
+            this->_varCollection->getIntOrDefault(RENDERING_SCENE_STAGE_LIGHT_COUNT, 128), 1);
+
+    auto physicalDevice = this->_gpuManager->getPhysicalDeviceProxy().lock();
+
+    this->_gpuCulling = this->_varCollection->getBoolOrDefault(RENDERING_GPU_CULLING, true);
+
+    if (this->_gpuCulling && (!physicalDevice->getSupportedVulkan12Features().drawIndirectCount ||
+                              !physicalDevice->getSupportedFeatures().multiDrawIndirect)) {
+        this->_log->warning(SCENE_RENDER_STAGE_TAG, "Indirect count draws are not supported, GPU culling disabled");
+        this->_gpuCulling = false;
+    }
+
+    this->_depthPrepass = this->_varCollection->getBoolOrDefault(RENDERING_SCENE_STAGE_DEPTH_PREPASS, false);
+
+    try {
+        this->_modelVertexShader = this->loadShader("data/shaders/scene-model.vert.spv");
+        this->_modelFragmentShader = this->loadShader("data/shaders/scene-model.frag.spv");
+        this->_modelCompactFragmentShader = this->loadShader("data/shaders/scene-model-compact.frag.spv");
+        this->_depthVertexShader = this->loadShader("data/shaders/scene-depth.vert.spv");
+        this->_compositionVertexShader = this->loadShader("data/shaders/passthrough.vert.spv");
+        this->_compositionFragmentShader = this->loadShader("data/shaders/scene-composition.frag.spv");
+        this->_compositionMultisampledFragmentShader = this->loadShader(
+                "data/shaders/scene-composition-ms.frag.spv");
+        this->_compositionCompactFragmentShader = this->loadShader(
+                "data/shaders/scene-composition-compact.frag.spv");
+        this->_compositionCompactMultisampledFragmentShader = this->loadShader(
+                "data/shaders/scene-composition-compact-ms.frag.spv");
+        this->_shadowVertexShader = this->loadShader("data/shaders/shadow.vert.spv");
+        this->_cullComputeShader = this->loadShader("data/shaders/scene-cull.comp.spv");
+
+        this->initLayouts();
+
+        // atlas rounds its sizes, so image is sized after it
+        this->clearShadowCache();
+        this->initShadowMap();
+    } catch (const std::exception &error) {
+        this->_log->error(SCENE_RENDER_STAGE_TAG, error);
+        throw EngineError("Failed to initialize scene render stage");
+    }
+
+    // shadow pass does not depend on render graph, so its pipeline is compiled right away
+    this->_shadowPipelineKey = makePipelineKey(std::string_view("Scene.Shadow"),
+                                               static_cast<VkRenderPass>(this->_shadowRenderPass));
+    this->_shadowPipelineFactory = [vertexShader = this->_shadowVertexShader,
+            layout = this->_shadowPipelineLayout,
+            renderPass = this->_shadowRenderPass](const vk::Device &device, const vk::PipelineCache &pipelineCache) {
+        return createShadowPipeline(device, pipelineCache, vertexShader, layout, renderPass);
+    };
+
+    this->_shadowPipeline = this->_pipelineCompiler->tryGetPipeline(this->_shadowPipelineKey,
+                                                                    this->_shadowPipelineFactory);
+
+    this->_cullPipelineKey = makePipelineKey(std::string_view("Scene.Cull"));
+    this->_cullPipelineFactory = [computeShader = this->_cullComputeShader,
+            layout = this->_cullPipelineLayout](const vk::Device &device, const vk::PipelineCache &pipelineCache) {
+        return createCullPipeline(device, pipelineCache, computeShader, layout);
+    };
+
+    if (this->_gpuCulling) {
+        this->_cullPipeline = this->_pipelineCompiler->tryGetPipeline(this->_cullPipelineKey,
+                                                                      this->_cullPipelineFactory);
+    }
+}
+
+void SceneRenderStage::destroy() {
+    auto device = this->_logicalDevice->getHandle();
+
+    for (const auto &frameResources: this->_frames) {
+        this->destroyFrameResources(frameResources);
+    }
+
+    this->_frames.clear();
+
+    if (this->_instanceBuffer != nullptr) {
+        this->_allocator->freeBuffer(this->_instanceBuffer);
+        this->_instanceBuffer = nullptr;
+        this->_instanceCapacity = 0;
+    }
+
+    // slots are delivered again by packets of next renderer, which starts with empty list as well
+    this->_drawList.clear();
+    this->_castersTops.clear();
+
+    this->_pipelineCompiler->release(this->_shadowPipelineKey);
+    this->_pipelineCompiler->release(this->_cullPipelineKey);
+    this->_shadowPipeline = std::nullopt;
+    this->_cullPipeline = std::nullopt;
+
+    this->destroyShadowMap();
+    this->_shadowCache.clear();
+
+    device.destroy(this->_cullPipelineLayout);
+    device.destroy(this->_shadowPipelineLayout);
+    device.destroy(this->_compositionPipelineLayout);
+    device.destroy(this->_modelPipelineLayout);
+    device.destroy(this->_shadowMapSampler);
+
+    device.destroy(this->_cullComputeShader);
+    device.destroy(this->_shadowVertexShader);
+    device.destroy(this->_compositionCompactMultisampledFragmentShader);
+    device.destroy(this->_compositionCompactFragmentShader);
+    device.destroy(this->_compositionMultisampledFragmentShader);
+    device.destroy(this->_compositionFragmentShader);
+    device.destroy(this->_compositionVertexShader);
+    device.destroy(this->_depthVertexShader);
+    device.destroy(this->_modelCompactFragmentShader);
+    device.destroy(this->_modelFragmentShader);
+    device.destroy(this->_modelVertexShader);
+
+    this->_pipelineCompiler = nullptr;
+    this->_deletionQueue = nullptr;
+    this->_timeline = nullptr;
+    this->_textureTable = nullptr;
+    this->_geometryPool = nullptr;
+    this->_allocator = nullptr;
+    this->_descriptorAllocator = nullptr;
+    this->_commandManager = nullptr;
+    this->_logicalDevice = nullptr;
+}
+
+void SceneRenderStage::onGraphCreate(const std::shared_ptr<Swapchain> swapchain,
+                                     const vk::RenderPass &renderPass,
+                                     vk::SampleCountFlagBits sampleCount) {
+    this->_swapchain = swapchain;
+    this->_renderPass = renderPass;
+
+    this->_depthPipelineKey = makePipelineKey(std::string_view("Scene.Depth"),
+                                              static_cast<VkRenderPass>(renderPass),
+                                              static_cast<uint32_t>(sampleCount));
+    this->_depthPipelineFactory = [vertexShader = this->_depthVertexShader,
+            layout = this->_modelPipelineLayout,
+            renderPass,
+            sampleCount](const vk::Device &device, const vk::PipelineCache &pipelineCache) {
+        return createDepthPipeline(device, pipelineCache, vertexShader, layout, renderPass, sampleCount);
+    };
+
+    this->_modelPipelineKey = makePipelineKey(std::string_view("Scene.Model"),
+                                              static_cast<VkRenderPass>(renderPass),
+                                              static_cast<uint32_t>(sampleCount),
+                                              this->_depthPrepass,
+                                              this->_compactGBuffer);
+    this->_modelPipelineFactory = [vertexShader = this->_modelVertexShader,
+            fragmentShader = this->_compactGBuffer ? this->_modelCompactFragmentShader : this->_modelFragmentShader,
+            layout = this->_modelPipelineLayout,
+            renderPass,
+            sampleCount,
+            depthPrepass = this->_depthPrepass,
+            compactGBuffer = this->_compactGBuffer](const vk::Device &device, const vk::PipelineCache &pipelineCache) {
+        return createModelPipeline(device, pipelineCache, vertexShader, fragmentShader, layout, renderPass,
+                                   sampleCount, depthPrepass, compactGBuffer);
+    };
+
+    // multisampled G-buffer is read per sample, such input attachments need shader variant of their own
+    auto compositionFragmentShader = sampleCount == vk::SampleCountFlagBits::e1
+                                     ? (this->_compactGBuffer
+                                        ? this->_compositionCompactFragmentShader
+                                        : this->_compositionFragmentShader)
+                                     : (this->_compactGBuffer
+                                        ? this->_compositionCompactMultisampledFragmentShader
+                                        : this->_compositionMultisampledFragmentShader);
+
+    this->_compositionPipelineKey = makePipelineKey(std::string_view("Scene.Composition"),
+                                                    static_cast<VkRenderPass>(renderPass),
+                                                    this->_shadowMapCount,
+                                                    this->_lightCount,
+                                                    static_cast<uint32_t>(sampleCount),
+                                                    this->_compactGBuffer);
+    this->_compositionPipelineFactory = [vertexShader = this->_compositionVertexShader,
+            fragmentShader = compositionFragmentShader,
+            layout = this->_compositionPipelineLayout,
+            renderPass,
+            shadowCount = this->_shadowMapCount,
+            lightCount = this->_lightCount,
+            sampleCount](const vk::Device &device, const vk::PipelineCache &pipelineCache) {
+        return createCompositionPipeline(device, pipelineCache, vertexShader, fragmentShader, layout, renderPass,
+                                         shadowCount, lightCount, sampleCount);
+    };
+
+    // compilation starts before the first frame needs pipelines
+    if (this->_depthPrepass) {
+        this->_depthPipeline = this->_pipelineCompiler->tryGetPipeline(this->_depthPipelineKey,
+                                                                       this->_depthPipelineFactory);
+    }
+
+    this->_modelPipeline = this->_pipelineCompiler->tryGetPipeline(this->_modelPipelineKey,
+                                                                   this->_modelPipelineFactory);
+    this->_compositionPipeline = this->_pipelineCompiler->tryGetPipeline(this->_compositionPipelineKey,
+                                                                         this->_compositionPipelineFactory);
+}
+
+void SceneRenderStage::onGraphDestroy() {
+    this->_pipelineCompiler->release(this->_depthPipelineKey);
+    this->_pipelineCompiler->release(this->_modelPipelineKey);
+    this->_pipelineCompiler->release(this->_compositionPipelineKey);
+
+    this->_depthPipeline = std::nullopt;
+    this->_modelPipeline = std::nullopt;
+    this->_compositionPipeline = std::nullopt;
+    this->_batches.clear();
+
+    // targets are freed along with graph, so composition set is not written until they are recreated
+    this->_targetViews.clear();
+
+    this->_renderPass = nullptr;
+    this->_swapchain = nullptr;
+}
+
+void SceneRenderStage::onTargetsUpdate(const RenderTargetViews &views) {
+    this->_targetViews = views;
+
+    // packets could be dropped while graph or swapchain were recreated, changes of lights they carried are lost
+    this->clearShadowCache();
+}
+
+void SceneRenderStage::onPacket(const FramePacket &packet) {
+    // changes are accumulated until the next rendered frame uploads them
+    this->_drawList.apply(packet);
+}
+
+void SceneRenderStage::onFrameBegin(const RenderFrame &frame) {
+    this->_frameIdx = frame.frameIdx;
+    this->_hasCamera = frame.packet->camera.has_value();
+    this->_extent = frame.renderExtent;
+
+    this->_batches.clear();
+    this->_instanceCopies.clear();
+    this->_compositionSet = std::nullopt;
+    this->_shadowRenders.clear();
+    this->_shadowDraws.clear();
+    this->_shadowInstances.clear();
+
+    this->_modelPipeline = this->_pipelineCompiler->tryGetPipeline(this->_modelPipelineKey,
+                                                                   this->_modelPipelineFactory);
+
+    if (this->_depthPrepass) {
+        this->_depthPipeline = this->_pipelineCompiler->tryGetPipeline(this->_depthPipelineKey,
+                                                                       this->_depthPipelineFactory);
+
+        // equal depth test passes nothing until prepass writes depth
+        if (!this->_depthPipeline.has_value()) {
+            this->_modelPipeline = std::nullopt;
+        }
+    }
+    this->_compositionPipeline = this->_pipelineCompiler->tryGetPipeline(this->_compositionPipelineKey,
+                                                                         this->_compositionPipelineFactory);
+    this->_shadowPipeline = this->_pipelineCompiler->tryGetPipeline(this->_shadowPipelineKey,
+                                                                    this->_shadowPipelineFactory);
+
+    if (this->_gpuCulling) {
+        this->_cullPipeline = this->_pipelineCompiler->tryGetPipeline(this->_cullPipelineKey,
+                                                                      this->_cullPipelineFactory);
+    }
+
+    this->_cullingActive = this->_gpuCulling && this->_hasCamera && this->_cullPipeline.has_value();
+
+    if (!this->_hasCamera) {
+        // shadows are not tracked without camera, so changes of this packet are not reflected by them; slots stay
+        // dirty until frame with camera uploads them
+        this->clearShadowCache();
+        this->_drawList.clearChanges();
+
+        return;
+    }
+
+    auto &frameResources = this->getFrameResources(frame.frameIdx);
+
+    this->prepareBatches(frameResources);
+    this->prepareUniforms(frameResources, *frame.packet);
+    this->allocateFrameSets(frameResources);
+
+    this->_drawList.clearChanges();
+}
+
+void SceneRenderStage::onPreExecute(const vk::CommandBuffer &commandBuffer) {
+    this->recordInstanceUpload(commandBuffer);
+
+    if (this->_cullingActive) {
+        this->recordCulling(commandBuffer);
+    }
+
+    this->recordShadows(commandBuffer);
+}
+
+void SceneRenderStage::onPassExecute(const RenderPassRef &passRef, const vk::CommandBuffer &commandBuffer) {
+    if (passRef == "Depth") {
+        this->recordModelBatches(this->_depthPipeline, 0, static_cast<uint32_t>(this->_batches.size()),
+                                 commandBuffer);
+    } else if (passRef == "Model") {
+        this->recordModelBatches(this->_modelPipeline, 0, static_cast<uint32_t>(this->_batches.size()),
+                                 commandBuffer);
+    } else if (passRef == "Composition") {
+        this->recordComposition(commandBuffer);
+    } else {
+        throw EngineError(fmt::format("Unknown pass {0}", passRef));
+    }
+}
+
+uint32_t SceneRenderStage::getPassChunkCount(const RenderPassRef &passRef) {
+    if (passRef != "Depth" && passRef != "Model") {
+        return 1;
+    }
+
+    auto chunkCount = (static_cast<uint32_t>(this->_batches.size()) + MODEL_PASS_CHUNK_SIZE - 1) /
+                      MODEL_PASS_CHUNK_SIZE;
+
+    return std::clamp<uint32_t>(chunkCount, 1, MODEL_PASS_MAX_CHUNK_COUNT);
+}
+
+void SceneRenderStage::onPassChunkExecute(const RenderPassRef &passRef,
+                                          uint32_t chunkIdx,
+                                          uint32_t chunkCount,
+                                          const vk::CommandBuffer &commandBuffer) {
+    if (passRef != "Depth" && passRef != "Model") {
+        this->onPassExecute(passRef, commandBuffer);
+        return;
+    }
+
+    const auto &pipeline = passRef == "Depth" ? this->_depthPipeline : this->_modelPipeline;
+    auto batchCount = static_cast<uint32_t>(this->_batches.size());
+
+    this->recordModelBatches(pipeline, batchCount * chunkIdx / chunkCount, batchCount * (chunkIdx + 1) / chunkCount,
+                             commandBuffer);
+}
+
+RenderSubgraph SceneRenderStage::asSubgraph() {
+    // layout of G-buffer is chosen along with subgraph, which is built before stage is initialized
+    this->_compactGBuffer = this->_varCollection->getBoolOrDefault(RENDERING_SCENE_STAGE_COMPACT_GBUFFER, false);
+
+    auto gbufferAttachment = [](uint32_t idx, const RenderTargetRef &targetRef) {
+        return RenderAttachment{
+                .idx = idx,
+                .targetRef = targetRef,
+                .loadOp = vk::AttachmentLoadOp::eClear,
+                .storeOp = vk::AttachmentStoreOp::eDontCare,
+                .initialLayout = vk::ImageLayout::eUndefined,
+                .finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal
+        };
+    };
+
+    auto depthAttachment = [](uint32_t idx) {
+        return RenderAttachment{
+                .idx = idx,
+                .targetRef = "SceneDepth",
+                .loadOp = vk::AttachmentLoadOp::eClear,
+                .storeOp = vk::AttachmentStoreOp::eDontCare,
+                .initialLayout = vk::ImageLayout::eUndefined,
+                .finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal
+        };
+    };
+
+    std::map<RenderAttachmentRef, RenderAttachment> attachments = {
+            {
+                    "SceneColor",
+                    RenderAttachment{
+                            .idx = 0,
+                            .targetRef = "SceneColor",
+                            .loadOp = vk::AttachmentLoadOp::eClear,
+                            .storeOp = vk::AttachmentStoreOp::eStore,
+                            .initialLayout = vk::ImageLayout::eUndefined,
+                            .finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal
+                    }
+            },
+            {"SceneAlbedo", gbufferAttachment(1, "SceneAlbedo")}
+    };
+
+    // written by model pass and read by composition in order of its bindings
+    std::vector<RenderAttachmentRef> gbufferRefs;
+    std::vector<RenderAttachmentRef> compositionRefs;
+
+    if (this->_compactGBuffer) {
+        attachments["SceneNormal"] = gbufferAttachment(2, "ScenePackedNormal");
+        attachments["SceneSpecular"] = gbufferAttachment(3, "SceneSpecular");
+        attachments["SceneDepth"] = depthAttachment(4);
+
+        gbufferRefs = {"SceneAlbedo", "SceneNormal", "SceneSpecular"};
+        compositionRefs = {"SceneAlbedo", "SceneDepth", "SceneNormal", "SceneSpecular"};
+    } else {
+        attachments["ScenePosition"] = gbufferAttachment(2, "ScenePosition");
+        attachments["SceneNormal"] = gbufferAttachment(3, "SceneNormal");
+        attachments["SceneSpecular"] = gbufferAttachment(4, "SceneSpecular");
+        attachments["SceneDepth"] = depthAttachment(5);
+
+        gbufferRefs = {"SceneAlbedo", "ScenePosition", "SceneNormal", "SceneSpecular"};
+        compositionRefs = gbufferRefs;
+    }
+
+    return RenderSubgraph{
+            .attachments = attachments,
+            .passes = {
+                    {
+                            // records nothing without prepass, kept so layout of render pass does not depend on it
+                            "Depth",
+                            RenderPass{
+                                    .idx = 0,
+                                    .inputRefs = {},
+                                    .colorRefs = {},
+                                    .depthRef = "SceneDepth",
+                                    .resolveRefs = {},
+                                    .dependencies = {}
+                            }
+                    },
+                    {
+                            "Model",
+                            RenderPass{
+                                    .idx = 1,
+                                    .inputRefs = {},
+                                    .colorRefs = gbufferRefs,
+                                    .depthRef = "SceneDepth",
+                                    .resolveRefs = {},
+                                    .dependencies = {
+                                            "Depth"
+                                    }
+                            }
+                    },
+                    {
+                            "Composition",
+                            RenderPass{
+                                    .idx = 2,
+                                    .inputRefs = compositionRefs,
+                                    .colorRefs = {
+                                            "SceneColor"
+                                    },
+                                    .depthRef = std::nullopt,
+                                    .resolveRefs = {},
+                                    .dependencies = {
+                                            "Model"
+                                    }
+                            }
+                    }
+            },
+            .firstPass = "Depth",
+            .next = {}
+    };
+}
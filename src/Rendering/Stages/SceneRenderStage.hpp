@@ -0,0 +1,310 @@
+#ifndef RENDERING_STAGES_SCENERENDERSTAGE_HPP
+#define RENDERING_STAGES_SCENERENDERSTAGE_HPP
+
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "src/Rendering/PipelineCompiler.hpp"
+#include "src/Rendering/Graph/RenderStage.hpp"
+#include "src/Rendering/Stages/SceneDrawList.hpp"
+#include "src/Rendering/Stages/SceneLightClusters.hpp"
+#include "src/Rendering/Stages/SceneShadowAtlas.hpp"
+#include "src/Resources/ResourceId.hpp"
+
+class Log;
+class VarCollection;
+class ResourceDatabase;
+class ResourceLoader;
+
+class CommandManager;
+class DeletionQueue;
+class DescriptorAllocator;
+class GeometryPool;
+class GpuAllocator;
+class GpuManager;
+class GpuTimeline;
+class LogicalDeviceProxy;
+class TextureTable;
+struct BufferView;
+struct ImageView;
+struct FrameLight;
+struct FramePacket;
+
+// Deferred scene rendering: shadow maps of lights, G-buffer of props and composition into scene color, which is
+// rendered at scaled extent and upscaled to swapchain by UpscaleRenderStage. Props are drawn in instanced batches from
+// shared geometry buffers, per-instance transforms and texture indices are read by shaders from persistent storage
+// buffer, where every prop keeps its slot and only slots changed by packets are uploaded. With GPU culling instances
+// are tested against camera frustum by compute shader, which also writes indirect draw commands, so CPU cost of the
+// frame depends on number of changed props and meshes rather than number of props.
+// Optional depth prepass draws positions only, so G-buffer is then shaded once per pixel with equal depth test.
+// Compact G-buffer drops position, which composition reconstructs from depth, and packs normals into two channels.
+// Lights are binned into view space clusters, so composition evaluates only lights that reach the pixel. Shadow maps
+// are tiles of single atlas sized by screen coverage of their light, tiles are re-rendered only when their light or its
+// casters move. Directional lights are shadowed by cascades fitted to depth slices of camera frustum. Local lights
+// outside of camera frustum are culled on CPU, shadow maps draw only instances inside of light volume.
+class SceneRenderStage : public RenderStage {
+private:
+    struct FrameResources {
+        std::shared_ptr<BufferView> instanceUploadBuffer;
+        uint32_t instanceUploadCapacity;
+        std::shared_ptr<BufferView> visibleInstanceBuffer;
+        uint32_t visibleInstanceCapacity;
+
+        // layout of draw list that visible instances were written for when culling is disabled
+        std::optional<uint64_t> visibleLayoutVersion;
+        std::shared_ptr<BufferView> batchBuffer;
+        std::shared_ptr<BufferView> drawCommandBuffer;
+        std::shared_ptr<BufferView> drawCountBuffer;
+        uint32_t batchCapacity;
+        std::shared_ptr<BufferView> shadowBuffer;
+        std::shared_ptr<BufferView> lightBuffer;
+        std::shared_ptr<BufferView> directionalLightBuffer;
+        std::shared_ptr<BufferView> cameraBuffer;
+        std::shared_ptr<BufferView> sceneBuffer;
+        std::shared_ptr<BufferView> clusterBuffer;
+        std::shared_ptr<BufferView> lightIndexBuffer;
+        uint32_t lightIndexCapacity;
+        std::shared_ptr<BufferView> shadowInstanceBuffer;
+        uint32_t shadowInstanceCapacity;
+
+        // long-lived sets, rewritten only when their buffers are reallocated
+        vk::DescriptorSet instanceSet;
+        vk::DescriptorSet cullSet;
+        bool setsDirty;
+    };
+
+    struct DrawBatch {
+        uint32_t batchIdx;
+        int32_t vertexOffset;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+    };
+
+    // object id of light and index of its cascade, lights without cascades use the first one
+    using ShadowKey = std::pair<uint64_t, uint32_t>;
+
+    struct ShadowCacheEntry {
+        SceneShadowTile tile;
+        glm::mat4 matrix;
+
+        // sorted object ids of props that were inside of light frustum when tile was rendered
+        std::vector<uint64_t> casterIds;
+
+        // tile was rendered since it was allocated
+        bool valid;
+
+        // last packet that used tile, tiles unused by current packet are released
+        uint64_t packetIdx;
+    };
+
+    // instances of batch that are inside of light volume
+    struct ShadowDraw {
+        int32_t vertexOffset;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t firstShadowInstance;
+        uint32_t instanceCount;
+    };
+
+    struct ShadowRender {
+        glm::mat4 matrix;
+        SceneShadowTile tile;
+        uint32_t firstDraw;
+        uint32_t drawCount;
+    };
+
+    std::shared_ptr<Log> _log;
+    std::shared_ptr<VarCollection> _varCollection;
+    std::shared_ptr<ResourceDatabase> _resourceDatabase;
+    std::shared_ptr<ResourceLoader> _resourceLoader;
+    std::shared_ptr<GpuManager> _gpuManager;
+
+    std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+    std::shared_ptr<CommandManager> _commandManager;
+    std::shared_ptr<DescriptorAllocator> _descriptorAllocator;
+    std::shared_ptr<GpuAllocator> _allocator;
+    std::shared_ptr<GeometryPool> _geometryPool;
+    std::shared_ptr<GpuTimeline> _timeline;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
+    std::shared_ptr<PipelineCompiler> _pipelineCompiler;
+    std::shared_ptr<TextureTable> _textureTable;
+
+    uint32_t _shadowMapSize;
+    uint32_t _shadowMapCount;
+    uint32_t _shadowAtlasSize;
+    uint32_t _cascadeCount;
+    uint32_t _lightCount;
+    bool _gpuCulling;
+    bool _depthPrepass;
+    bool _compactGBuffer;
+
+    vk::ShaderModule _modelVertexShader;
+    vk::ShaderModule _modelFragmentShader;
+    vk::ShaderModule _modelCompactFragmentShader;
+    vk::ShaderModule _depthVertexShader;
+    vk::ShaderModule _compositionVertexShader;
+    vk::ShaderModule _compositionFragmentShader;
+    vk::ShaderModule _compositionMultisampledFragmentShader;
+    vk::ShaderModule _compositionCompactFragmentShader;
+    vk::ShaderModule _compositionCompactMultisampledFragmentShader;
+    vk::ShaderModule _shadowVertexShader;
+    vk::ShaderModule _cullComputeShader;
+
+    vk::Sampler _shadowMapSampler;
+
+    vk::DescriptorSetLayout _instanceSetLayout;
+    vk::DescriptorSetLayout _cullSetLayout;
+    vk::DescriptorSetLayout _compositionSetLayout;
+    vk::PipelineLayout _modelPipelineLayout;
+    vk::PipelineLayout _compositionPipelineLayout;
+    vk::PipelineLayout _shadowPipelineLayout;
+    vk::PipelineLayout _cullPipelineLayout;
+
+    std::shared_ptr<ImageView> _shadowMap;
+    vk::Framebuffer _shadowFramebuffer;
+    vk::RenderPass _shadowRenderPass;
+    PipelineKey _shadowPipelineKey;
+    PipelineFactory _shadowPipelineFactory;
+    PipelineKey _cullPipelineKey;
+    PipelineFactory _cullPipelineFactory;
+
+    // tiles rendered by previous frames
+    SceneShadowAtlas _shadowAtlas;
+    std::map<ShadowKey, ShadowCacheEntry> _shadowCache;
+
+    // direction of directional light and top of casters in its space, fitted again when casters change
+    std::map<uint64_t, std::pair<glm::vec3, float>> _castersTops;
+
+    // instances of props updated by packets, slots are shared by all frames
+    SceneDrawList _drawList;
+    std::shared_ptr<BufferView> _instanceBuffer;
+    uint32_t _instanceCapacity = 0;
+
+    std::shared_ptr<Swapchain> _swapchain;
+    vk::RenderPass _renderPass;
+    PipelineKey _depthPipelineKey;
+    PipelineKey _modelPipelineKey;
+    PipelineKey _compositionPipelineKey;
+    PipelineFactory _depthPipelineFactory;
+    PipelineFactory _modelPipelineFactory;
+    PipelineFactory _compositionPipelineFactory;
+
+    RenderTargetViews _targetViews;
+
+    std::vector<FrameResources> _frames;
+
+    // state of current frame, read concurrently by chunks of model pass
+    uint32_t _frameIdx;
+    bool _hasCamera;
+    vk::Extent2D _extent;
+    std::vector<DrawBatch> _batches;
+    std::vector<uint32_t> _uploadSlots;
+    std::vector<vk::BufferCopy> _instanceCopies;
+    std::vector<const FrameLight *> _localLights;
+    std::vector<const FrameLight *> _directionalLights;
+    vk::DescriptorSet _instanceSet;
+    vk::DescriptorSet _cullSet;
+    std::optional<vk::DescriptorSet> _compositionSet;
+    vk::Buffer _vertexBuffer;
+    vk::Buffer _indexBuffer;
+    std::vector<ShadowRender> _shadowRenders;
+    std::vector<ShadowDraw> _shadowDraws;
+    std::vector<uint32_t> _shadowInstances;
+    std::vector<SceneClusterLight> _clusterLights;
+    SceneLightClusters _lightClusters;
+    glm::mat4 _viewProjection;
+    std::array<glm::vec4, 6> _frustumPlanes;
+    bool _cullingActive;
+    std::optional<vk::Pipeline> _depthPipeline;
+    std::optional<vk::Pipeline> _modelPipeline;
+    std::optional<vk::Pipeline> _compositionPipeline;
+    std::optional<vk::Pipeline> _shadowPipeline;
+    std::optional<vk::Pipeline> _cullPipeline;
+
+    vk::ShaderModule loadShader(const ResourceId &resourceId);
+
+    void initLayouts();
+    void initShadowMap();
+    void destroyShadowMap();
+    void clearShadowCache();
+
+    FrameResources &getFrameResources(uint32_t frameIdx);
+    void destroyFrameResources(const FrameResources &frameResources);
+    std::shared_ptr<BufferView> reallocateBuffer(const std::shared_ptr<BufferView> &buffer, vk::DeviceSize size,
+                                                 vk::BufferUsageFlags usage, bool hostVisible);
+    void reserveInstanceSlots(uint32_t slotCount);
+    void reserveInstanceUploads(FrameResources &frameResources, uint32_t instanceCount);
+    void reserveVisibleInstances(FrameResources &frameResources, uint32_t instanceCount);
+    void reserveBatches(FrameResources &frameResources, uint32_t batchCount);
+    void reserveLightIndices(FrameResources &frameResources, uint32_t lightIndexCount);
+    void reserveShadowInstances(FrameResources &frameResources, uint32_t shadowInstanceCount);
+    void allocateFrameSets(FrameResources &frameResources);
+
+    void prepareBatches(FrameResources &frameResources);
+    void prepareUniforms(FrameResources &frameResources, const FramePacket &packet);
+    void prepareShadowCache();
+    void prepareShadows(FrameResources &frameResources, const FramePacket &packet,
+                        const glm::mat4 &projection, uint32_t shadowCount);
+    void prepareCascades(FrameResources &frameResources, const FramePacket &packet,
+                         float aspect, uint32_t directionalCount);
+
+    // nullptr if atlas has no room even for smallest tile
+    ShadowCacheEntry *acquireShadowTile(const ShadowKey &key, uint32_t size, uint64_t packetIdx);
+    void updateShadowTile(ShadowCacheEntry &entry, const glm::mat4 &matrix, bool dirty);
+    glm::vec4 getShadowRect(const SceneShadowTile &tile);
+    void prepareLightClusters(FrameResources &frameResources, const FramePacket &packet,
+                              const glm::mat4 &projection, uint32_t lightCount);
+
+    void recordInstanceUpload(const vk::CommandBuffer &commandBuffer);
+    void recordCulling(const vk::CommandBuffer &commandBuffer);
+    void recordShadows(const vk::CommandBuffer &commandBuffer);
+    void recordModelBatches(const std::optional<vk::Pipeline> &pipeline, uint32_t fromIdx, uint32_t toIdx,
+                            const vk::CommandBuffer &commandBuffer);
+    void recordComposition(const vk::CommandBuffer &commandBuffer);
+
+public:
+    SceneRenderStage(const std::shared_ptr<Log> &log,
+                     const std::shared_ptr<VarCollection> &varCollection,
+                     const std::shared_ptr<ResourceDatabase> &resourceDatabase,
+                     const std::shared_ptr<ResourceLoader> &resourceLoader,
+                     const std::shared_ptr<GpuManager> &gpuManager);
+    ~SceneRenderStage() override = default;
+
+    void init() override;
+    void destroy() override;
+
+    void onGraphCreate(const std::shared_ptr<Swapchain> swapchain,
+                       const vk::RenderPass &renderPass,
+                       vk::SampleCountFlagBits sampleCount) override;
+    void onGraphDestroy() override;
+
+    void onTargetsUpdate(const RenderTargetViews &views) override;
+
+    void onPacket(const FramePacket &packet) override;
+
+    void onFrameBegin(const RenderFrame &frame) override;
+    void onPreExecute(const vk::CommandBuffer &commandBuffer) override;
+
+    void onPassExecute(const RenderPassRef &passRef, const vk::CommandBuffer &commandBuffer) override;
+
+    [[nodiscard]] uint32_t getPassChunkCount(const RenderPassRef &passRef) override;
+
+    void onPassChunkExecute(const RenderPassRef &passRef,
+                            uint32_t chunkIdx,
+                            uint32_t chunkCount,
+                            const vk::CommandBuffer &commandBuffer) override;
+
+    RenderSubgraph asSubgraph() override;
+};
+
+#endif // RENDERING_STAGES_SCENERENDERSTAGE_HPP
@@ -0,0 +1,113 @@
+#include "SceneShadowAtlas.hpp"
+
+#include <algorithm>
+#include <bit>
+
+uint32_t SceneShadowAtlas::getLevel(uint32_t tileSize) const {
+    return static_cast<uint32_t>(std::countr_zero(this->_maxTileSize / tileSize));
+}
+
+SceneShadowAtlas::SceneShadowAtlas()
+        : _atlasSize(0),
+          _maxTileSize(0),
+          _minTileSize(0) {
+    //
+}
+
+void SceneShadowAtlas::reset(uint32_t atlasSize, uint32_t maxTileSize, uint32_t minTileSize) {
+    this->_atlasSize = std::bit_floor(std::max(atlasSize, 1u));
+    this->_maxTileSize = std::min(std::bit_floor(std::max(maxTileSize, 1u)), this->_atlasSize);
+    this->_minTileSize = std::min(std::bit_floor(std::max(minTileSize, 1u)), this->_maxTileSize);
+
+    this->_freeTiles = std::vector<std::set<std::pair<uint32_t, uint32_t>>>(this->getLevel(this->_minTileSize) + 1);
+
+    for (uint32_t y = 0; y < this->_atlasSize; y += this->_maxTileSize) {
+        for (uint32_t x = 0; x < this->_atlasSize; x += this->_maxTileSize) {
+            this->_freeTiles[0].emplace(x, y);
+        }
+    }
+}
+
+uint32_t SceneShadowAtlas::getTileSize(uint32_t size) const {
+    // max size is power of two, so rounded size never exceeds it
+    return std::bit_ceil(std::clamp(size, this->_minTileSize, this->_maxTileSize));
+}
+
+std::optional<SceneShadowTile> SceneShadowAtlas::allocate(uint32_t size) {
+    if (this->_freeTiles.empty()) {
+        return std::nullopt;
+    }
+
+    auto tileSize = this->getTileSize(size);
+    auto level = this->getLevel(tileSize);
+
+    // smallest free tile that fits is split, so larger tiles stay available for larger requests
+    auto freeLevel = static_cast<int>(level);
+
+    while (freeLevel >= 0 && this->_freeTiles[freeLevel].empty()) {
+        freeLevel--;
+    }
+
+    if (freeLevel < 0) {
+        return std::nullopt;
+    }
+
+    auto &freeTiles = this->_freeTiles[freeLevel];
+    auto [x, y] = *freeTiles.begin();
+    freeTiles.erase(freeTiles.begin());
+
+    // first quarter is split further, rest are freed
+    for (auto splitLevel = static_cast<uint32_t>(freeLevel) + 1; splitLevel <= level; splitLevel++) {
+        auto halfSize = this->_maxTileSize >> splitLevel;
+
+        this->_freeTiles[splitLevel].emplace(x + halfSize, y);
+        this->_freeTiles[splitLevel].emplace(x, y + halfSize);
+        this->_freeTiles[splitLevel].emplace(x + halfSize, y + halfSize);
+    }
+
+    return SceneShadowTile{
+            .x = x,
+            .y = y,
+            .size = tileSize
+    };
+}
+
+void SceneShadowAtlas::free(const SceneShadowTile &tile) {
+    auto level = this->getLevel(tile.size);
+    auto x = tile.x;
+    auto y = tile.y;
+
+    // tile is merged with its siblings while all of them are free
+    while (level > 0) {
+        auto tileSize = this->_maxTileSize >> level;
+        auto parentX = x - x % (tileSize * 2);
+        auto parentY = y - y % (tileSize * 2);
+
+        auto siblings = {
+                std::make_pair(parentX, parentY),
+                std::make_pair(parentX + tileSize, parentY),
+                std::make_pair(parentX, parentY + tileSize),
+                std::make_pair(parentX + tileSize, parentY + tileSize)
+        };
+
+        auto &freeTiles = this->_freeTiles[level];
+
+        bool merge = std::all_of(siblings.begin(), siblings.end(), [&](const std::pair<uint32_t, uint32_t> &sibling) {
+            return sibling == std::make_pair(x, y) || freeTiles.contains(sibling);
+        });
+
+        if (!merge) {
+            break;
+        }
+
+        for (const auto &sibling: siblings) {
+            freeTiles.erase(sibling);
+        }
+
+        x = parentX;
+        y = parentY;
+        level--;
+    }
+
+    this->_freeTiles[level].emplace(x, y);
+}
@@ -0,0 +1,49 @@
+#ifndef RENDERING_STAGES_SCENESHADOWATLAS_HPP
+#define RENDERING_STAGES_SCENESHADOWATLAS_HPP
+
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+struct SceneShadowTile {
+    uint32_t x;
+    uint32_t y;
+    uint32_t size;
+};
+
+// Allocates square tiles of shadow atlas. Atlas is split into tiles of max size, every tile could be split into four
+// halves down to min size. Freed tiles are merged back with their siblings, so atlas does not fragment over time.
+class SceneShadowAtlas {
+private:
+    uint32_t _atlasSize;
+    uint32_t _maxTileSize;
+    uint32_t _minTileSize;
+
+    // free tile positions for every level, level 0 holds tiles of max size
+    std::vector<std::set<std::pair<uint32_t, uint32_t>>> _freeTiles;
+
+    [[nodiscard]] uint32_t getLevel(uint32_t tileSize) const;
+
+public:
+    SceneShadowAtlas();
+
+    // sizes are rounded down to powers of two, every tile is freed
+    void reset(uint32_t atlasSize, uint32_t maxTileSize, uint32_t minTileSize);
+
+    // size is clamped to tile sizes of atlas and rounded up to power of two
+    [[nodiscard]] uint32_t getTileSize(uint32_t size) const;
+
+    // tile of rounded size, or nullopt if atlas has no room for it
+    [[nodiscard]] std::optional<SceneShadowTile> allocate(uint32_t size);
+    void free(const SceneShadowTile &tile);
+
+    [[nodiscard]] uint32_t getAtlasSize() const { return this->_atlasSize; }
+
+    [[nodiscard]] uint32_t getMaxTileSize() const { return this->_maxTileSize; }
+
+    [[nodiscard]] uint32_t getMinTileSize() const { return this->_minTileSize; }
+};
+
+#endif // RENDERING_STAGES_SCENESHADOWATLAS_HPP
@@ -0,0 +1,326 @@
+#include "UpscaleRenderStage.hpp"
+
+#include <string_view>
+
+#include <fmt/core.h>
+
+#include "src/Engine/EngineError.hpp"
+#include "src/Rendering/DescriptorAllocator.hpp"
+#include "src/Rendering/GpuManager.hpp"
+#include "src/Rendering/Swapchain.hpp"
+#include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
+#include "src/Rendering/Types/RenderFrame.hpp"
+#include "src/Resources/Resource.hpp"
+#include "src/Resources/ResourceData.hpp"
+#include "src/Resources/ResourceDatabase.hpp"
+#include "src/Resources/ResourceLoader.hpp"
+
+// matches push constants of upscale.frag
+struct UpscaleConstants {
+    // scale of swapchain uv to scene color uv
+    float scale[2];
+
+    // uv of last rendered texel center, filtering must not reach texels outside of rendered area
+    float limit[2];
+};
+
+static vk::PipelineShaderStageCreateInfo shaderStage(vk::ShaderStageFlagBits stage,
+                                                     const vk::ShaderModule &shaderModule) {
+    return vk::PipelineShaderStageCreateInfo()
+            .setStage(stage)
+            .setModule(shaderModule)
+            .setPName("main");
+}
+
+static vk::Pipeline createUpscalePipeline(const vk::Device &device, const vk::PipelineCache &pipelineCache,
+                                          const vk::ShaderModule &vertexShader,
+                                          const vk::ShaderModule &fragmentShader,
+                                          const vk::PipelineLayout &layout,
+                                          const vk::RenderPass &renderPass) {
+    auto stages = {
+            shaderStage(vk::ShaderStageFlagBits::eVertex, vertexShader),
+            shaderStage(vk::ShaderStageFlagBits::eFragment, fragmentShader)
+    };
+
+    auto vertexInputState = vk::PipelineVertexInputStateCreateInfo();
+
+    auto inputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo()
+            .setTopology(vk::PrimitiveTopology::eTriangleList);
+
+    auto viewportState = vk::PipelineViewportStateCreateInfo()
+            .setViewportCount(1)
+            .setScissorCount(1);
+
+    auto rasterizationState = vk::PipelineRasterizationStateCreateInfo()
+            .setPolygonMode(vk::PolygonMode::eFill)
+            .setCullMode(vk::CullModeFlagBits::eNone)
+            .setLineWidth(1.0f);
+
+    auto multisampleState = vk::PipelineMultisampleStateCreateInfo()
+            .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+
+    auto depthStencilState = vk::PipelineDepthStencilStateCreateInfo()
+            .setDepthTestEnable(false)
+            .setDepthWriteEnable(false);
+
+    auto colorBlendAttachment = vk::PipelineColorBlendAttachmentState()
+            .setColorWriteMask(vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                               vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+
+    auto colorBlendState = vk::PipelineColorBlendStateCreateInfo()
+            .setAttachments(colorBlendAttachment);
+
+    auto dynamicStates = {
+            vk::DynamicState::eViewport,
+            vk::DynamicState::eScissor
+    };
+
+    auto dynamicState = vk::PipelineDynamicStateCreateInfo()
+            .setDynamicStates(dynamicStates);
+
+    auto createInfo = vk::GraphicsPipelineCreateInfo()
+            .setStages(stages)
+            .setPVertexInputState(&vertexInputState)
+            .setPInputAssemblyState(&inputAssemblyState)
+            .setPViewportState(&viewportState)
+            .setPRasterizationState(&rasterizationState)
+            .setPMultisampleState(&multisampleState)
+            .setPDepthStencilState(&depthStencilState)
+            .setPColorBlendState(&colorBlendState)
+            .setPDynamicState(&dynamicState)
+            .setLayout(layout)
+            .setRenderPass(renderPass)
+            .setSubpass(0);
+
+    return device.createGraphicsPipeline(pipelineCache, createInfo).value;
+}
+
+vk::ShaderModule UpscaleRenderStage::loadShader(const ResourceId &resourceId) {
+    auto resource = this->_resourceDatabase->tryGetResource(resourceId);
+
+    if (!resource.has_value()) {
+        throw EngineError(fmt::format("Shader {0} not found", resourceId));
+    }
+
+    auto lockedResource = resource.value().lock();
+
+    if (lockedResource->type() != SHADER_BINARY_RESOURCE) {
+        throw EngineError(fmt::format("Resource {0} is not a shader binary", resourceId));
+    }
+
+    auto resourceData = this->_resourceLoader->tryLoad(lockedResource);
+
+    if (!resourceData.has_value()) {
+        throw EngineError(fmt::format("Failed to load shader {0}", resourceId));
+    }
+
+    const auto &code = resourceData.value().lock()->data();
+
+    auto createInfo = vk::ShaderModuleCreateInfo()
+            .setCodeSize(code.size())
+            .setPCode(reinterpret_cast<const uint32_t *>(code.data()));
+
+    auto shaderModule = this->_logicalDevice->getHandle().createShaderModule(createInfo);
+
+    this->_resourceLoader->freeResource(resourceId);
+
+    return shaderModule;
+}
+
+UpscaleRenderStage::UpscaleRenderStage(const std::shared_ptr<ResourceDatabase> &resourceDatabase,
+                                       const std::shared_ptr<ResourceLoader> &resourceLoader,
+                                       const std::shared_ptr<GpuManager> &gpuManager)
+        : _resourceDatabase(resourceDatabase),
+          _resourceLoader(resourceLoader),
+          _gpuManager(gpuManager) {
+    //
+}
+
+void UpscaleRenderStage::init() {
+    if (this->_gpuManager->getLogicalDeviceProxy().expired() ||
+        this->_gpuManager->getDescriptorAllocator().expired() ||
+        this->_gpuManager->getPipelineCompiler().expired()) {
+        throw EngineError("GPU manager is not initialized");
+    }
+
+    this->_logicalDevice = this->_gpuManager->getLogicalDeviceProxy().lock();
+    this->_descriptorAllocator = this->_gpuManager->getDescriptorAllocator().lock();
+    this->_pipelineCompiler = this->_gpuManager->getPipelineCompiler().lock();
+
+    auto device = this->_logicalDevice->getHandle();
+
+    this->_vertexShader = this->loadShader("data/shaders/passthrough.vert.spv");
+    this->_fragmentShader = this->loadShader("data/shaders/upscale.frag.spv");
+
+    auto samplerCreateInfo = vk::SamplerCreateInfo()
+            .setMagFilter(vk::Filter::eLinear)
+            .setMinFilter(vk::Filter::eLinear)
+            .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+            .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+            .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+            .setAddressModeW(vk::SamplerAddressMode::eClampToEdge);
+
+    this->_sampler = device.createSampler(samplerCreateInfo);
+
+    std::vector<vk::DescriptorSetLayoutBinding> bindings = {
+            vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eCombinedImageSampler, 1,
+                                           vk::ShaderStageFlagBits::eFragment)
+    };
+
+    this->_setLayout = this->_descriptorAllocator->getLayout(bindings);
+
+    auto pushConstant = vk::PushConstantRange(vk::ShaderStageFlagBits::eFragment, 0, sizeof(UpscaleConstants));
+
+    this->_pipelineLayout = device.createPipelineLayout(vk::PipelineLayoutCreateInfo()
+                                                                .setSetLayouts(this->_setLayout)
+                                                                .setPushConstantRanges(pushConstant));
+}
+
+void UpscaleRenderStage::destroy() {
+    auto device = this->_logicalDevice->getHandle();
+
+    device.destroy(this->_pipelineLayout);
+    device.destroy(this->_sampler);
+    device.destroy(this->_fragmentShader);
+    device.destroy(this->_vertexShader);
+
+    this->_pipelineCompiler = nullptr;
+    this->_descriptorAllocator = nullptr;
+    this->_logicalDevice = nullptr;
+}
+
+void UpscaleRenderStage::onGraphCreate(const std::shared_ptr<Swapchain> swapchain,
+                                       const vk::RenderPass &renderPass,
+                                       vk::SampleCountFlagBits sampleCount) {
+    this->_swapchain = swapchain;
+
+    this->_pipelineKey = makePipelineKey(std::string_view("Upscale"),
+                                         static_cast<VkRenderPass>(renderPass));
+    this->_pipelineFactory = [vertexShader = this->_vertexShader,
+            fragmentShader = this->_fragmentShader,
+            layout = this->_pipelineLayout,
+            renderPass](const vk::Device &device, const vk::PipelineCache &pipelineCache) {
+        return createUpscalePipeline(device, pipelineCache, vertexShader, fragmentShader, layout, renderPass);
+    };
+
+    this->_pipeline = this->_pipelineCompiler->tryGetPipeline(this->_pipelineKey, this->_pipelineFactory);
+}
+
+void UpscaleRenderStage::onGraphDestroy() {
+    this->_pipelineCompiler->release(this->_pipelineKey);
+
+    this->_pipeline = std::nullopt;
+    this->_sceneColorView = std::nullopt;
+    this->_swapchain = nullptr;
+}
+
+void UpscaleRenderStage::onTargetsUpdate(const RenderTargetViews &views) {
+    auto it = views.find("SceneColor");
+
+    this->_sceneColorView = it != views.end()
+                            ? std::make_optional(it->second)
+                            : std::nullopt;
+
+    // images of graph are allocated at swapchain extent
+    this->_imageExtent = this->_swapchain->getExtent();
+}
+
+void UpscaleRenderStage::onFrameBegin(const RenderFrame &frame) {
+    this->_renderExtent = frame.renderExtent;
+    this->_set = std::nullopt;
+
+    this->_pipeline = this->_pipelineCompiler->tryGetPipeline(this->_pipelineKey, this->_pipelineFactory);
+
+    if (!this->_sceneColorView.has_value()) {
+        return;
+    }
+
+    auto set = this->_descriptorAllocator->allocateFrameSet(frame.frameIdx, this->_setLayout);
+
+    auto imageInfo = vk::DescriptorImageInfo(this->_sampler, this->_sceneColorView.value(),
+                                             vk::ImageLayout::eShaderReadOnlyOptimal);
+
+    auto write = vk::WriteDescriptorSet()
+            .setDstSet(set)
+            .setDstBinding(0)
+            .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+            .setImageInfo(imageInfo);
+
+    this->_logicalDevice->getHandle().updateDescriptorSets(write, nullptr);
+
+    this->_set = set;
+}
+
+void UpscaleRenderStage::onPassExecute(const RenderPassRef &passRef, const vk::CommandBuffer &commandBuffer) {
+    if (passRef != "Upscale") {
+        throw EngineError(fmt::format("Unknown pass {0}", passRef));
+    }
+
+    if (!this->_pipeline.has_value() ||
+        !this->_set.has_value() ||
+        this->_imageExtent.width == 0 || this->_imageExtent.height == 0) {
+        return;
+    }
+
+    auto extent = this->_swapchain->getExtent();
+    auto imageWidth = static_cast<float>(this->_imageExtent.width);
+    auto imageHeight = static_cast<float>(this->_imageExtent.height);
+
+    UpscaleConstants constants = {
+            .scale = {
+                    static_cast<float>(this->_renderExtent.width) / imageWidth,
+                    static_cast<float>(this->_renderExtent.height) / imageHeight
+            },
+            .limit = {
+                    (static_cast<float>(this->_renderExtent.width) - 0.5f) / imageWidth,
+                    (static_cast<float>(this->_renderExtent.height) - 0.5f) / imageHeight
+            }
+    };
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, this->_pipeline.value());
+    commandBuffer.setViewport(0, vk::Viewport(0, 0,
+                                              static_cast<float>(extent.width),
+                                              static_cast<float>(extent.height),
+                                              0, 1));
+    commandBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), extent));
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->_pipelineLayout, 0,
+                                     this->_set.value(), nullptr);
+    commandBuffer.pushConstants(this->_pipelineLayout, vk::ShaderStageFlagBits::eFragment, 0,
+                                sizeof(UpscaleConstants), &constants);
+    commandBuffer.draw(3, 1, 0, 0);
+}
+
+RenderSubgraph UpscaleRenderStage::asSubgraph() {
+    return RenderSubgraph{
+            .attachments = {
+                    {
+                            "Swapchain",
+                            RenderAttachment{
+                                    .idx = 0,
+                                    .targetRef = "Swapchain",
+                                    .loadOp = vk::AttachmentLoadOp::eClear,
+                                    .storeOp = vk::AttachmentStoreOp::eStore,
+                                    .initialLayout = vk::ImageLayout::eUndefined,
+                                    .finalLayout = vk::ImageLayout::eColorAttachmentOptimal
+                            }
+                    }
+            },
+            .passes = {
+                    {
+                            "Upscale",
+                            RenderPass{
+                                    .idx = 0,
+                                    .inputRefs = {},
+                                    .colorRefs = {
+                                            "Swapchain"
+                                    },
+                                    .depthRef = std::nullopt,
+                                    .resolveRefs = {},
+                                    .dependencies = {}
+                            }
+                    }
+            },
+            .firstPass = "Upscale",
+            .next = {}
+    };
+}
@@ -0,0 +1,74 @@
+#ifndef RENDERING_STAGES_UPSCALERENDERSTAGE_HPP
+#define RENDERING_STAGES_UPSCALERENDERSTAGE_HPP
+
+#include <memory>
+#include <optional>
+
+#include "src/Rendering/PipelineCompiler.hpp"
+#include "src/Rendering/Graph/RenderStage.hpp"
+#include "src/Resources/ResourceId.hpp"
+
+class ResourceDatabase;
+class ResourceLoader;
+
+class DescriptorAllocator;
+class GpuManager;
+class LogicalDeviceProxy;
+
+// Stretches scene color, rendered into top left corner of its image at scaled extent, over the whole swapchain with
+// bilinear filtering.
+class UpscaleRenderStage : public RenderStage {
+private:
+    std::shared_ptr<ResourceDatabase> _resourceDatabase;
+    std::shared_ptr<ResourceLoader> _resourceLoader;
+    std::shared_ptr<GpuManager> _gpuManager;
+
+    std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+    std::shared_ptr<DescriptorAllocator> _descriptorAllocator;
+    std::shared_ptr<PipelineCompiler> _pipelineCompiler;
+
+    vk::ShaderModule _vertexShader;
+    vk::ShaderModule _fragmentShader;
+
+    vk::Sampler _sampler;
+    vk::DescriptorSetLayout _setLayout;
+    vk::PipelineLayout _pipelineLayout;
+
+    std::shared_ptr<Swapchain> _swapchain;
+    PipelineKey _pipelineKey;
+    PipelineFactory _pipelineFactory;
+
+    std::optional<vk::ImageView> _sceneColorView;
+    vk::Extent2D _imageExtent;
+
+    // state of current frame
+    vk::Extent2D _renderExtent;
+    std::optional<vk::Pipeline> _pipeline;
+    std::optional<vk::DescriptorSet> _set;
+
+    vk::ShaderModule loadShader(const ResourceId &resourceId);
+
+public:
+    UpscaleRenderStage(const std::shared_ptr<ResourceDatabase> &resourceDatabase,
+                       const std::shared_ptr<ResourceLoader> &resourceLoader,
+                       const std::shared_ptr<GpuManager> &gpuManager);
+    ~UpscaleRenderStage() override = default;
+
+    void init() override;
+    void destroy() override;
+
+    void onGraphCreate(const std::shared_ptr<Swapchain> swapchain,
+                       const vk::RenderPass &renderPass,
+                       vk::SampleCountFlagBits sampleCount) override;
+    void onGraphDestroy() override;
+
+    void onTargetsUpdate(const RenderTargetViews &views) override;
+
+    void onFrameBegin(const RenderFrame &frame) override;
+
+    void onPassExecute(const RenderPassRef &passRef, const vk::CommandBuffer &commandBuffer) override;
+
+    RenderSubgraph asSubgraph() override;
+};
+
+#endif // RENDERING_STAGES_UPSCALERENDERSTAGE_HPP
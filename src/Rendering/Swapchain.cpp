@@ -3,10 +3,12 @@
 #include <limits>
 #include <string_view>
 
+#include <fmt/core.h>
+
 #include "src/Engine/EngineError.hpp"
 #include "src/Engine/Log.hpp"
 #include "src/Engine/VarCollection.hpp"
-#include "src/Engine/Vars.hpp"
+#include "src/Rendering/DeletionQueue.hpp"
 #include "src/Rendering/SurfaceManager.hpp"
 #include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
 #include "src/Rendering/Proxies/PhysicalDeviceProxy.hpp"
@@ -14,11 +16,6 @@
 
 static constexpr const std::string_view SWAPCHAIN_TAG = "Swapchain";
 
-static constexpr const std::array<vk::PresentModeKHR, 2> PREFERRED_PRESENT_MODES = {
-        vk::PresentModeKHR::eMailbox,
-        vk::PresentModeKHR::eFifoRelaxed
-};
-
 vk::SurfaceFormatKHR Swapchain::getPreferredSurfaceFormatFor(const vk::SurfaceKHR &surface) {
     std::vector<vk::SurfaceFormatKHR> formats;
     try {
@@ -50,17 +47,32 @@ vk::PresentModeKHR Swapchain::getPreferredPresentModeFor(const vk::SurfaceKHR &s
         throw EngineError("Failed to retrieve surface present modes");
     }
 
-    if (!this->_varCollection->getOrDefault(RENDERING_VSYNC.data(), false)) {
-        return vk::PresentModeKHR::eImmediate;
+    if (std::find(modes.begin(), modes.end(), this->_presentMode) != modes.end()) {
+        return this->_presentMode;
     }
 
-    for (const auto &preferredMode: PREFERRED_PRESENT_MODES) {
-        if (std::find(modes.begin(), modes.end(), preferredMode) != modes.end()) {
-            return preferredMode;
+    this->_log->warning(SWAPCHAIN_TAG, fmt::format("Present mode {0} is not supported, falling back to FIFO",
+                                                   vk::to_string(this->_presentMode)));
+
+    // FIFO is the only mode required to be supported
+    return vk::PresentModeKHR::eFifo;
+}
+
+void Swapchain::retire(uint32_t inflightFrameCount) {
+    auto logicalDevice = this->_logicalDevice;
+    auto swapchain = this->_swapchain.value();
+    auto imageViews = this->_swapchainImageViews;
+
+    this->_deletionQueue->push([logicalDevice, swapchain, imageViews]() {
+        for (const auto &imageView: imageViews) {
+            logicalDevice->getHandle().destroy(imageView);
         }
-    }
 
-    return vk::PresentModeKHR::eImmediate;
+        logicalDevice->getHandle().destroy(swapchain);
+    }, inflightFrameCount);
+
+    this->_swapchain = std::nullopt;
+    this->_swapchainImageViews.clear();
 }
 
 Swapchain::Swapchain(const std::shared_ptr<Log> &log,
@@ -68,18 +80,21 @@ Swapchain::Swapchain(const std::shared_ptr<Log> &log,
                      const std::shared_ptr<SurfaceManager> &surfaceManager,
                      const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
                      const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                     const std::shared_ptr<DeletionQueue> &deletionQueue,
                      const std::shared_ptr<Window> &window)
         : _log(log),
           _varCollection(varCollection),
           _surfaceManager(surfaceManager),
           _physicalDevice(physicalDevice),
           _logicalDevice(logicalDevice),
+          _deletionQueue(deletionQueue),
           _window(window),
-          _invalid(true) {
+          _invalid(true),
+          _presentMode(vk::PresentModeKHR::eFifo) {
     //
 }
 
-void Swapchain::create() {
+void Swapchain::create(uint32_t inflightFrameCount) {
     auto surface = this->_surfaceManager->getSurfaceFor(this->_window->handle());
 
     vk::SurfaceCapabilitiesKHR capabilities;
@@ -132,7 +147,7 @@ void Swapchain::create() {
     }
 
     if (this->_swapchain.has_value()) {
-        this->destroy();
+        this->retire(inflightFrameCount);
     }
 
     this->_swapchain = swapchain;
@@ -185,8 +200,6 @@ void Swapchain::destroy() {
         return;
     }
 
-    this->_logicalDevice->getHandle().waitIdle();
-
     for (const auto &imageView: this->_swapchainImageViews) {
         this->_logicalDevice->getHandle().destroy(imageView);
     }
@@ -205,11 +218,26 @@ void Swapchain::invalidate() {
     this->_invalid = true;
 }
 
+void Swapchain::setPresentMode(vk::PresentModeKHR presentMode) {
+    if (this->_presentMode == presentMode) {
+        return;
+    }
+
+    this->_presentMode = presentMode;
+    this->_invalid = true;
+}
+
 std::optional<uint32_t> Swapchain::acquireNextImage(const vk::Semaphore &semaphore) {
     auto [result, imageIdx] = this->_logicalDevice->getHandle().acquireNextImageKHR(this->_swapchain.value(),
                                                                                     std::numeric_limits<uint64_t>::max(),
                                                                                     semaphore);
 
+    // semaphore is signaled when suboptimal image is acquired, so it has to be used for rendering anyway
+    if (result == vk::Result::eSuboptimalKHR) {
+        this->invalidate();
+        return imageIdx;
+    }
+
     if (result != vk::Result::eSuccess) {
         return std::nullopt;
     }
@@ -11,6 +11,7 @@
 class Log;
 class VarCollection;
 class EventQueue;
+class DeletionQueue;
 class SurfaceManager;
 class PhysicalDeviceProxy;
 class LogicalDeviceProxy;
@@ -22,6 +23,7 @@ class Swapchain {
     std::shared_ptr<SurfaceManager> _surfaceManager;
     std::shared_ptr<PhysicalDeviceProxy> _physicalDevice;
     std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
     std::shared_ptr<Window> _window;
 
     bool _invalid;
@@ -31,23 +33,34 @@ class Swapchain {
     std::optional<uint32_t> _swapchainMinImageCount;
     std::optional<uint32_t> _swapchainImageCount;
     std::vector<vk::ImageView> _swapchainImageViews;
+    vk::PresentModeKHR _presentMode;
 
     vk::SurfaceFormatKHR getPreferredSurfaceFormatFor(const vk::SurfaceKHR &surface);
     vk::PresentModeKHR getPreferredPresentModeFor(const vk::SurfaceKHR &surface);
 
+    void retire(uint32_t inflightFrameCount);
+
 public:
     Swapchain(const std::shared_ptr<Log> &log,
               const std::shared_ptr<VarCollection> &varCollection,
               const std::shared_ptr<SurfaceManager> &surfaceManager,
               const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
               const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+              const std::shared_ptr<DeletionQueue> &deletionQueue,
               const std::shared_ptr<Window> &window);
 
-    void create();
+    // previous swapchain is handed over to the new one and destroyed only after inflight frame count of new frames is
+    // completed, timeline does not track presentation, so frames presented to it are assumed done by then
+    void create(uint32_t inflightFrameCount);
+
+    // GPU should not use swapchain anymore
     void destroy();
 
     void invalidate();
 
+    // unsupported mode falls back to FIFO, swapchain is recreated if mode is changed
+    void setPresentMode(vk::PresentModeKHR presentMode);
+
     [[nodiscard]] std::optional<uint32_t> acquireNextImage(const vk::Semaphore &semaphore);
 
     [[nodiscard]] const bool &isInvalid() const { return this->_invalid; }
@@ -8,13 +8,15 @@ SwapchainManager::SwapchainManager(const std::shared_ptr<Log> &log,
                                    const std::shared_ptr<EventQueue> &eventQueue,
                                    const std::shared_ptr<SurfaceManager> &surfaceManager,
                                    const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
-                                   const std::shared_ptr<LogicalDeviceProxy> &logicalDevice)
+                                   const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                                   const std::shared_ptr<DeletionQueue> &deletionQueue)
         : _log(log),
           _varCollection(varCollection),
           _eventQueue(eventQueue),
           _surfaceManager(surfaceManager),
           _physicalDevice(physicalDevice),
-          _logicalDevice(logicalDevice) {
+          _logicalDevice(logicalDevice),
+          _deletionQueue(deletionQueue) {
     //
 }
 
@@ -56,6 +58,7 @@ std::shared_ptr<Swapchain> SwapchainManager::getSwapchainFor(const std::shared_p
                                                  this->_surfaceManager,
                                                  this->_physicalDevice,
                                                  this->_logicalDevice,
+                                                 this->_deletionQueue,
                                                  window);
 
     this->_swapchains[window.get()] = swapchain;
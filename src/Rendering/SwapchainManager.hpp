@@ -11,6 +11,7 @@
 class Log;
 class VarCollection;
 class EventQueue;
+class DeletionQueue;
 class SurfaceManager;
 class PhysicalDeviceProxy;
 class LogicalDeviceProxy;
@@ -26,6 +27,7 @@ private:
     std::shared_ptr<SurfaceManager> _surfaceManager;
     std::shared_ptr<PhysicalDeviceProxy> _physicalDevice;
     std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
 
     EventHandlerIdx _handlerIdx;
     std::map<Window *, std::shared_ptr<Swapchain>> _swapchains;
@@ -36,7 +38,8 @@ public:
                      const std::shared_ptr<EventQueue> &eventQueue,
                      const std::shared_ptr<SurfaceManager> &surfaceManager,
                      const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
-                     const std::shared_ptr<LogicalDeviceProxy> &logicalDevice);
+                     const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                     const std::shared_ptr<DeletionQueue> &deletionQueue);
 
     void init();
     void destroy();
@@ -0,0 +1,141 @@
+#include "TextureTable.hpp"
+
+#include <algorithm>
+
+#include <fmt/core.h>
+
+#include "src/Engine/EngineError.hpp"
+#include "src/Engine/Log.hpp"
+#include "src/Engine/VarCollection.hpp"
+#include "src/Engine/Vars.hpp"
+#include "src/Rendering/DeletionQueue.hpp"
+#include "src/Rendering/Proxies/LogicalDeviceProxy.hpp"
+#include "src/Rendering/Proxies/PhysicalDeviceProxy.hpp"
+
+static constexpr const char *TEXTURE_TABLE_TAG = "TextureTable";
+
+TextureTable::TextureTable(const std::shared_ptr<Log> &log,
+                           const std::shared_ptr<VarCollection> &varCollection,
+                           const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
+                           const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                           const std::shared_ptr<DeletionQueue> &deletionQueue)
+        : _log(log),
+          _varCollection(varCollection),
+          _physicalDevice(physicalDevice),
+          _logicalDevice(logicalDevice),
+          _deletionQueue(deletionQueue) {
+    //
+}
+
+void TextureTable::init() {
+    const auto &supportedFeatures = this->_physicalDevice->getSupportedVulkan12Features();
+
+    if (!supportedFeatures.runtimeDescriptorArray ||
+        !supportedFeatures.descriptorBindingPartiallyBound ||
+        !supportedFeatures.descriptorBindingSampledImageUpdateAfterBind ||
+        !supportedFeatures.descriptorBindingUpdateUnusedWhilePending ||
+        !supportedFeatures.shaderSampledImageArrayNonUniformIndexing) {
+        throw EngineError("Descriptor indexing is not supported by physical device");
+    }
+
+    this->_capacity = std::max(this->_varCollection->getIntOrDefault(RENDERING_TEXTURE_TABLE_SIZE, 4096), 1);
+
+    auto device = this->_logicalDevice->getHandle();
+
+    auto samplerCreateInfo = vk::SamplerCreateInfo()
+            .setMagFilter(vk::Filter::eLinear)
+            .setMinFilter(vk::Filter::eLinear)
+            .setMipmapMode(vk::SamplerMipmapMode::eLinear)
+            .setAddressModeU(vk::SamplerAddressMode::eRepeat)
+            .setAddressModeV(vk::SamplerAddressMode::eRepeat)
+            .setAddressModeW(vk::SamplerAddressMode::eRepeat)
+            .setAnisotropyEnable(true)
+            .setMaxAnisotropy(this->_physicalDevice->getProperties().limits.maxSamplerAnisotropy)
+            .setMaxLod(VK_LOD_CLAMP_NONE);
+
+    // textures are loaded while frames that use the table are in flight, so unused entries are updated after bind and
+    // while command buffers with the set bound are still pending
+    vk::DescriptorBindingFlags bindingFlags = vk::DescriptorBindingFlagBits::ePartiallyBound |
+                                              vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                              vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+
+    auto bindingFlagsCreateInfo = vk::DescriptorSetLayoutBindingFlagsCreateInfo()
+            .setBindingFlags(bindingFlags);
+
+    auto binding = vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eCombinedImageSampler, this->_capacity,
+                                                  vk::ShaderStageFlagBits::eFragment);
+
+    auto poolSize = vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, this->_capacity);
+
+    try {
+        this->_sampler = device.createSampler(samplerCreateInfo);
+
+        this->_setLayout = device.createDescriptorSetLayout(
+                vk::DescriptorSetLayoutCreateInfo()
+                        .setPNext(&bindingFlagsCreateInfo)
+                        .setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool)
+                        .setBindings(binding));
+
+        this->_descriptorPool = device.createDescriptorPool(
+                vk::DescriptorPoolCreateInfo()
+                        .setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind)
+                        .setMaxSets(1)
+                        .setPoolSizes(poolSize));
+
+        this->_set = device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+                                                           .setDescriptorPool(this->_descriptorPool)
+                                                           .setSetLayouts(this->_setLayout))[0];
+    } catch (const std::exception &error) {
+        this->_log->error(TEXTURE_TABLE_TAG, error);
+        throw EngineError("Failed to initialize texture table");
+    }
+
+    // lowest indices are handed out first
+    this->_freeIndices.resize(this->_capacity);
+
+    for (uint32_t idx = 0; idx < this->_capacity; idx++) {
+        this->_freeIndices[idx] = this->_capacity - idx - 1;
+    }
+}
+
+void TextureTable::destroy() {
+    auto device = this->_logicalDevice->getHandle();
+
+    device.destroy(this->_descriptorPool);
+    device.destroy(this->_setLayout);
+    device.destroy(this->_sampler);
+
+    this->_freeIndices.clear();
+}
+
+uint32_t TextureTable::add(const vk::ImageView &imageView) {
+    std::lock_guard lock(this->_mutex);
+
+    if (this->_freeIndices.empty()) {
+        throw EngineError(fmt::format("Texture table is full, {0} textures are loaded", this->_capacity));
+    }
+
+    auto idx = this->_freeIndices.back();
+    this->_freeIndices.pop_back();
+
+    auto imageInfo = vk::DescriptorImageInfo(this->_sampler, imageView, vk::ImageLayout::eShaderReadOnlyOptimal);
+
+    auto write = vk::WriteDescriptorSet()
+            .setDstSet(this->_set)
+            .setDstBinding(0)
+            .setDstArrayElement(idx)
+            .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+            .setImageInfo(imageInfo);
+
+    this->_logicalDevice->getHandle().updateDescriptorSets(write, nullptr);
+
+    return idx;
+}
+
+void TextureTable::remove(uint32_t idx) {
+    this->_deletionQueue->push([this, idx]() {
+        std::lock_guard lock(this->_mutex);
+
+        this->_freeIndices.push_back(idx);
+    });
+}
@@ -0,0 +1,59 @@
+#ifndef RENDERING_TEXTURETABLE_HPP
+#define RENDERING_TEXTURETABLE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+class Log;
+class VarCollection;
+class DeletionQueue;
+class LogicalDeviceProxy;
+class PhysicalDeviceProxy;
+
+// Bindless table of all loaded textures: single descriptor set with an array of combined image samplers, which
+// shaders index by texture index. Set is bound once per pass, so draws with different textures share state.
+class TextureTable {
+private:
+    std::shared_ptr<Log> _log;
+    std::shared_ptr<VarCollection> _varCollection;
+    std::shared_ptr<PhysicalDeviceProxy> _physicalDevice;
+    std::shared_ptr<LogicalDeviceProxy> _logicalDevice;
+    std::shared_ptr<DeletionQueue> _deletionQueue;
+
+    uint32_t _capacity;
+    vk::Sampler _sampler;
+    vk::DescriptorSetLayout _setLayout;
+    vk::DescriptorPool _descriptorPool;
+    vk::DescriptorSet _set;
+
+    std::mutex _mutex;
+    std::vector<uint32_t> _freeIndices;
+
+public:
+    TextureTable(const std::shared_ptr<Log> &log,
+                 const std::shared_ptr<VarCollection> &varCollection,
+                 const std::shared_ptr<PhysicalDeviceProxy> &physicalDevice,
+                 const std::shared_ptr<LogicalDeviceProxy> &logicalDevice,
+                 const std::shared_ptr<DeletionQueue> &deletionQueue);
+
+    void init();
+    void destroy();
+
+    // image is expected to be in shader read only layout
+    [[nodiscard]] uint32_t add(const vk::ImageView &imageView);
+
+    // index is reused after frames that could sample it are retired
+    void remove(uint32_t idx);
+
+    [[nodiscard]] uint32_t getCapacity() const { return this->_capacity; }
+
+    [[nodiscard]] const vk::DescriptorSetLayout &getSetLayout() const { return this->_setLayout; }
+
+    [[nodiscard]] const vk::DescriptorSet &getSet() const { return this->_set; }
+};
+
+#endif // RENDERING_TEXTURETABLE_HPP
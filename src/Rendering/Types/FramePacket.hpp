@@ -0,0 +1,79 @@
+#ifndef RENDERING_TYPES_FRAMEPACKET_HPP
+#define RENDERING_TYPES_FRAMEPACKET_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+#include "src/Objects/LightSourceType.hpp"
+#include "src/Objects/Components/SkyboxComponent.hpp"
+#include "src/Rendering/Types/Mesh.hpp"
+#include "src/Rendering/Types/Texture.hpp"
+#include "src/Resources/ResourceId.hpp"
+
+class DebugUIDrawData;
+
+struct FrameCamera {
+    glm::vec3 position;
+    glm::vec3 forward;
+    glm::mat4 view;
+    glm::mat4 skyboxView;
+    float near;
+    float far;
+    float fov;
+};
+
+struct FrameLight {
+    uint64_t objectId;
+    LightSourceType type;
+    glm::vec3 position;
+    glm::vec3 forward;
+    glm::vec3 color;
+    float range;
+    float angle;
+    glm::vec2 rect;
+    glm::mat4 projection;
+    glm::mat4 view;
+
+    // light moved since previous packet
+    bool dirty;
+};
+
+// prop added or changed since previous packet, it keeps its instance slot until it is removed; resources are
+// resolved by main thread and kept alive by renderer while prop is drawn
+struct FrameDraw {
+    uint32_t slot;
+    uint64_t objectId;
+    std::shared_ptr<Mesh> mesh;
+    std::shared_ptr<Texture> albedoTexture;
+    std::shared_ptr<Texture> specularTexture;
+    glm::mat4 model;
+    glm::mat4 modelRotation;
+};
+
+struct FrameSkybox {
+    std::optional<ResourceId> meshId;
+    std::array<ResourceId, SKYBOX_TEXTURE_ARRAY_SIZE> textureIds;
+};
+
+// snapshot of scene state produced by main thread, never modified after it is pushed into frame pipeline
+struct FramePacket {
+    uint64_t idx;
+    std::optional<FrameCamera> camera;
+    std::optional<FrameSkybox> skybox;
+    std::vector<FrameLight> lights;
+
+    // props are delivered as changes against previous packet, so every packet has to be applied in order
+    std::vector<FrameDraw> draws;
+    std::vector<uint32_t> removedSlots;
+
+    std::shared_ptr<DebugUIDrawData> debugUIDrawData;
+};
+
+#endif // RENDERING_TYPES_FRAMEPACKET_HPP
@@ -1,13 +1,18 @@
 #ifndef RENDERING_TYPES_MESH_HPP
 #define RENDERING_TYPES_MESH_HPP
 
-#include <memory>
+#include <cstdint>
 
-#include "src/Rendering/Types/BufferView.hpp"
+#include <glm/vec3.hpp>
 
+// geometry is stored in shared buffers of geometry pool
 struct Mesh {
-    std::weak_ptr<BufferView> vertexBuffer;
-    std::weak_ptr<BufferView> indexBuffer;
+    int32_t vertexOffset;
+    uint32_t vertexCount;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    glm::vec3 boundsCenter;
+    float boundsRadius;
 };
 
 #endif // RENDERING_TYPES_MESH_HPP
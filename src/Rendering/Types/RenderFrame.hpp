@@ -0,0 +1,19 @@
+#ifndef RENDERING_TYPES_RENDERFRAME_HPP
+#define RENDERING_TYPES_RENDERFRAME_HPP
+
+#include <cstdint>
+#include <memory>
+
+#include <vulkan/vulkan.hpp>
+
+struct FramePacket;
+
+struct RenderFrame {
+    uint32_t frameIdx;
+    std::shared_ptr<const FramePacket> packet;
+
+    // image targets are rendered into top left corner of this size, subgraphs writing swapchain use its full extent
+    vk::Extent2D renderExtent;
+};
+
+#endif // RENDERING_TYPES_RENDERFRAME_HPP
@@ -1,12 +1,16 @@
 #ifndef RENDERING_TYPES_TEXTURE_HPP
 #define RENDERING_TYPES_TEXTURE_HPP
 
+#include <cstdint>
 #include <memory>
 
 #include "src/Rendering/Types/ImageView.hpp"
 
 struct Texture {
     std::weak_ptr<ImageView> image;
+
+    // index of texture in bindless texture table
+    uint32_t tableIdx;
 };
 
 #endif // RENDERING_TYPES_TEXTURE_HPP
@@ -1,6 +1,10 @@
 #include "MeshReader.hpp"
 
+#include <algorithm>
+
 #include <fmt/core.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
@@ -67,6 +71,22 @@ std::unique_ptr<MeshData> MeshReader::read(const std::weak_ptr<ResourceData> &re
         }
     }
 
+    // sphere around bounding box is not the tightest one, but it is cheap and good enough for culling
+    glm::vec3 min = meshData->vertices.empty() ? glm::vec3(0) : meshData->vertices.front().pos;
+    glm::vec3 max = min;
+
+    for (const Vertex &vertex: meshData->vertices) {
+        min = glm::min(min, vertex.pos);
+        max = glm::max(max, vertex.pos);
+    }
+
+    meshData->boundsCenter = (min + max) * 0.5f;
+    meshData->boundsRadius = 0;
+
+    for (const Vertex &vertex: meshData->vertices) {
+        meshData->boundsRadius = std::max(meshData->boundsRadius, glm::distance(meshData->boundsCenter, vertex.pos));
+    }
+
     return meshData;
 }
 
@@ -5,6 +5,8 @@
 #include <optional>
 #include <vector>
 
+#include <glm/vec3.hpp>
+
 #include "src/Types/Vertex.hpp"
 
 class Log;
@@ -13,6 +15,10 @@ class ResourceData;
 struct MeshData {
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
+
+    // bounding sphere in model space
+    glm::vec3 boundsCenter;
+    float boundsRadius;
 };
 
 class MeshReader {
@@ -52,6 +52,12 @@ static constexpr const char *POSITION_COMPONENT_SCALE_TAG = "scale";
 static constexpr const char *SKYBOX_COMPONENT_MESH_TAG = "mesh";
 static constexpr const char *SKYBOX_COMPONENT_TEXTURES_TAG = "textures";
 
+// camera rotation in scene files keeps its original spherical meaning: x is azimuth around Y axis and y is polar
+// angle of view direction measured from Y axis
+static glm::quat cameraRotationFromAngles(const glm::vec3 &angles) {
+    return glm::angleAxis(-angles.x, glm::vec3(0, 1, 0)) * glm::angleAxis(angles.y, glm::vec3(0, 0, 1));
+}
+
 glm::vec2 SceneReader::readVec2(const nlohmann::json &entry) {
     const uint32_t VECTOR2_SIZE = 2;
 
@@ -129,7 +135,7 @@ std::shared_ptr<Camera> SceneReader::readCameraEntry(const nlohmann::json &entry
         throw EngineError("Camera object entry must be an object");
     }
 
-    std::shared_ptr<PositionComponent> position = nullptr;
+    PositionComponent position;
 
     if (entry.contains(OBJECT_ENTRY_COMPONENTS_TAG)) {
         if (!entry[OBJECT_ENTRY_COMPONENTS_TAG].is_object()) {
@@ -138,13 +144,15 @@ std::shared_ptr<Camera> SceneReader::readCameraEntry(const nlohmann::json &entry
         }
 
         if (entry[OBJECT_ENTRY_COMPONENTS_TAG].contains(COMPONENTS_ENTRY_POSITION_TAG)) {
-            position = this->readPositionComponentEntry(
-                    entry[OBJECT_ENTRY_COMPONENTS_TAG][COMPONENTS_ENTRY_POSITION_TAG]);
-        }
-    }
+            const auto &positionEntry = entry[OBJECT_ENTRY_COMPONENTS_TAG][COMPONENTS_ENTRY_POSITION_TAG];
+
+            position = this->readPositionComponentEntry(positionEntry);
 
-    if (position == nullptr) {
-        position = std::make_shared<PositionComponent>();
+            if (positionEntry.contains(POSITION_COMPONENT_ROTATION_TAG)) {
+                auto angles = this->readVec3(positionEntry[POSITION_COMPONENT_ROTATION_TAG]);
+                position.rotation() = cameraRotationFromAngles(angles);
+            }
+        }
     }
 
     std::shared_ptr<Camera> camera = std::make_shared<Camera>(position);
@@ -184,7 +192,7 @@ std::shared_ptr<LightSource> SceneReader::readLightSourceEntry(const nlohmann::j
         throw EngineError("Light source object entry must be an object");
     }
 
-    std::shared_ptr<PositionComponent> position = nullptr;
+    PositionComponent position;
 
     if (entry.contains(OBJECT_ENTRY_COMPONENTS_TAG)) {
         if (!entry[OBJECT_ENTRY_COMPONENTS_TAG].is_object()) {
@@ -198,10 +206,6 @@ std::shared_ptr<LightSource> SceneReader::readLightSourceEntry(const nlohmann::j
         }
     }
 
-    if (position == nullptr) {
-        position = std::make_shared<PositionComponent>();
-    }
-
     std::shared_ptr<LightSource> lightSource = std::make_shared<LightSource>(position);
 
     if (entry.contains(LIGHT_SOURCE_ENTRY_TYPE_TAG)) {
@@ -256,8 +260,8 @@ std::shared_ptr<Prop> SceneReader::readPropEntry(const nlohmann::json &entry) {
         throw EngineError("Prop object entry must be an object");
     }
 
-    std::shared_ptr<PositionComponent> position = nullptr;
-    std::shared_ptr<ModelComponent> model = nullptr;
+    PositionComponent position;
+    ModelComponent model;
 
     if (entry.contains(OBJECT_ENTRY_COMPONENTS_TAG)) {
         if (!entry[OBJECT_ENTRY_COMPONENTS_TAG].is_object()) {
@@ -275,14 +279,6 @@ std::shared_ptr<Prop> SceneReader::readPropEntry(const nlohmann::json &entry) {
         }
     }
 
-    if (position == nullptr) {
-        position = std::make_shared<PositionComponent>();
-    }
-
-    if (model == nullptr) {
-        model = std::make_shared<ModelComponent>();
-    }
-
     return std::make_shared<Prop>(position, model);
 }
 
@@ -291,7 +287,7 @@ std::shared_ptr<World> SceneReader::readWorldEntry(const nlohmann::json &entry)
         throw EngineError("World object entry must be an object");
     }
 
-    std::shared_ptr<SkyboxComponent> skybox = nullptr;
+    SkyboxComponent skybox;
 
     if (entry.contains(OBJECT_ENTRY_COMPONENTS_TAG)) {
         if (!entry[OBJECT_ENTRY_COMPONENTS_TAG].is_object()) {
@@ -304,19 +300,15 @@ std::shared_ptr<World> SceneReader::readWorldEntry(const nlohmann::json &entry)
         }
     }
 
-    if (skybox == nullptr) {
-        skybox = std::make_shared<SkyboxComponent>();
-    }
-
     return std::make_shared<World>(skybox);
 }
 
-std::shared_ptr<ModelComponent> SceneReader::readModelComponentEntry(const nlohmann::json &entry) {
+ModelComponent SceneReader::readModelComponentEntry(const nlohmann::json &entry) {
     if (!entry.is_object()) {
         throw EngineError("Model component entry must be an object");
     }
 
-    std::shared_ptr<ModelComponent> component = std::make_shared<ModelComponent>();
+    ModelComponent component;
 
     if (entry.contains(MODEL_COMPONENT_MESH_TAG)) {
         if (!entry[MODEL_COMPONENT_MESH_TAG].is_string()) {
@@ -324,7 +316,7 @@ std::shared_ptr<ModelComponent> SceneReader::readModelComponentEntry(const nlohm
                                           MODEL_COMPONENT_MESH_TAG));
         }
 
-        component->setMeshId(entry[MODEL_COMPONENT_MESH_TAG]);
+        component.setMeshId(entry[MODEL_COMPONENT_MESH_TAG]);
     }
 
     if (entry.contains(MODEL_COMPONENT_ALBEDO_TEXTURE_TAG)) {
@@ -333,7 +325,7 @@ std::shared_ptr<ModelComponent> SceneReader::readModelComponentEntry(const nlohm
                                           MODEL_COMPONENT_ALBEDO_TEXTURE_TAG));
         }
 
-        component->setAlbedoTextureId(entry[MODEL_COMPONENT_ALBEDO_TEXTURE_TAG]);
+        component.setAlbedoTextureId(entry[MODEL_COMPONENT_ALBEDO_TEXTURE_TAG]);
     }
 
     if (entry.contains(MODEL_COMPONENT_SPECULAR_TEXTURE_TAG)) {
@@ -342,40 +334,40 @@ std::shared_ptr<ModelComponent> SceneReader::readModelComponentEntry(const nlohm
                                           MODEL_COMPONENT_SPECULAR_TEXTURE_TAG));
         }
 
-        component->setSpecularTextureId(entry[MODEL_COMPONENT_SPECULAR_TEXTURE_TAG]);
+        component.setSpecularTextureId(entry[MODEL_COMPONENT_SPECULAR_TEXTURE_TAG]);
     }
 
     return component;
 }
 
-std::shared_ptr<PositionComponent> SceneReader::readPositionComponentEntry(const nlohmann::json &entry) {
+PositionComponent SceneReader::readPositionComponentEntry(const nlohmann::json &entry) {
     if (!entry.is_object()) {
         throw EngineError("Position component entry must be an object");
     }
 
-    std::shared_ptr<PositionComponent> component = std::make_shared<PositionComponent>();
+    PositionComponent component;
 
     if (entry.contains(POSITION_COMPONENT_POSITION_TAG)) {
-        component->position() = this->readVec3(entry[POSITION_COMPONENT_POSITION_TAG]);
+        component.position() = this->readVec3(entry[POSITION_COMPONENT_POSITION_TAG]);
     }
 
     if (entry.contains(POSITION_COMPONENT_ROTATION_TAG)) {
-        component->rotation() = this->readVec3(entry[POSITION_COMPONENT_ROTATION_TAG]);
+        component.setEulerAngles(this->readVec3(entry[POSITION_COMPONENT_ROTATION_TAG]));
     }
 
     if (entry.contains(POSITION_COMPONENT_SCALE_TAG)) {
-        component->scale() = this->readVec3(entry[POSITION_COMPONENT_SCALE_TAG]);
+        component.scale() = this->readVec3(entry[POSITION_COMPONENT_SCALE_TAG]);
     }
 
     return component;
 }
 
-std::shared_ptr<SkyboxComponent> SceneReader::readSkyboxComponentEntry(const nlohmann::json &entry) {
+SkyboxComponent SceneReader::readSkyboxComponentEntry(const nlohmann::json &entry) {
     if (!entry.is_object()) {
         throw EngineError("Skybox component entry must be an object");
     }
 
-    std::shared_ptr<SkyboxComponent> component = std::make_shared<SkyboxComponent>();
+    SkyboxComponent component;
 
     if (entry.contains(SKYBOX_COMPONENT_MESH_TAG)) {
         if (!entry[SKYBOX_COMPONENT_MESH_TAG].is_string()) {
@@ -383,7 +375,7 @@ std::shared_ptr<SkyboxComponent> SceneReader::readSkyboxComponentEntry(const nlo
                                           SKYBOX_COMPONENT_MESH_TAG));
         }
 
-        component->setMeshId(entry[SKYBOX_COMPONENT_MESH_TAG]);
+        component.setMeshId(entry[SKYBOX_COMPONENT_MESH_TAG]);
     }
 
     if (entry.contains(SKYBOX_COMPONENT_TEXTURES_TAG)) {
@@ -406,7 +398,7 @@ std::shared_ptr<SkyboxComponent> SceneReader::readSkyboxComponentEntry(const nlo
             textureIds[idx] = textureEntry;
         }
 
-        component->setTextureIds(textureIds);
+        component.setTextureIds(textureIds);
     }
 
     return component;
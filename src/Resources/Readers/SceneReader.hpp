@@ -34,9 +34,9 @@ private:
     std::shared_ptr<Prop> readPropEntry(const nlohmann::json &entry);
     std::shared_ptr<World> readWorldEntry(const nlohmann::json &entry);
 
-    std::shared_ptr<ModelComponent> readModelComponentEntry(const nlohmann::json &entry);
-    std::shared_ptr<PositionComponent> readPositionComponentEntry(const nlohmann::json &entry);
-    std::shared_ptr<SkyboxComponent> readSkyboxComponentEntry(const nlohmann::json &entry);
+    ModelComponent readModelComponentEntry(const nlohmann::json &entry);
+    PositionComponent readPositionComponentEntry(const nlohmann::json &entry);
+    SkyboxComponent readSkyboxComponentEntry(const nlohmann::json &entry);
 
     std::shared_ptr<SceneNode> readEntry(const nlohmann::json &entry);
     std::shared_ptr<SceneNode> read(const std::weak_ptr<ResourceData> &resourceData);
@@ -0,0 +1,265 @@
+#include "FramePacketBuilder.hpp"
+
+#include "src/Engine/VarCollection.hpp"
+#include "src/Engine/Vars.hpp"
+#include "src/Objects/Camera.hpp"
+#include "src/Objects/LightSource.hpp"
+#include "src/Objects/World.hpp"
+#include "src/Objects/Components/ComponentStorage.hpp"
+#include "src/Objects/Components/ModelComponent.hpp"
+#include "src/Objects/Components/PositionComponent.hpp"
+#include "src/Objects/Components/SkyboxComponent.hpp"
+#include "src/Rendering/GpuManager.hpp"
+#include "src/Rendering/GpuResourceManager.hpp"
+#include "src/Rendering/Types/FramePacket.hpp"
+#include "src/Scene/Scene.hpp"
+#include "src/Scene/SceneManager.hpp"
+#include "src/Scene/SceneNode.hpp"
+#include "src/Scene/TransformSystem.hpp"
+
+std::shared_ptr<Texture> FramePacketBuilder::resolveTexture(const std::optional<ResourceId> &textureId) {
+    auto texture = this->_resourceManager->tryGetTexture(textureId.value_or(this->_defaultTextureId));
+
+    if (texture.has_value() && !texture.value().expired()) {
+        return texture.value().lock();
+    }
+
+    if (textureId.has_value()) {
+        return this->resolveTexture(std::nullopt);
+    }
+
+    return nullptr;
+}
+
+void FramePacketBuilder::addCamera(FramePacket &packet, Camera *camera) {
+    packet.camera = FrameCamera{
+            .position = camera->position()->worldPosition(),
+            .forward = camera->forward(),
+            .view = camera->view(false),
+            .skyboxView = camera->view(true),
+            .near = camera->near(),
+            .far = camera->far(),
+            .fov = camera->fov()
+    };
+}
+
+void FramePacketBuilder::addLightSource(FramePacket &packet, LightSource *lightSource) {
+    // moved flag lasts until next update of transform system, so every move is reported by one packet
+    auto dirty = lightSource->position()->moved();
+
+    if (!lightSource->enabled()) {
+        return;
+    }
+
+    packet.lights.push_back(FrameLight{
+            .objectId = lightSource->id(),
+            .type = lightSource->type(),
+            .position = lightSource->position()->worldPosition(),
+            .forward = lightSource->forward(),
+            .color = lightSource->color(),
+            .range = lightSource->range(),
+            .angle = lightSource->angle(),
+            .rect = lightSource->rect(),
+            .projection = lightSource->projection(),
+            .view = lightSource->view(),
+            .dirty = dirty
+    });
+}
+
+uint32_t FramePacketBuilder::addProps(FramePacket &packet) {
+    auto &models = ComponentStorage<ModelComponent>::instance();
+    auto &positions = ComponentStorage<PositionComponent>::instance();
+    uint32_t foundCount = 0;
+
+    // models are walked in storage order instead of scene tree, storage also holds objects that are not in current
+    // scene, e.g. removed nodes that are not destroyed yet, so they are filtered by scene membership
+    for (std::size_t idx = 0; idx < models.components().size(); idx++) {
+        auto objectId = models.objectIds()[idx];
+        auto &model = models.components()[idx];
+        auto position = positions.tryGet(objectId);
+
+        if (position == nullptr || !this->_transformSystem->isInScene(objectId)) {
+            continue;
+        }
+
+        auto dirty = position->moved() || model.isDirty();
+        model.resetDirty();
+
+        if (!model.meshId().has_value()) {
+            continue;
+        }
+
+        // failed loads are remembered by resource manager, so broken props cost only a lookup
+        auto mesh = this->_resourceManager->tryGetMesh(model.meshId().value());
+        auto albedoTexture = this->resolveTexture(model.albedoTextureId());
+        auto specularTexture = this->resolveTexture(model.specularTextureId());
+
+        if (!mesh.has_value() || mesh.value().expired() || albedoTexture == nullptr || specularTexture == nullptr) {
+            continue;
+        }
+
+        if (this->_objectSlots.size() <= objectId) {
+            this->_objectSlots.resize(objectId + 1, NO_SLOT);
+        }
+
+        auto &slot = this->_objectSlots[objectId];
+
+        if (slot == NO_SLOT) {
+            if (this->_freeSlots.empty()) {
+                slot = static_cast<uint32_t>(this->_instances.size());
+                this->_instances.emplace_back();
+            } else {
+                slot = this->_freeSlots.back();
+                this->_freeSlots.pop_back();
+            }
+
+            this->_instances[slot] = PropInstance{
+                    .objectId = objectId,
+                    .mesh = nullptr,
+                    .albedoTexture = nullptr,
+                    .specularTexture = nullptr,
+                    .packetIdx = packet.idx,
+                    .used = true
+            };
+
+            this->_usedCount++;
+            dirty = true;
+        }
+
+        auto &instance = this->_instances[slot];
+        auto lockedMesh = mesh.value().lock();
+
+        instance.packetIdx = packet.idx;
+        foundCount++;
+
+        // resources are replaced when they are reloaded, or when prop falls back to default texture
+        if (!dirty && instance.mesh == lockedMesh &&
+            instance.albedoTexture == albedoTexture && instance.specularTexture == specularTexture) {
+            continue;
+        }
+
+        instance.mesh = lockedMesh;
+        instance.albedoTexture = albedoTexture;
+        instance.specularTexture = specularTexture;
+
+        packet.draws.push_back(FrameDraw{
+                .slot = slot,
+                .objectId = objectId,
+                .mesh = lockedMesh,
+                .albedoTexture = albedoTexture,
+                .specularTexture = specularTexture,
+                .model = position->model(),
+                .modelRotation = position->rotationMat4()
+        });
+    }
+
+    return foundCount;
+}
+
+void FramePacketBuilder::removeProps(FramePacket &packet, uint32_t foundCount) {
+    // every used slot was found, so there is nothing to remove
+    if (foundCount == this->_usedCount) {
+        return;
+    }
+
+    for (uint32_t slot = 0; slot < this->_instances.size(); slot++) {
+        auto &instance = this->_instances[slot];
+
+        if (!instance.used || instance.packetIdx == packet.idx) {
+            continue;
+        }
+
+        this->_objectSlots[instance.objectId] = NO_SLOT;
+        this->_freeSlots.push_back(slot);
+        this->_usedCount--;
+
+        // resources are released once renderer drops its references as well
+        instance = PropInstance{
+                .objectId = 0,
+                .mesh = nullptr,
+                .albedoTexture = nullptr,
+                .specularTexture = nullptr,
+                .packetIdx = 0,
+                .used = false
+        };
+
+        packet.removedSlots.push_back(slot);
+    }
+}
+
+void FramePacketBuilder::addWorld(FramePacket &packet, World *world) {
+    packet.skybox = FrameSkybox{
+            .meshId = world->skybox()->meshId(),
+            .textureIds = world->skybox()->textureIds()
+    };
+}
+
+FramePacketBuilder::FramePacketBuilder(const std::shared_ptr<VarCollection> &varCollection,
+                                       const std::shared_ptr<GpuManager> &gpuManager,
+                                       const std::shared_ptr<SceneManager> &sceneManager,
+                                       const std::shared_ptr<TransformSystem> &transformSystem)
+        : _varCollection(varCollection),
+          _gpuManager(gpuManager),
+          _sceneManager(sceneManager),
+          _transformSystem(transformSystem) {
+    //
+}
+
+void FramePacketBuilder::init() {
+    this->_resourceManager = this->_gpuManager->getResourceManager().lock();
+    this->_defaultTextureId = this->_varCollection->getStringOrDefault(RESOURCES_DEFAULT_TEXTURE,
+                                                                       "textures/default");
+}
+
+void FramePacketBuilder::destroy() {
+    this->_objectSlots.clear();
+    this->_instances.clear();
+    this->_freeSlots.clear();
+    this->_usedCount = 0;
+
+    this->_resourceManager = nullptr;
+}
+
+std::shared_ptr<FramePacket> FramePacketBuilder::build() {
+    auto packet = std::make_shared<FramePacket>();
+    packet->idx = this->_packetIdx++;
+
+    auto scene = this->_sceneManager->currentScene();
+
+    // props of previous scene are removed by the first packet without them
+    if (scene == nullptr) {
+        this->removeProps(*packet, 0);
+
+        return packet;
+    }
+
+    auto it = scene->iterate();
+
+    do {
+        auto object = it.current()->object();
+
+        if (object == nullptr) {
+            continue;
+        }
+
+        if (auto camera = dynamic_cast<Camera *>(object.get())) {
+            // first camera in scene is used until another one is selected
+            if (this->_sceneManager->currentCamera().expired()) {
+                this->_sceneManager->currentCamera() = std::dynamic_pointer_cast<Camera>(object);
+            }
+        } else if (auto lightSource = dynamic_cast<LightSource *>(object.get())) {
+            this->addLightSource(*packet, lightSource);
+        } else if (auto world = dynamic_cast<World *>(object.get())) {
+            this->addWorld(*packet, world);
+        }
+    } while (it.moveNext());
+
+    auto foundCount = this->addProps(*packet);
+    this->removeProps(*packet, foundCount);
+
+    if (auto camera = this->_sceneManager->currentCamera().lock()) {
+        this->addCamera(*packet, camera.get());
+    }
+
+    return packet;
+}
@@ -0,0 +1,85 @@
+#ifndef SCENE_FRAMEPACKETBUILDER_HPP
+#define SCENE_FRAMEPACKETBUILDER_HPP
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "src/Resources/ResourceId.hpp"
+
+class VarCollection;
+class GpuManager;
+class GpuResourceManager;
+class SceneManager;
+class TransformSystem;
+class Object;
+class Camera;
+class LightSource;
+class World;
+struct FramePacket;
+struct Mesh;
+struct Texture;
+
+// Builds snapshot of scene for render thread. Meshes and textures of props are resolved here, on main thread, so
+// renderer never loads or frees resources itself. Props get stable instance slots, and packets carry only props that
+// were added, moved or changed their resources, along with slots of removed ones.
+class FramePacketBuilder {
+private:
+    static constexpr const uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+    // state of prop as delivered by previous packets
+    struct PropInstance {
+        uint64_t objectId;
+        std::shared_ptr<Mesh> mesh;
+        std::shared_ptr<Texture> albedoTexture;
+        std::shared_ptr<Texture> specularTexture;
+
+        // last packet that found prop in scene, props missing from packet are removed
+        uint64_t packetIdx;
+        bool used;
+    };
+
+    std::shared_ptr<VarCollection> _varCollection;
+    std::shared_ptr<GpuManager> _gpuManager;
+    std::shared_ptr<SceneManager> _sceneManager;
+    std::shared_ptr<TransformSystem> _transformSystem;
+
+    std::shared_ptr<GpuResourceManager> _resourceManager;
+    ResourceId _defaultTextureId;
+
+    uint64_t _packetIdx = 0;
+
+    // slot of every object id, and instance of every slot
+    std::vector<uint32_t> _objectSlots;
+    std::vector<PropInstance> _instances;
+    std::vector<uint32_t> _freeSlots;
+    uint32_t _usedCount = 0;
+
+    // broken or missing textures are replaced with default one
+    std::shared_ptr<Texture> resolveTexture(const std::optional<ResourceId> &textureId);
+
+    void addCamera(FramePacket &packet, Camera *camera);
+    void addLightSource(FramePacket &packet, LightSource *lightSource);
+
+    // returns number of props found in scene
+    uint32_t addProps(FramePacket &packet);
+
+    // releases slots of props that were not found by packet
+    void removeProps(FramePacket &packet, uint32_t foundCount);
+    void addWorld(FramePacket &packet, World *world);
+
+public:
+    FramePacketBuilder(const std::shared_ptr<VarCollection> &varCollection,
+                       const std::shared_ptr<GpuManager> &gpuManager,
+                       const std::shared_ptr<SceneManager> &sceneManager,
+                       const std::shared_ptr<TransformSystem> &transformSystem);
+
+    void init();
+    void destroy();
+
+    [[nodiscard]] std::shared_ptr<FramePacket> build();
+};
+
+#endif // SCENE_FRAMEPACKETBUILDER_HPP
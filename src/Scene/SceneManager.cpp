@@ -11,6 +11,7 @@ SceneManager::SceneManager(const std::shared_ptr<EventQueue> &eventQueue)
 
 void SceneManager::setScene(const std::shared_ptr<Scene> &scene) {
     this->_currentScene = scene;
+    this->_hierarchyVersion++;
     this->_eventQueue->pushEvent(Event{.type = TRANSITION_SCENE_EVENT, .value = scene});
 }
 
@@ -19,6 +20,7 @@ std::shared_ptr<SceneNode> SceneManager::addObject(const std::shared_ptr<Object>
     node->object() = object;
 
     this->_currentScene->root()->insert(node);
+    this->_hierarchyVersion++;
     this->_eventQueue->pushEvent(Event{.type = CREATED_OBJECT_EVENT, .value = object});
 
     return node;
@@ -26,5 +28,6 @@ std::shared_ptr<SceneNode> SceneManager::addObject(const std::shared_ptr<Object>
 
 void SceneManager::removeNode(const std::shared_ptr<SceneNode> &node) {
     this->_currentScene->root()->remove(node);
+    this->_hierarchyVersion++;
     this->_eventQueue->pushEvent(Event{.type = DESTROYED_OBJECT_EVENT, .value = node->object()});
 }
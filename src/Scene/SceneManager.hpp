@@ -1,6 +1,7 @@
 #ifndef SCENE_SCENEMANAGER_HPP
 #define SCENE_SCENEMANAGER_HPP
 
+#include <cstdint>
 #include <memory>
 
 class EventQueue;
@@ -16,6 +17,9 @@ private:
     std::shared_ptr<Scene> _currentScene = nullptr;
     std::weak_ptr<Camera> _currentCamera;
 
+    // changes whenever objects are added to or removed from scene tree
+    uint64_t _hierarchyVersion = 0;
+
 public:
     SceneManager(const std::shared_ptr<EventQueue> &eventQueue);
 
@@ -26,6 +30,7 @@ public:
 
     [[nodiscard]] std::shared_ptr<Scene> currentScene() { return this->_currentScene; }
     [[nodiscard]] std::weak_ptr<Camera> &currentCamera() { return this->_currentCamera; }
+    [[nodiscard]] uint64_t hierarchyVersion() const { return this->_hierarchyVersion; }
 };
 
 #endif // SCENE_SCENEMANAGER_HPP
@@ -0,0 +1,310 @@
+#include "TransformKernel.hpp"
+
+#include <algorithm>
+
+#include <glm/gtc/type_ptr.hpp>
+
+// SSE2 is part of x86-64, wider instruction sets are enabled per function and chosen at runtime
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TRANSFORM_KERNEL_X86
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+
+#include <immintrin.h>
+#endif
+
+void TransformArrays::resize(size_t count) {
+    for (auto array: {&this->positionX, &this->positionY, &this->positionZ,
+                      &this->rotationX, &this->rotationY, &this->rotationZ, &this->rotationW,
+                      &this->scaleX, &this->scaleY, &this->scaleZ}) {
+        array->resize(count);
+    }
+}
+
+void TransformArrays::set(size_t idx, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale) {
+    this->positionX[idx] = position.x;
+    this->positionY[idx] = position.y;
+    this->positionZ[idx] = position.z;
+    this->rotationX[idx] = rotation.x;
+    this->rotationY[idx] = rotation.y;
+    this->rotationZ[idx] = rotation.z;
+    this->rotationW[idx] = rotation.w;
+    this->scaleX[idx] = scale.x;
+    this->scaleY[idx] = scale.y;
+    this->scaleZ[idx] = scale.z;
+}
+
+static void composeScalar(const TransformArrays &transforms, glm::mat4 *models, size_t begin, size_t count) {
+    for (size_t idx = begin; idx < count; idx++) {
+        auto x = transforms.rotationX[idx];
+        auto y = transforms.rotationY[idx];
+        auto z = transforms.rotationZ[idx];
+        auto w = transforms.rotationW[idx];
+        auto sx = transforms.scaleX[idx];
+        auto sy = transforms.scaleY[idx];
+        auto sz = transforms.scaleZ[idx];
+
+        auto &model = models[idx];
+        model[0] = glm::vec4((1 - 2 * (y * y + z * z)) * sx, 2 * (x * y + w * z) * sx, 2 * (x * z - w * y) * sx, 0);
+        model[1] = glm::vec4(2 * (x * y - w * z) * sy, (1 - 2 * (x * x + z * z)) * sy, 2 * (y * z + w * x) * sy, 0);
+        model[2] = glm::vec4(2 * (x * z + w * y) * sz, 2 * (y * z - w * x) * sz, (1 - 2 * (x * x + y * y)) * sz, 0);
+        model[3] = glm::vec4(transforms.positionX[idx], transforms.positionY[idx], transforms.positionZ[idx], 1);
+    }
+}
+
+static void multiplyScalar(const glm::mat4 *lhs, const glm::mat4 *rhs, glm::mat4 *result, size_t count) {
+    for (size_t idx = 0; idx < count; idx++) {
+        result[idx] = lhs[idx] * rhs[idx];
+    }
+}
+
+#ifdef TRANSFORM_KERNEL_X86
+
+// column of result is sum of lhs columns weighted by elements of rhs column
+static inline __m128 combineColumnsSse(const __m128 (&lhs)[4], __m128 column) {
+    auto result = _mm_mul_ps(lhs[0], _mm_shuffle_ps(column, column, 0x00));
+    result = _mm_add_ps(result, _mm_mul_ps(lhs[1], _mm_shuffle_ps(column, column, 0x55)));
+    result = _mm_add_ps(result, _mm_mul_ps(lhs[2], _mm_shuffle_ps(column, column, 0xAA)));
+    result = _mm_add_ps(result, _mm_mul_ps(lhs[3], _mm_shuffle_ps(column, column, 0xFF)));
+
+    return result;
+}
+
+static inline void multiplyMatrixSse(const __m128 (&lhs)[4], const float *rhs, float *result) {
+    __m128 columns[4];
+
+    // every column is loaded before anything is stored, so result may alias operands
+    for (int idx = 0; idx < 4; idx++) {
+        columns[idx] = combineColumnsSse(lhs, _mm_loadu_ps(rhs + 4 * idx));
+    }
+
+    for (int idx = 0; idx < 4; idx++) {
+        _mm_storeu_ps(result + 4 * idx, columns[idx]);
+    }
+}
+
+// lanes of a, b, c and d hold rows of column of four matrices, stored after transposition
+static inline void storeColumnSse(glm::mat4 *models, int column, __m128 a, __m128 b, __m128 c, __m128 d) {
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+
+    _mm_storeu_ps(glm::value_ptr(models[0][column]), a);
+    _mm_storeu_ps(glm::value_ptr(models[1][column]), b);
+    _mm_storeu_ps(glm::value_ptr(models[2][column]), c);
+    _mm_storeu_ps(glm::value_ptr(models[3][column]), d);
+}
+
+static void composeSse(const TransformArrays &transforms, glm::mat4 *models, size_t count) {
+    const auto one = _mm_set1_ps(1);
+    const auto two = _mm_set1_ps(2);
+    const auto half = _mm_set1_ps(0.5f);
+    const auto zero = _mm_setzero_ps();
+
+    size_t idx = 0;
+
+    for (; idx + 4 <= count; idx += 4) {
+        auto x = _mm_loadu_ps(&transforms.rotationX[idx]);
+        auto y = _mm_loadu_ps(&transforms.rotationY[idx]);
+        auto z = _mm_loadu_ps(&transforms.rotationZ[idx]);
+        auto w = _mm_loadu_ps(&transforms.rotationW[idx]);
+
+        // doubled scale folds factor of two into single multiplication
+        auto sx = _mm_mul_ps(_mm_loadu_ps(&transforms.scaleX[idx]), two);
+        auto sy = _mm_mul_ps(_mm_loadu_ps(&transforms.scaleY[idx]), two);
+        auto sz = _mm_mul_ps(_mm_loadu_ps(&transforms.scaleZ[idx]), two);
+
+        auto xx = _mm_mul_ps(x, x);
+        auto yy = _mm_mul_ps(y, y);
+        auto zz = _mm_mul_ps(z, z);
+        auto xy = _mm_mul_ps(x, y);
+        auto xz = _mm_mul_ps(x, z);
+        auto yz = _mm_mul_ps(y, z);
+        auto wx = _mm_mul_ps(w, x);
+        auto wy = _mm_mul_ps(w, y);
+        auto wz = _mm_mul_ps(w, z);
+
+        storeColumnSse(models + idx, 0,
+                       _mm_mul_ps(_mm_sub_ps(half, _mm_add_ps(yy, zz)), sx),
+                       _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+                       _mm_mul_ps(_mm_sub_ps(xz, wy), sx),
+                       zero);
+        storeColumnSse(models + idx, 1,
+                       _mm_mul_ps(_mm_sub_ps(xy, wz), sy),
+                       _mm_mul_ps(_mm_sub_ps(half, _mm_add_ps(xx, zz)), sy),
+                       _mm_mul_ps(_mm_add_ps(yz, wx), sy),
+                       zero);
+        storeColumnSse(models + idx, 2,
+                       _mm_mul_ps(_mm_add_ps(xz, wy), sz),
+                       _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+                       _mm_mul_ps(_mm_sub_ps(half, _mm_add_ps(xx, yy)), sz),
+                       zero);
+        storeColumnSse(models + idx, 3,
+                       _mm_loadu_ps(&transforms.positionX[idx]),
+                       _mm_loadu_ps(&transforms.positionY[idx]),
+                       _mm_loadu_ps(&transforms.positionZ[idx]),
+                       one);
+    }
+
+    composeScalar(transforms, models, idx, count);
+}
+
+static void multiplySse(const glm::mat4 *lhs, const glm::mat4 *rhs, glm::mat4 *result, size_t count) {
+    for (size_t idx = 0; idx < count; idx++) {
+        auto lhsPtr = glm::value_ptr(lhs[idx]);
+        __m128 lhsColumns[4] = {
+                _mm_loadu_ps(lhsPtr), _mm_loadu_ps(lhsPtr + 4), _mm_loadu_ps(lhsPtr + 8), _mm_loadu_ps(lhsPtr + 12)
+        };
+
+        multiplyMatrixSse(lhsColumns, glm::value_ptr(rhs[idx]), glm::value_ptr(result[idx]));
+    }
+}
+
+// lhs columns are duplicated into both halves, so two columns of result are computed at once
+TARGET_AVX2 static inline void multiplyMatrixAvx2(const __m256 (&lhs)[4], const float *rhs, float *result) {
+    auto rhs01 = _mm256_loadu_ps(rhs);
+    auto rhs23 = _mm256_loadu_ps(rhs + 8);
+
+    auto result01 = _mm256_mul_ps(lhs[0], _mm256_permute_ps(rhs01, 0x00));
+    result01 = _mm256_fmadd_ps(lhs[1], _mm256_permute_ps(rhs01, 0x55), result01);
+    result01 = _mm256_fmadd_ps(lhs[2], _mm256_permute_ps(rhs01, 0xAA), result01);
+    result01 = _mm256_fmadd_ps(lhs[3], _mm256_permute_ps(rhs01, 0xFF), result01);
+
+    auto result23 = _mm256_mul_ps(lhs[0], _mm256_permute_ps(rhs23, 0x00));
+    result23 = _mm256_fmadd_ps(lhs[1], _mm256_permute_ps(rhs23, 0x55), result23);
+    result23 = _mm256_fmadd_ps(lhs[2], _mm256_permute_ps(rhs23, 0xAA), result23);
+    result23 = _mm256_fmadd_ps(lhs[3], _mm256_permute_ps(rhs23, 0xFF), result23);
+
+    _mm256_storeu_ps(result, result01);
+    _mm256_storeu_ps(result + 8, result23);
+}
+
+TARGET_AVX2 static inline void loadDuplicatedColumnsAvx2(const float *matrix, __m256 (&columns)[4]) {
+    for (int idx = 0; idx < 4; idx++) {
+        columns[idx] = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix + 4 * idx));
+    }
+}
+
+// lanes of a, b, c and d hold rows of column of eight matrices, every half is transposed separately
+TARGET_AVX2 static inline void storeColumnAvx2(glm::mat4 *models, int column, __m256 a, __m256 b, __m256 c, __m256 d) {
+    auto ab0 = _mm256_unpacklo_ps(a, b);
+    auto ab1 = _mm256_unpackhi_ps(a, b);
+    auto cd0 = _mm256_unpacklo_ps(c, d);
+    auto cd1 = _mm256_unpackhi_ps(c, d);
+
+    __m256 rows[4] = {
+            _mm256_shuffle_ps(ab0, cd0, 0x44),
+            _mm256_shuffle_ps(ab0, cd0, 0xEE),
+            _mm256_shuffle_ps(ab1, cd1, 0x44),
+            _mm256_shuffle_ps(ab1, cd1, 0xEE)
+    };
+
+    for (int idx = 0; idx < 4; idx++) {
+        _mm_storeu_ps(glm::value_ptr(models[idx][column]), _mm256_castps256_ps128(rows[idx]));
+        _mm_storeu_ps(glm::value_ptr(models[idx + 4][column]), _mm256_extractf128_ps(rows[idx], 1));
+    }
+}
+
+TARGET_AVX2 static void composeAvx2(const TransformArrays &transforms, glm::mat4 *models, size_t count) {
+    const auto one = _mm256_set1_ps(1);
+    const auto two = _mm256_set1_ps(2);
+    const auto half = _mm256_set1_ps(0.5f);
+    const auto zero = _mm256_setzero_ps();
+
+    size_t idx = 0;
+
+    for (; idx + 8 <= count; idx += 8) {
+        auto x = _mm256_loadu_ps(&transforms.rotationX[idx]);
+        auto y = _mm256_loadu_ps(&transforms.rotationY[idx]);
+        auto z = _mm256_loadu_ps(&transforms.rotationZ[idx]);
+        auto w = _mm256_loadu_ps(&transforms.rotationW[idx]);
+
+        // doubled scale folds factor of two into single multiplication
+        auto sx = _mm256_mul_ps(_mm256_loadu_ps(&transforms.scaleX[idx]), two);
+        auto sy = _mm256_mul_ps(_mm256_loadu_ps(&transforms.scaleY[idx]), two);
+        auto sz = _mm256_mul_ps(_mm256_loadu_ps(&transforms.scaleZ[idx]), two);
+
+        auto xx = _mm256_mul_ps(x, x);
+        auto yy = _mm256_mul_ps(y, y);
+        auto zz = _mm256_mul_ps(z, z);
+        auto xy = _mm256_mul_ps(x, y);
+        auto xz = _mm256_mul_ps(x, z);
+        auto yz = _mm256_mul_ps(y, z);
+
+        storeColumnAvx2(models + idx, 0,
+                        _mm256_mul_ps(_mm256_sub_ps(half, _mm256_add_ps(yy, zz)), sx),
+                        _mm256_mul_ps(_mm256_fmadd_ps(w, z, xy), sx),
+                        _mm256_mul_ps(_mm256_fnmadd_ps(w, y, xz), sx),
+                        zero);
+        storeColumnAvx2(models + idx, 1,
+                        _mm256_mul_ps(_mm256_fnmadd_ps(w, z, xy), sy),
+                        _mm256_mul_ps(_mm256_sub_ps(half, _mm256_add_ps(xx, zz)), sy),
+                        _mm256_mul_ps(_mm256_fmadd_ps(w, x, yz), sy),
+                        zero);
+        storeColumnAvx2(models + idx, 2,
+                        _mm256_mul_ps(_mm256_fmadd_ps(w, y, xz), sz),
+                        _mm256_mul_ps(_mm256_fnmadd_ps(w, x, yz), sz),
+                        _mm256_mul_ps(_mm256_sub_ps(half, _mm256_add_ps(xx, yy)), sz),
+                        zero);
+        storeColumnAvx2(models + idx, 3,
+                        _mm256_loadu_ps(&transforms.positionX[idx]),
+                        _mm256_loadu_ps(&transforms.positionY[idx]),
+                        _mm256_loadu_ps(&transforms.positionZ[idx]),
+                        one);
+    }
+
+    composeScalar(transforms, models, idx, count);
+}
+
+TARGET_AVX2 static void multiplyAvx2(const glm::mat4 *lhs, const glm::mat4 *rhs, glm::mat4 *result, size_t count) {
+    __m256 lhsColumns[4];
+
+    for (size_t idx = 0; idx < count; idx++) {
+        loadDuplicatedColumnsAvx2(glm::value_ptr(lhs[idx]), lhsColumns);
+        multiplyMatrixAvx2(lhsColumns, glm::value_ptr(rhs[idx]), glm::value_ptr(result[idx]));
+    }
+}
+
+#endif // TRANSFORM_KERNEL_X86
+
+static void composeFallback(const TransformArrays &transforms, glm::mat4 *models, size_t count) {
+    composeScalar(transforms, models, 0, count);
+}
+
+TransformKernel::TransformKernel()
+        : TransformKernel(detectIsa()) {
+    //
+}
+
+TransformKernel::TransformKernel(TransformKernelIsa isa)
+        : _isa(std::min(isa, detectIsa())),
+          _compose(composeFallback),
+          _multiply(multiplyScalar) {
+#ifdef TRANSFORM_KERNEL_X86
+    switch (this->_isa) {
+        case TransformKernelIsa::Scalar:
+            break;
+
+        case TransformKernelIsa::Sse:
+            this->_compose = composeSse;
+            this->_multiply = multiplySse;
+            break;
+
+        case TransformKernelIsa::Avx2:
+            this->_compose = composeAvx2;
+            this->_multiply = multiplyAvx2;
+            break;
+    }
+#endif
+}
+
+TransformKernelIsa TransformKernel::detectIsa() {
+#ifdef TRANSFORM_KERNEL_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return TransformKernelIsa::Avx2;
+    }
+
+    return TransformKernelIsa::Sse;
+#else
+    return TransformKernelIsa::Scalar;
+#endif
+}
@@ -0,0 +1,78 @@
+#ifndef SCENE_TRANSFORMKERNEL_HPP
+#define SCENE_TRANSFORMKERNEL_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+enum class TransformKernelIsa {
+    Scalar,
+    Sse,
+    Avx2
+};
+
+constexpr std::string_view toString(const TransformKernelIsa &isa) {
+    switch (isa) {
+        case TransformKernelIsa::Scalar:
+            return "Scalar";
+
+        case TransformKernelIsa::Sse:
+            return "SSE";
+
+        case TransformKernelIsa::Avx2:
+            return "AVX2";
+    }
+
+    return "Unknown";
+}
+
+// Local transforms in structure of arrays layout, every array holds single component of all transforms, so kernel
+// loads the same component of several transforms into one register.
+struct TransformArrays {
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+    std::vector<float> scaleX, scaleY, scaleZ;
+
+    [[nodiscard]] size_t size() const { return this->positionX.size(); }
+
+    void resize(size_t count);
+    void set(size_t idx, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale);
+};
+
+// Batch transform math, implemented with the widest instruction set supported by CPU. Matrices are regular column
+// major glm matrices, results equal to glm ones up to rounding.
+class TransformKernel {
+private:
+    using ComposeFn = void (*)(const TransformArrays &transforms, glm::mat4 *models, size_t count);
+    using MultiplyFn = void (*)(const glm::mat4 *lhs, const glm::mat4 *rhs, glm::mat4 *result, size_t count);
+
+    TransformKernelIsa _isa;
+    ComposeFn _compose;
+    MultiplyFn _multiply;
+
+public:
+    TransformKernel();
+
+    // falls back to supported instruction set if requested one is not available
+    explicit TransformKernel(TransformKernelIsa isa);
+
+    [[nodiscard]] static TransformKernelIsa detectIsa();
+
+    [[nodiscard]] TransformKernelIsa isa() const { return this->_isa; }
+
+    // models[i] = translate(position) * rotation * scale(scale)
+    void compose(const TransformArrays &transforms, glm::mat4 *models, size_t count) const {
+        this->_compose(transforms, models, count);
+    }
+
+    // result[i] = lhs[i] * rhs[i], result may alias either operand
+    void multiply(const glm::mat4 *lhs, const glm::mat4 *rhs, glm::mat4 *result, size_t count) const {
+        this->_multiply(lhs, rhs, result, count);
+    }
+};
+
+#endif // SCENE_TRANSFORMKERNEL_HPP
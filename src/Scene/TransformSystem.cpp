@@ -0,0 +1,131 @@
+#include "TransformSystem.hpp"
+
+#include <algorithm>
+
+#include "src/Objects/Object.hpp"
+#include "src/Objects/Components/ComponentStorage.hpp"
+#include "src/Objects/Components/PositionComponent.hpp"
+#include "src/Scene/Scene.hpp"
+#include "src/Scene/SceneManager.hpp"
+#include "src/Scene/SceneNode.hpp"
+
+void TransformSystem::flatten(const std::shared_ptr<SceneNode> &node, uint32_t parentIdx) {
+    auto &positions = ComponentStorage<PositionComponent>::instance();
+    auto nodeIdx = parentIdx;
+
+    // nodes without position do not transform their descendants
+    if (node->object() != nullptr && positions.tryGet(node->object()->id()) != nullptr) {
+        nodeIdx = static_cast<uint32_t>(this->_nodes.size());
+
+        if (node->object()->id() >= this->_sceneMembers.size()) {
+            this->_sceneMembers.resize(node->object()->id() + 1, false);
+        }
+
+        this->_sceneMembers[node->object()->id()] = true;
+
+        this->_nodes.push_back(TransformNode{
+                .objectId = node->object()->id(),
+                .parentIdx = parentIdx,
+                .subtreeEnd = 0
+        });
+    }
+
+    for (const auto &descendant: node->descendants()) {
+        this->flatten(descendant, nodeIdx);
+    }
+
+    if (nodeIdx != parentIdx) {
+        this->_nodes[nodeIdx].subtreeEnd = static_cast<uint32_t>(this->_nodes.size());
+    }
+}
+
+void TransformSystem::updateNodes() {
+    auto &positions = ComponentStorage<PositionComponent>::instance();
+    auto count = this->_dirtyNodes.size();
+
+    this->_locals.resize(count);
+    this->_localModels.resize(count);
+
+    for (size_t idx = 0; idx < count; idx++) {
+        auto position = positions.tryGet(this->_nodes[this->_dirtyNodes[idx]].objectId);
+        this->_locals.set(idx, position->position(), position->rotation(), position->scale());
+    }
+
+    this->_kernel.compose(this->_locals, this->_localModels.data(), count);
+
+    // parents precede their children, so world transform of parent is already up to date
+    for (size_t idx = 0; idx < count; idx++) {
+        const auto &node = this->_nodes[this->_dirtyNodes[idx]];
+        auto position = positions.tryGet(node.objectId);
+
+        if (node.parentIdx == NO_PARENT) {
+            position->setWorld(this->_localModels[idx], position->rotation());
+        } else {
+            auto parent = positions.tryGet(this->_nodes[node.parentIdx].objectId);
+
+            this->_kernel.multiply(&parent->model(), &this->_localModels[idx], &this->_localModels[idx], 1);
+            position->setWorld(this->_localModels[idx], parent->worldRotation() * position->rotation());
+        }
+
+        position->resetDirty();
+        this->_movedObjects.push_back(node.objectId);
+    }
+}
+
+TransformSystem::TransformSystem(const std::shared_ptr<SceneManager> &sceneManager)
+        : _sceneManager(sceneManager) {
+    //
+}
+
+void TransformSystem::update() {
+    auto &positions = ComponentStorage<PositionComponent>::instance();
+
+    // moves are reported only by packet built right after update that made them
+    for (auto objectId: this->_movedObjects) {
+        if (auto position = positions.tryGet(objectId)) {
+            position->resetMoved();
+        }
+    }
+
+    this->_movedObjects.clear();
+
+    auto scene = this->_sceneManager->currentScene();
+
+    if (scene == nullptr) {
+        this->_nodes.clear();
+        this->_sceneMembers.clear();
+        this->_valid = false;
+
+        return;
+    }
+
+    // every transform is recomputed after scene tree changes
+    auto rebuild = !this->_valid || this->_hierarchyVersion != this->_sceneManager->hierarchyVersion();
+
+    if (rebuild) {
+        this->_nodes.clear();
+        std::fill(this->_sceneMembers.begin(), this->_sceneMembers.end(), false);
+        this->flatten(scene->root(), NO_PARENT);
+
+        this->_hierarchyVersion = this->_sceneManager->hierarchyVersion();
+        this->_valid = true;
+    }
+
+    uint32_t nodeIdx = 0;
+
+    this->_dirtyNodes.clear();
+
+    while (nodeIdx < this->_nodes.size()) {
+        if (rebuild || positions.tryGet(this->_nodes[nodeIdx].objectId)->isDirty()) {
+            for (auto idx = nodeIdx; idx < this->_nodes[nodeIdx].subtreeEnd; idx++) {
+                this->_dirtyNodes.push_back(idx);
+            }
+
+            nodeIdx = this->_nodes[nodeIdx].subtreeEnd;
+        } else {
+            nodeIdx++;
+        }
+    }
+
+    this->updateNodes();
+}
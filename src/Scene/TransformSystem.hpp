@@ -0,0 +1,66 @@
+#ifndef SCENE_TRANSFORMSYSTEM_HPP
+#define SCENE_TRANSFORMSYSTEM_HPP
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "src/Scene/TransformKernel.hpp"
+
+class SceneManager;
+class SceneNode;
+
+// Keeps world transforms of position components in sync with scene tree. Tree is flattened into array where parents
+// precede their children and every subtree is contiguous, so dirty subtrees are recomputed by linear pass and clean
+// ones are skipped as a whole. Local matrices of all dirty nodes are composed in single batch by vectorized kernel.
+// System owns transform dirty state: flags are reset once world transform is recomputed, and every updated object,
+// including descendants of moved ones, is flagged as moved until next update, so each move is reported once.
+class TransformSystem {
+private:
+    static constexpr const uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+    struct TransformNode {
+        uint64_t objectId;
+
+        // index of the nearest ancestor with position
+        uint32_t parentIdx;
+
+        // index past the last node of subtree
+        uint32_t subtreeEnd;
+    };
+
+    std::shared_ptr<SceneManager> _sceneManager;
+
+    std::vector<TransformNode> _nodes;
+
+    // indexed by object id, set for objects with position that are in current scene tree
+    std::vector<bool> _sceneMembers;
+    uint64_t _hierarchyVersion = 0;
+    bool _valid = false;
+
+    TransformKernel _kernel;
+
+    // objects flagged as moved by previous update
+    std::vector<uint64_t> _movedObjects;
+
+    // scratch of current update, kept to avoid allocations
+    std::vector<uint32_t> _dirtyNodes;
+    TransformArrays _locals;
+    std::vector<glm::mat4> _localModels;
+
+    void flatten(const std::shared_ptr<SceneNode> &node, uint32_t parentIdx);
+    void updateNodes();
+
+public:
+    explicit TransformSystem(const std::shared_ptr<SceneManager> &sceneManager);
+
+    void update();
+
+    // as of last update, objects without position are never reported as members
+    [[nodiscard]] bool isInScene(uint64_t objectId) const {
+        return objectId < this->_sceneMembers.size() && this->_sceneMembers[objectId];
+    }
+};
+
+#endif // SCENE_TRANSFORMSYSTEM_HPP